@@ -681,7 +681,14 @@ extern LIBMDBX_VERINFO_API const struct MDBX_version_info {
 
 /** \brief libmdbx build information
  * \attention Some strings could be NULL in case no corresponding information
- *            was provided at build time (i.e. flags). */
+ *            was provided at build time (i.e. flags).
+ *
+ * \warning A database written by libmdbx built with the
+ * `MDBX_ENABLE_GC_EXTENTS=1` option may contain the extent-encoded GC records,
+ * which are treated as corrupted by libmdbx versions released before this
+ * option was introduced. Such database should not be used by older versions,
+ * unless it is copied with compactification, i.e. by \ref mdbx_env_copy()
+ * with \ref MDBX_CP_COMPACT, which leaves the GC empty. */
 extern LIBMDBX_VERINFO_API const struct MDBX_build_info {
   const char *datetime; /**< build timestamp (ISO-8601 or __DATE__ __TIME__) */
   const char *target;   /**< cpu/arch-system-config triplet */
@@ -760,6 +767,18 @@ typedef struct MDBX_txn MDBX_txn;
 struct MDBX_txn;
 #endif
 
+/** \brief Opaque structure for a shared read-only snapshot of a database.
+ * \ingroup c_transactions
+ * \details A snapshot pins a single MVCC-version by a single reader slot,
+ * while any number of threads could read it by the lightweight read-only
+ * transactions created by \ref mdbx_txn_begin_snapshot().
+ * \see mdbx_snapshot_acquire() \see mdbx_snapshot_release() */
+#ifndef __cplusplus
+typedef struct MDBX_snapshot MDBX_snapshot;
+#else
+struct MDBX_snapshot;
+#endif
+
 /** \brief A handle for an individual database (key-value spaces) in the
  * environment.
  * \ingroup c_dbi
@@ -2051,6 +2070,34 @@ LIBMDBX_API const char *mdbx_strerror_r_ANSI2OEM(int errnum, char *buf,
  * \returns a non-zero error value on failure and 0 on success. */
 LIBMDBX_API int mdbx_env_create(MDBX_env **penv);
 
+/** \brief Policies of choosing the dirty pages to be spilled.
+ * \ingroup c_settings
+ * \see MDBX_opt_spill_policy */
+enum MDBX_spill_policy_t {
+  /** \brief Spill the least recently dirtied pages, with preference for
+   * large/overflow pages. This is the historical behaviour. */
+  MDBX_SPILL_LRU = 0,
+
+  /** \brief In addition to \ref MDBX_SPILL_LRU take into account the reuse
+   * of pages, in the manner of CLOCK-Pro/ARC caches.
+   *
+   * \details Pages which were touched repeatedly since the previous spilling
+   * (including the branch pages, since they are touched by almost every
+   * update) or were reloaded after spilling are considered as "hot" and will
+   * be spilled only after the colder ones of the same age. The hot pages are
+   * limited to a half of the dirty pages, so the rarely touched ones are
+   * cooled down gradually.
+   * Thus a stream of once-touched pages, e.g. while appending or filling
+   * a table, doesn't push out the working set of a huge transaction, which
+   * otherwise is spilled and reloaded over and over again.
+   * This is the default policy. */
+  MDBX_SPILL_ADAPTIVE = 1
+};
+#ifndef __cplusplus
+/** \ingroup c_settings */
+typedef enum MDBX_spill_policy_t MDBX_spill_policy_t;
+#endif
+
 /** \brief MDBX environment options. */
 enum MDBX_option_t {
   /** \brief Controls the maximum number of named databases for the environment.
@@ -2076,7 +2123,8 @@ enum MDBX_option_t {
    * \ref mdbx_env_open(), and has an effect only when the database is opened by
    * the first process interacts with the database.
    *
-   * \see mdbx_env_set_maxreaders() \see mdbx_env_get_maxreaders() */
+   * \see mdbx_env_set_maxreaders() \see mdbx_env_get_maxreaders()
+   * \see MDBX_opt_readers_growth_limit */
   MDBX_opt_max_readers,
 
   /** \brief Controls interprocess/shared threshold to force flush the data
@@ -2134,7 +2182,17 @@ enum MDBX_option_t {
    * reserve for reuse in the next transaction(s).
    *
    * The `MDBX_opt_dp_reserve_limit` allows you to set a limit for such reserve
-   * inside the current process. Default is 1024. */
+   * inside the current process. Default is 1024.
+   *
+   * When libmdbx is built with the `MDBX_ENABLE_DPARENA=1` option (default)
+   * the dirty pages are carved out of large memory mappings (chunks), which
+   * are rewound all at once at the end of a write transaction. In this case
+   * the limit is still given in pages, but it is converted to bytes and
+   * rounded up to the whole chunks of 2 MiB (or of 64 database pages, if
+   * ones are larger), so at least one chunk is always kept mapped for the
+   * next transaction(s). The pages allocated by `malloc()`, i.e. the
+   * multi-page blocks larger than a quarter of the chunk, are not retained
+   * in such case. */
   MDBX_opt_dp_reserve_limit,
 
   /** \brief Controls the in-process limit of dirty pages
@@ -2220,6 +2278,114 @@ enum MDBX_option_t {
    * to 50% (half empty) which corresponds to the range from 8192 and to 32768
    * in units respectively. */
   MDBX_opt_merge_threshold_16dot16_percent,
+
+  /** \brief Controls the in-process limit of pages to be reclaimed from tables
+   * dropped by \ref mdbx_drop_deferred() during each write transaction commit.
+   *
+   * \details Tables dropped by \ref mdbx_drop_deferred() are detached
+   * immediately, but their pages are reclaimed gradually by the following
+   * write transactions. Before the commit of each non-empty write transaction
+   * up to `MDBX_opt_drop_reclaim_budget` pages of such tables are released,
+   * so that the write lock is never held for too long.
+   *
+   * Zero value means no automatic reclaiming will be performed, so the
+   * \ref mdbx_drop_reclaim() should be called explicitly.
+   * Default is 1024 pages. */
+  MDBX_opt_drop_reclaim_budget,
+
+  /** \brief Controls the in-process profiling of GC search and updates.
+   *
+   * \details Non-zero value enables gathering of the detailed GC profiling
+   * statistics, which is returned by \ref mdbx_txn_commit_ex() inside
+   * \ref MDBX_commit_latency::gc_prof. This allows to diagnose slow commits
+   * on live systems, but costs a few extra clock readings on each GC lookup.
+   * Zero value (default) disables the profiling, while the overhead is just
+   * a few well-predicted branches.
+   *
+   * \returns \ref MDBX_ENOSYS on attempt to enable profiling if libmdbx was
+   * built with \ref MDBX_ENABLE_PROFGC=0. */
+  MDBX_opt_gc_profiling,
+
+  /** \brief Controls the in-process policy of choosing the dirty pages to be
+   * spilled when a write transaction reaches the \ref MDBX_opt_txn_dp_limit.
+   *
+   * \details The value should be one of \ref MDBX_spill_policy_t.
+   * Default is \ref MDBX_SPILL_ADAPTIVE. The amounts of spilled and reloaded
+   * pages are provided for each transaction inside \ref MDBX_commit_info
+   * by \ref mdbx_txn_commit_info(). */
+  MDBX_opt_spill_policy,
+
+  /** \brief Controls the in-process recording of the change feed, i.e. the
+   * number of the recent write transactions whose changes are retained.
+   *
+   * \details Non-zero value enables recording of the tables (and optionally
+   * the ranges of keys, see \ref MDBX_opt_changefeed_ranges) modified by each
+   * committed write transaction. The records are stored within the database
+   * in a hidden table, which requires one more handle of named tables (see
+   * \ref mdbx_env_set_maxdbs()), and are available to readers of any process
+   * by \ref mdbx_changes_enum(). The records older than the given number of
+   * transactions are deleted by the following commits.
+   *
+   * The hidden table is opened (and created if necessary) by an internal
+   * write transaction once the recording is enabled, or by
+   * \ref mdbx_env_open() if the option was set before.
+   *
+   * All processes which write to the database should enable the recording,
+   * otherwise the feed will have gaps, which are reported to consumers.
+   * Zero value (default) disables the recording. */
+  MDBX_opt_changefeed_limit,
+
+  /** \brief Controls the in-process recording of the ranges of modified keys
+   * within the change feed.
+   *
+   * \details Non-zero value enables tracking of the lowest and the highest
+   * key modified by a write transaction in each table, at the cost of a copy
+   * and a couple of comparisons of the key on each update. Otherwise the whole
+   * tables are reported as changed. Has effect only while
+   * \ref MDBX_opt_changefeed_limit is non-zero. Default is zero. */
+  MDBX_opt_changefeed_ranges,
+
+  /** \brief Controls the in-process fairness of waiting for the write lock.
+   *
+   * \details Non-zero value makes the write transactions started by this
+   * process to take tickets and acquire the write lock in the FIFO order,
+   * instead of the arbitrary order provided by the system, which under
+   * contention could starve some writers for seconds. The fairness covers
+   * only processes which enable it, while other ones compete as usual.
+   * Default is zero.
+   *
+   * \returns \ref MDBX_ENOSYS on attempt to enable fairness on Windows.
+   * \see mdbx_txn_begin_timed() */
+  MDBX_opt_writer_fairness,
+
+  /** \brief Controls the in-process watcher of dead readers.
+   *
+   * \details Non-zero value starts an auxiliary thread, which clears the
+   * reader slots of crashed processes as soon as ones exit, instead of
+   * waiting for the next \ref mdbx_reader_check() call. Thus the reclaiming
+   * of GC isn't blocked by snapshots of dead readers. The exits are tracked
+   * by pidfd(s), while the value defines the period of rescanning the readers
+   * table for new processes, in 1/65536 of a second. Zero value (default)
+   * stops the watcher. Could be changed only for an opened environment.
+   *
+   * \returns \ref MDBX_ENOSYS on attempt to enable the watcher on systems
+   * other than Linux 5.3 or newer. */
+  MDBX_opt_dead_readers_watch,
+
+  /** \brief Controls the in-process limit of online growth of the readers
+   * table.
+   *
+   * \details When all slots of the readers table are busy and there are no
+   * dead readers, a process with non-zero value grows the table up to the
+   * given number of slots, instead of failing with \ref MDBX_READERS_FULL.
+   * The lck-file is extended in place, so there is no need to reopen the
+   * environment, while all other processes pick up the grown table. Thus the
+   * \ref MDBX_opt_max_readers could be sized modestly, yet the bursts of
+   * readers would be absorbed. The table is never shrunk until all processes
+   * close the environment. Zero value (default) disables the growth.
+   *
+   * \returns \ref MDBX_ENOSYS on attempt to enable the growth on Windows. */
+  MDBX_opt_readers_growth_limit,
 };
 #ifndef __cplusplus
 /** \ingroup c_settings */
@@ -2657,6 +2823,160 @@ LIBMDBX_INLINE_API(int, mdbx_env_sync_poll, (MDBX_env * env)) {
   return mdbx_env_sync_ex(env, false, true);
 }
 
+/** \brief Prefetch GC records for the next write transaction.
+ * \ingroup c_extra
+ *
+ * Reads and merges the lists of pages from the oldest GC records which are
+ * reclaimable, i.e. older than the oldest reader, and hands the prepared
+ * list over to the next write transaction. So the page faults on cold GC
+ * pages and the merging of ones are moved out of the write transaction.
+ *
+ * This function is intended to be called from an auxiliary thread while the
+ * writer is idle, or between write transactions. The prepared list is used
+ * only if no write transaction is committed in between, otherwise it is
+ * dropped silently. The amount of prefetched pages is limited to a half of
+ * GC records which fit in a single page, like the coalescing of GC records
+ * during page allocation.
+ *
+ * \note This call is not valid if the environment was opened with
+ * \ref MDBX_RDONLY, and it should not be called by a thread which runs
+ * a transaction in the same environment.
+ *
+ * \param [in] env   An environment handle returned by \ref mdbx_env_create().
+ *
+ * \returns A non-zero error value on failure and \ref MDBX_RESULT_TRUE or 0 on
+ *     success. The \ref MDBX_RESULT_TRUE means there is nothing to prefetch,
+ *     or a write transaction was committed meanwhile.
+ *     Some possible errors are:
+ *
+ * \retval MDBX_EACCES   the environment is read-only.
+ * \retval MDBX_BUSY     a write transaction is running.
+ * \retval MDBX_EINVAL   an invalid parameter was specified. */
+LIBMDBX_API int mdbx_env_gc_prefetch(MDBX_env *env);
+
+/** \brief Relocates pages from the end of the database file into the free
+ * holes below, to allow the file to be shrunk without a compacting copy.
+ * \ingroup c_extra
+ *
+ * Within a single write transaction, reclaims the GC records to get the free
+ * holes, then walks the b-trees of all tables and relocates the pages which
+ * are located at or above the boundary, beyond which the used pages could be
+ * fit into the holes. The relocation is performed by the copy-on-write, as
+ * for any modification, so the page numbers in parents are updated as usual.
+ *
+ * The relocated pages become free after the transaction is committed and
+ * ones are no longer used by readers. Then the next write transaction returns
+ * ones into the unallocated space, and the datafile will be shrunk according
+ * to the geometry settings, see \ref mdbx_env_set_geometry(). Therefore this
+ * function should be called repeatedly, e.g. periodically in an auxiliary
+ * thread, until \ref MDBX_RESULT_TRUE is returned.
+ *
+ * \note The pages of GC and the large/overflow pages are not relocated.
+ * The leaf pages of the main and dupsort tables are read entirely, since
+ * ones may contain the records of nested trees.
+ *
+ * \param [in] env           An environment handle returned
+ *                           by \ref mdbx_env_create().
+ * \param [in] budget_pages  The maximal number of pages to be relocated,
+ *                           i.e. the limit of the transaction size.
+ * \param [in] timeout_seconds_16dot16  Optional timeout in 1/65536 of second
+ *                           to limit the walk, zero means no limit.
+ *
+ * \returns A non-zero error value on failure and \ref MDBX_RESULT_TRUE or 0 on
+ *     success. The \ref MDBX_RESULT_TRUE means nothing was relocated, i.e.
+ *     there are no suitable pages at the end of the file or no free holes
+ *     which are not used by readers.
+ *     Some possible errors are:
+ *
+ * \retval MDBX_EACCES   the environment is read-only.
+ * \retval MDBX_BUSY     the calling thread runs a write transaction.
+ * \retval MDBX_EINVAL   an invalid parameter was specified. */
+LIBMDBX_API int mdbx_env_defrag(MDBX_env *env, size_t budget_pages,
+                                unsigned timeout_seconds_16dot16);
+
+/** \brief Waits until a transaction with the given or a greater ID is
+ * committed, including by other processes.
+ * \ingroup c_extra
+ *
+ * This function is intended for the consumers of data, which otherwise would
+ * poll for the changes by starting read transactions periodically. On Linux
+ * the waiting is performed by a futex in the shared lock file, therefore
+ * the waiter is woken up just after the commit of the meta-page. On other
+ * platforms the waiting degrades to polling with a granularity about of
+ * a millisecond.
+ *
+ * For instance, to wait for any changes since a read transaction was
+ * started, pass the `mdbx_txn_id(txn) + 1` as the `txnid` argument.
+ *
+ * \note The calling thread should not run a write transaction in the same
+ * environment, since such waiting would never end.
+ *
+ * \param [in] env     An environment handle returned
+ *                     by \ref mdbx_env_create().
+ * \param [in] txnid   The transaction ID to wait for.
+ * \param [in] timeout_seconds_16dot16  Optional timeout in 1/65536 of second,
+ *                     zero means no limit.
+ *
+ * \returns A non-zero error value on failure and \ref MDBX_RESULT_TRUE or 0 on
+ *     success. The \ref MDBX_RESULT_TRUE means the timeout was expired.
+ *     Some possible errors are:
+ *
+ * \retval MDBX_EPERM    the environment was opened without the lock file,
+ *                       so the commits could not be waited for.
+ * \retval MDBX_BUSY     the calling thread runs a write transaction.
+ * \retval MDBX_EINVAL   an invalid parameter was specified. */
+LIBMDBX_API int mdbx_env_wait_txnid(MDBX_env *env, uint64_t txnid,
+                                    unsigned timeout_seconds_16dot16);
+
+/** \brief A callback function used to enumerate the change feed.
+ * \ingroup c_extra
+ *
+ * \param [in] ctx    An arbitrary context pointer for the callback.
+ * \param [in] txnid  The ID of the transaction which made the change.
+ * \param [in] table  The name of the changed table, empty for the main one.
+ * \param [in] begin  The lowest modified key, or NULL if the whole table
+ *                    should be considered as changed.
+ * \param [in] end    The highest modified key, or NULL if the whole table
+ *                    should be considered as changed.
+ *
+ * \returns Zero to continue the enumeration, otherwise it will be stopped
+ * and the returned value will be passed to the caller.
+ * \see mdbx_changes_enum() */
+typedef int(MDBX_changes_func)(void *ctx, uint64_t txnid,
+                               const MDBX_val *table, const MDBX_val *begin,
+                               const MDBX_val *end) MDBX_CXX17_NOEXCEPT;
+
+/** \brief Enumerates the changes made by the transactions committed after
+ * the given one and visible to the given transaction.
+ * \ingroup c_extra
+ *
+ * The change feed is recorded by writers while the
+ * \ref MDBX_opt_changefeed_limit option is enabled. For each committed write
+ * transaction the callback is called once per each changed table, in the
+ * order of the transactions. The tables are identified by names, since the
+ * handles are process-local. The reported ranges of keys could be wider than
+ * the actually modified ones, e.g. after an aborted nested transaction, and
+ * there are no ranges for the deleted or emptied tables.
+ *
+ * A consumer would pass the ID of the last transaction it has seen, and then
+ * remember the \ref mdbx_txn_id() of the given transaction.
+ *
+ * \param [in] txn    A transaction handle returned by \ref mdbx_txn_begin().
+ * \param [in] since  The ID of the last transaction already seen.
+ * \param [in] func   A \ref MDBX_changes_func function.
+ * \param [in] ctx    An arbitrary context pointer for the callback.
+ *
+ * \returns A non-zero error value on failure and \ref MDBX_RESULT_TRUE or 0 on
+ *     success. The \ref MDBX_RESULT_TRUE means some of transactions were not
+ *     recorded or their records are already deleted, so the consumer should
+ *     rescan the data.
+ *     Some possible errors are:
+ *
+ * \retval MDBX_BAD_TXN  the transaction is already finished or never began.
+ * \retval MDBX_EINVAL   an invalid parameter was specified. */
+LIBMDBX_API int mdbx_changes_enum(MDBX_txn *txn, uint64_t since,
+                                  MDBX_changes_func *func, void *ctx);
+
 /** \brief Sets threshold to force flush the data buffers to disk, even any of
  * \ref MDBX_SAFE_NOSYNC flag in the environment.
  * \ingroup c_settings
@@ -3297,6 +3617,10 @@ LIBMDBX_INLINE_API(int, mdbx_env_set_maxreaders,
  * \ingroup c_statinfo
  * \see mdbx_env_set_maxreaders()
  *
+ * \details For an opened environment the current capacity of the readers
+ * table is returned, including the growth made by other processes,
+ * see \ref MDBX_opt_readers_growth_limit.
+ *
  * \param [in] env       An environment handle returned
  *                       by \ref mdbx_env_create().
  * \param [out] readers  Address of an integer to store the number of readers.
@@ -3525,6 +3849,41 @@ LIBMDBX_API int mdbx_txn_begin_ex(MDBX_env *env, MDBX_txn *parent,
                                   MDBX_txn_flags_t flags, MDBX_txn **txn,
                                   void *context);
 
+/** \brief Create a transaction with a user provided context pointer, waiting
+ * for the write lock no longer than the given timeout.
+ * \ingroup c_transactions
+ *
+ * Acts like \ref mdbx_txn_begin_ex(), but gives up starting a write
+ * transaction if the write lock could not be acquired within the timeout,
+ * which allows to bound the latency of writers under contention. The actual
+ * duration of waiting is provided by \ref mdbx_txn_commit_info() inside
+ * \ref MDBX_commit_info::lock_wait. The timeout doesn't affect read-only
+ * and nested transactions, since they do not acquire the write lock.
+ * \see MDBX_opt_writer_fairness
+ *
+ * \param [in] env       An environment handle returned
+ *                       by \ref mdbx_env_create().
+ * \param [in] parent    A parent transaction or NULL,
+ *                       see \ref mdbx_txn_begin_ex().
+ * \param [in] flags     Special options for this transaction,
+ *                       see \ref mdbx_txn_begin_ex().
+ * \param [out] txn      Address where the new \ref MDBX_txn handle
+ *                       will be stored.
+ * \param [in] timeout_seconds_16dot16  The timeout in 1/65536 of second,
+ *                       zero means no limit.
+ * \param [in] context   A pointer to application context to be associated
+ *                       with created transaction.
+ *
+ * \returns A non-zero error value on failure and 0 on success,
+ *          the same as \ref mdbx_txn_begin_ex() and also:
+ * \retval MDBX_BUSY     The write lock was not acquired within the timeout,
+ *                       or the write transaction is already started by the
+ *                       current thread. */
+LIBMDBX_API int mdbx_txn_begin_timed(MDBX_env *env, MDBX_txn *parent,
+                                     MDBX_txn_flags_t flags, MDBX_txn **txn,
+                                     unsigned timeout_seconds_16dot16,
+                                     void *context);
+
 /** \brief Create a transaction for use with the environment.
  * \ingroup c_transactions
  *
@@ -3585,6 +3944,70 @@ LIBMDBX_INLINE_API(int, mdbx_txn_begin,
   return mdbx_txn_begin_ex(env, parent, flags, txn, NULL);
 }
 
+/** \brief Acquires a snapshot of the last committed MVCC-version of a database,
+ * which could be shared by any number of threads.
+ * \ingroup c_transactions
+ *
+ * The snapshot occupies a single slot in the reader table, which isn't bound
+ * to the calling thread. So the snapshot could be released by any thread and
+ * the calling thread is still able to start its own transactions.
+ *
+ * \see mdbx_txn_begin_snapshot() \see mdbx_snapshot_release()
+ *
+ * \param [in] env        An environment handle returned
+ *                        by \ref mdbx_env_create().
+ * \param [out] snapshot  Address where the new \ref MDBX_snapshot handle
+ *                        will be stored.
+ *
+ * \returns A non-zero error value on failure and 0 on success,
+ *          the errors are the same as for read-only transactions
+ *          by \ref mdbx_txn_begin_ex(). */
+LIBMDBX_API int mdbx_snapshot_acquire(MDBX_env *env, MDBX_snapshot **snapshot);
+
+/** \brief Releases a snapshot acquired by \ref mdbx_snapshot_acquire().
+ * \ingroup c_transactions
+ *
+ * The snapshot handle must not be used after this call, but the MVCC-version
+ * is retained until all transactions created from the snapshot are finished.
+ *
+ * \param [in] snapshot  A snapshot handle returned
+ *                       by \ref mdbx_snapshot_acquire().
+ *
+ * \returns A non-zero error value on failure and 0 on success. */
+LIBMDBX_API int mdbx_snapshot_release(MDBX_snapshot *snapshot);
+
+/** \brief Create a read-only transaction for the snapshot.
+ * \ingroup c_transactions
+ *
+ * Such transaction reads the MVCC-version pinned by the snapshot, but doesn't
+ * touch the reader table, nor the shared state of the environment. Therefore
+ * it starts much faster than a regular one, and any number of threads could
+ * use the same snapshot simultaneously.
+ *
+ * The transaction should be discarded using \ref mdbx_txn_abort() or
+ * \ref mdbx_txn_commit() as usual. The \ref mdbx_txn_reset() detaches the
+ * transaction from the snapshot, so the subsequent \ref mdbx_txn_renew()
+ * will start a regular read-only transaction.
+ *
+ * \note The transaction is owned by the calling thread as usual, moreover
+ * the calling thread must not start a write transaction while this one is
+ * in use.
+ *
+ * \param [in] snapshot  A snapshot handle returned
+ *                       by \ref mdbx_snapshot_acquire().
+ * \param [out] txn      Address where the new \ref MDBX_txn handle
+ *                       will be stored.
+ * \param [in] context   A pointer to application context to be associated
+ *                       with created transaction, the same as for
+ *                       \ref mdbx_txn_begin_ex().
+ *
+ * \returns A non-zero error value on failure and 0 on success,
+ *          some possible errors are:
+ * \retval MDBX_EBADSIGN  The snapshot handle is invalid or was released.
+ * \retval MDBX_ENOMEM    Out of memory. */
+LIBMDBX_API int mdbx_txn_begin_snapshot(MDBX_snapshot *snapshot,
+                                        MDBX_txn **txn, void *context);
+
 /** \brief Sets application information associated (a context pointer) with the
  * transaction.
  * \ingroup c_transactions
@@ -3739,9 +4162,10 @@ struct MDBX_commit_latency {
    * \note Статистика является общей для всех процессов работающих с одним
    * файлом БД и хранится в LCK-файле. Данные аккумулируются при фиксации всех
    * транзакций, но только в сборках libmdbx c установленной опцией
-   * \ref MDBX_ENABLE_PROFGC. Собранная статистика возвращаются любому процессу
-   * при использовании \ref mdbx_txn_commit_ex() и одновременно обнуляется
-   * при завершении транзакций верхнего уровня (не вложенных). */
+   * \ref MDBX_ENABLE_PROFGC и только процессами включившими профилирование
+   * посредством \ref MDBX_opt_gc_profiling. Собранная статистика возвращаются
+   * любому процессу при использовании \ref mdbx_txn_commit_ex() и одновременно
+   * обнуляется при завершении транзакций верхнего уровня (не вложенных). */
   struct {
     /** \brief Количество итераций обновления GC,
      *  больше 1 если были повторы/перезапуски. */
@@ -3819,6 +4243,52 @@ typedef struct MDBX_commit_latency MDBX_commit_latency;
  * \warning This function may be changed in future releases. */
 LIBMDBX_API int mdbx_txn_commit_ex(MDBX_txn *txn, MDBX_commit_latency *latency);
 
+/** \brief Information about a committed transaction, in addition
+ * to the \ref MDBX_commit_latency.
+ * \ingroup c_statinfo
+ * \see mdbx_txn_commit_info() */
+struct MDBX_commit_info {
+  /** \brief Number of pages spilled to disk by the transaction, including
+   * ones by the committed nested transactions.
+   * \see MDBX_opt_spill_policy */
+  uint32_t spill_pages;
+  /** \brief Number of spilled pages which were reloaded back into memory
+   * by the transaction, including ones by the committed nested transactions.
+   * \see MDBX_opt_spill_policy */
+  uint32_t unspill_pages;
+  /** \brief Duration of waiting for the write lock when the transaction
+   * was started, in 1/65536 of a second.
+   * \see mdbx_txn_begin_timed() \see MDBX_opt_writer_fairness */
+  uint32_t lock_wait;
+};
+#ifndef __cplusplus
+/** \ingroup c_statinfo */
+typedef struct MDBX_commit_info MDBX_commit_info;
+#endif
+
+/** \brief Commit all the operations of a transaction into the database,
+ * collect latency and additional information.
+ * \ingroup c_transactions
+ *
+ * Acts like \ref mdbx_txn_commit_ex(), but also fills the
+ * \ref MDBX_commit_info, which is provided separately to keep the layout of
+ * \ref MDBX_commit_latency intact. The information is provided on failure as
+ * well, the same way as the latency.
+ *
+ * \param [in] txn      A transaction handle returned by \ref mdbx_txn_begin().
+ * \param [out] latency The optional address of an \ref MDBX_commit_latency
+ *                      structure to be filled.
+ * \param [out] info    The optional address of an \ref MDBX_commit_info
+ *                      structure to be filled.
+ * \param [in] bytes    The size of \ref MDBX_commit_info.
+ *
+ * \returns The same as \ref mdbx_txn_commit(), except:
+ * \retval MDBX_EINVAL  An invalid size of \ref MDBX_commit_info was given,
+ *                      in this case the transaction remains untouched. */
+LIBMDBX_API int mdbx_txn_commit_info(MDBX_txn *txn,
+                                     MDBX_commit_latency *latency,
+                                     MDBX_commit_info *info, size_t bytes);
+
 /** \brief Commit all the operations of a transaction into the database.
  * \ingroup c_transactions
  *
@@ -4037,6 +4507,16 @@ LIBMDBX_API int mdbx_canary_get(const MDBX_txn *txn, MDBX_canary *canary);
 typedef int(MDBX_cmp_func)(const MDBX_val *a,
                            const MDBX_val *b) MDBX_CXX17_NOEXCEPT;
 
+/** \brief The prefix of names of the hidden tables, which are reserved for
+ * internal use.
+ * \ingroup c_dbi
+ *
+ * The hidden tables, i.e. the ones queued by \ref mdbx_drop_deferred() and
+ * the change feed (see \ref MDBX_opt_changefeed_limit), are stored as
+ * records of the main database like the named ones, but can't be opened by
+ * \ref mdbx_dbi_open(). */
+#define MDBX_HIDDEN_TABLE_PREFIX "\177mdbx."
+
 /** \brief Open or Create a database in the environment.
  * \ingroup c_dbi
  *
@@ -4065,6 +4545,7 @@ typedef int(MDBX_cmp_func)(const MDBX_val *a,
  * To use named database (with name != NULL), \ref mdbx_env_set_maxdbs()
  * must be called before opening the environment. Table names are
  * keys in the internal unnamed database, and may be read but not written.
+ * The names starting with \ref MDBX_HIDDEN_TABLE_PREFIX are reserved.
  *
  * \param [in] txn    transaction handle returned by \ref mdbx_txn_begin().
  * \param [in] name   The name of the database to open. If only a single
@@ -4124,6 +4605,8 @@ typedef int(MDBX_cmp_func)(const MDBX_val *a,
  *                         i.e. the passed flags is different with which the
  *                         database was created, or the database was already
  *                         opened with a different comparison function(s).
+ * \retval MDBX_EINVAL     An invalid parameter was specified, including
+ *                         the name of a hidden table.
  * \retval MDBX_THREAD_MISMATCH  Given transaction is not owned
  *                               by current thread. */
 LIBMDBX_API int mdbx_dbi_open(MDBX_txn *txn, const char *name,
@@ -4318,6 +4801,52 @@ LIBMDBX_API int mdbx_dbi_close(MDBX_env *env, MDBX_dbi dbi);
  * \returns A non-zero error value on failure and 0 on success. */
 LIBMDBX_API int mdbx_drop(MDBX_txn *txn, MDBX_dbi dbi, bool del);
 
+/** \brief Empty or delete and close a database, deferring the reclaiming of
+ * its pages to the subsequent write transactions.
+ * \ingroup c_crud
+ *
+ * Unlike \ref mdbx_drop() this function doesn't walk the whole b-tree of the
+ * database, but just detaches it and takes an amount of time which doesn't
+ * depend on the database size. The detached b-tree is queued as a hidden
+ * table inside the main database, and its pages are then reclaimed in bounded
+ * chunks by the subsequent write transactions, either automatically during
+ * commit (see \ref MDBX_opt_drop_reclaim_budget) or explicitly by
+ * \ref mdbx_drop_reclaim(). So a write lock is never held for minutes while
+ * a huge table is being dropped.
+ *
+ * \note The queued tables are visible as the records of the main database
+ * with names prefixed by the \ref MDBX_HIDDEN_TABLE_PREFIX and `dropped:`.
+ * Such tables can't be opened, so ones are skipped by the `mdbx_dump` and
+ * `mdbx_stat` utilities, while `mdbx_chk` checks ones only by the b-tree
+ * traversal.
+ *
+ * \see mdbx_drop() \see mdbx_drop_reclaim()
+ *
+ * \param [in] txn  A transaction handle returned by \ref mdbx_txn_begin().
+ * \param [in] dbi  A database handle returned by \ref mdbx_dbi_open().
+ * \param [in] del  `false` to empty the DB, `true` to delete it
+ *                  from the environment and close the DB handle.
+ *
+ * \returns A non-zero error value on failure and 0 on success. */
+LIBMDBX_API int mdbx_drop_deferred(MDBX_txn *txn, MDBX_dbi dbi, bool del);
+
+/** \brief Reclaims pages of the databases dropped by
+ * \ref mdbx_drop_deferred().
+ * \ingroup c_crud
+ *
+ * \see mdbx_drop_deferred() \see MDBX_opt_drop_reclaim_budget
+ *
+ * \param [in] txn          A write transaction handle returned
+ *                          by \ref mdbx_txn_begin().
+ * \param [in] budget_pages The approximate limit of pages to be released,
+ *                          the `SIZE_MAX` means reclaim all.
+ * \param [out] left_pages  The optional address to return the number of pages
+ *                          still to be reclaimed by subsequent calls.
+ *
+ * \returns A non-zero error value on failure and 0 on success. */
+LIBMDBX_API int mdbx_drop_reclaim(MDBX_txn *txn, size_t budget_pages,
+                                  size_t *left_pages);
+
 /** \brief Get items from a database.
  * \ingroup c_crud
  *
@@ -5257,7 +5786,8 @@ LIBMDBX_API int mdbx_reader_list(const MDBX_env *env,
  * \param [out] dead   Number of stale slots that were cleared.
  *
  * \returns A non-zero error value on failure and 0 on success,
- * or \ref MDBX_RESULT_TRUE if a dead reader(s) found or mutex was recovered. */
+ * or \ref MDBX_RESULT_TRUE if a dead reader(s) found or mutex was recovered.
+ * \see MDBX_opt_dead_readers_watch */
 LIBMDBX_API int mdbx_reader_check(MDBX_env *env, int *dead);
 
 /** \brief Returns a lag of the reading for the given transaction.
@@ -206,9 +206,11 @@
 #endif
 
 #if defined(__linux__) || defined(__gnu_linux__)
+#include <linux/futex.h>
 #include <sched.h>
 #include <sys/sendfile.h>
 #include <sys/statfs.h>
+#include <sys/syscall.h>
 #endif /* Linux */
 
 #ifndef _XOPEN_SOURCE
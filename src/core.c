@@ -949,45 +949,6 @@ static __always_inline bool atomic_cas64(MDBX_atomic_uint64_t *p, uint64_t c,
 }
 #endif /* MDBX_64BIT_CAS */
 
-static __always_inline bool atomic_cas32(MDBX_atomic_uint32_t *p, uint32_t c,
-                                         uint32_t v) {
-#ifdef MDBX_HAVE_C11ATOMICS
-  STATIC_ASSERT(sizeof(int) >= sizeof(uint32_t));
-  assert(atomic_is_lock_free(MDBX_c11a_rw(uint32_t, p)));
-  return atomic_compare_exchange_strong(MDBX_c11a_rw(uint32_t, p), &c, v);
-#elif defined(__GNUC__) || defined(__clang__)
-  return __sync_bool_compare_and_swap(&p->weak, c, v);
-#elif defined(_MSC_VER)
-  STATIC_ASSERT(sizeof(volatile long) == sizeof(volatile uint32_t));
-  return c ==
-         (uint32_t)_InterlockedCompareExchange((volatile long *)&p->weak, v, c);
-#elif defined(__APPLE__)
-  return OSAtomicCompareAndSwap32Barrier(c, v, &p->weak);
-#else
-#error FIXME: Unsupported compiler
-#endif
-}
-
-static __always_inline uint32_t atomic_add32(MDBX_atomic_uint32_t *p,
-                                             uint32_t v) {
-#ifdef MDBX_HAVE_C11ATOMICS
-  STATIC_ASSERT(sizeof(int) >= sizeof(uint32_t));
-  assert(atomic_is_lock_free(MDBX_c11a_rw(uint32_t, p)));
-  return atomic_fetch_add(MDBX_c11a_rw(uint32_t, p), v);
-#elif defined(__GNUC__) || defined(__clang__)
-  return __sync_fetch_and_add(&p->weak, v);
-#elif defined(_MSC_VER)
-  STATIC_ASSERT(sizeof(volatile long) == sizeof(volatile uint32_t));
-  return (uint32_t)_InterlockedExchangeAdd((volatile long *)&p->weak, v);
-#elif defined(__APPLE__)
-  return OSAtomicAdd32Barrier(v, &p->weak);
-#else
-#error FIXME: Unsupported compiler
-#endif
-}
-
-#define atomic_sub32(p, v) atomic_add32(p, 0 - (v))
-
 static __always_inline uint64_t safe64_txnid_next(uint64_t txnid) {
   txnid += xMDBX_TXNID_STEP;
 #if !MDBX_64BIT_CAS
@@ -1550,6 +1511,23 @@ bailout:
   return rc;
 }
 
+/* Extends the range of reader slots for the given key after the growth of
+ * the readers table, see readers_adopt(). */
+__cold static void rthc_extend(osal_thread_key_t key, MDBX_reader *end) {
+  rthc_lock();
+  for (size_t i = 0; i < rthc_count; ++i)
+    if (key == rthc_table[i].thr_tls_key) {
+      TRACE("== [%zi] = key %" PRIuPTR ", %p ... %p -> %p", i, (uintptr_t)key,
+            __Wpedantic_format_voidptr(rthc_table[i].begin),
+            __Wpedantic_format_voidptr(rthc_table[i].end),
+            __Wpedantic_format_voidptr(end));
+      if (rthc_table[i].end < end)
+        rthc_table[i].end = end;
+      break;
+    }
+  rthc_unlock();
+}
+
 __cold void rthc_remove(const osal_thread_key_t key) {
   thread_key_delete(key);
   rthc_lock();
@@ -2059,7 +2037,9 @@ static int lcklist_detach_locked(MDBX_env *env) {
                                                                                \
     if (AUDIT_ENABLED()) {                                                     \
       for (TYPE *scan = begin + 1; scan < end; ++scan)                         \
-        assert(CMP(scan[-1], scan[0]));                                        \
+        assert(EXPECT_LOW_CARDINALITY_OR_PRESORTED                             \
+                   ? !CMP(scan[0], scan[-1])                                   \
+                   : CMP(scan[-1], scan[0]));                                  \
     }                                                                          \
   }
 
@@ -2410,6 +2390,33 @@ static __always_inline bool pnl_check_allocated(const pgno_t *pl,
                            pnl_check(pl, limit));
 }
 
+#if !defined(MDBX_ATTRIBUTE_TARGET) &&                                         \
+    (__has_attribute(__target__) || __GNUC_PREREQ(5, 0))
+#define MDBX_ATTRIBUTE_TARGET(target) __attribute__((__target__(target)))
+#endif /* MDBX_ATTRIBUTE_TARGET */
+
+#if defined(__SSE2__)
+#define MDBX_ATTRIBUTE_TARGET_SSE2 /* nope */
+#elif (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__amd64__)
+#define __SSE2__
+#define MDBX_ATTRIBUTE_TARGET_SSE2 /* nope */
+#elif defined(MDBX_ATTRIBUTE_TARGET) && defined(__ia32__)
+#define MDBX_ATTRIBUTE_TARGET_SSE2 MDBX_ATTRIBUTE_TARGET("sse2")
+#endif /* __SSE2__ */
+
+#if defined(__AVX2__)
+#define MDBX_ATTRIBUTE_TARGET_AVX2 /* nope */
+#elif defined(MDBX_ATTRIBUTE_TARGET) && defined(__ia32__)
+#define MDBX_ATTRIBUTE_TARGET_AVX2 MDBX_ATTRIBUTE_TARGET("avx2")
+#endif /* __AVX2__ */
+
+#if defined(__AVX512BW__)
+#define MDBX_ATTRIBUTE_TARGET_AVX512BW /* nope */
+#elif defined(MDBX_ATTRIBUTE_TARGET) && defined(__ia32__) &&                   \
+    (__GNUC_PREREQ(6, 0) || __CLANG_PREREQ(5, 0))
+#define MDBX_ATTRIBUTE_TARGET_AVX512BW MDBX_ATTRIBUTE_TARGET("avx512bw")
+#endif /* __AVX512BW__ */
+
 static __always_inline void
 pnl_merge_inner(pgno_t *__restrict dst, const pgno_t *__restrict src_a,
                 const pgno_t *__restrict src_b,
@@ -2441,6 +2448,482 @@ pnl_merge_inner(pgno_t *__restrict dst, const pgno_t *__restrict src_a,
   } while (likely(src_b > src_b_detent));
 }
 
+/*----------------------------------------------------------------------------*/
+/* Vectorized kernels for merging and searching of the sorted lists */
+
+/* Searching in a huge sorted list is bound by the cache misses, since each
+ * step of the binary search depends on the previous one. Thus the k-ary search
+ * is used for such lists, i.e. the range is divided by the pivots, which are
+ * loaded at once and compared with the key by SIMD. Then the binary search is
+ * used inside the narrowed range. The same kernel is used for the dirty-page
+ * list, so the pivots are loaded with the stride in pgno_t units.
+ *
+ * For a list which fits into L2 the plain binary search is faster, therefore
+ * the threshold is the size of the list in bytes, but not a number of items. */
+#define MDBX_KSEARCH_THRESHOLD (2 * 1024 * 1024)
+#define MDBX_KSEARCH_TAIL 64
+
+#if defined(_MSC_VER) && !defined(__builtin_popcount) &&                       \
+    !__has_builtin(__builtin_popcount)
+MDBX_MAYBE_UNUSED static __always_inline unsigned
+__builtin_popcount(uint32_t value) {
+  value -= (value >> 1) & UINT32_C(0x55555555);
+  value =
+      (value & UINT32_C(0x33333333)) + ((value >> 2) & UINT32_C(0x33333333));
+  value = (value + (value >> 4)) & UINT32_C(0x0F0F0F0F);
+  return (value * UINT32_C(0x01010101)) >> 24;
+}
+#endif /* _MSC_VER */
+
+typedef struct ksearch_span {
+  size_t begin, length;
+} kspan_t;
+
+/* The XOR-mask of the items to be compared as signed integers, such that
+ * the pivot ordered before the key is less than one. */
+#define KSEARCH_ASCENDING UINT32_C(0x80000000)
+#define KSEARCH_DESCENDING UINT32_C(0x7FFFFFFF)
+#if MDBX_PNL_ASCENDING
+#define KSEARCH_PNL KSEARCH_ASCENDING
+#else
+#define KSEARCH_PNL KSEARCH_DESCENDING
+#endif /* MDBX_PNL_ASCENDING */
+
+MDBX_MAYBE_UNUSED static kspan_t ksearch_fallback(const pgno_t *const ptr,
+                                                  const size_t stride,
+                                                  const size_t length,
+                                                  const pgno_t key,
+                                                  const uint32_t xmask) {
+  (void)ptr, (void)stride, (void)key, (void)xmask;
+  const kspan_t span = {0, length};
+  return span;
+}
+
+/* The merge by SIMD uses the bitonic merging network. The sorted blocks of
+ * items are loaded from the both lists, choosing the list with the next item
+ * to be placed earlier, i.e. the same way as the scalar merge. Each new block
+ * is merged with the carried one, the half which consists of the items to be
+ * placed earlier is stored and the rest is carried to the next step. Thus a
+ * merge is performed backward and in-place, as pnl_merge_inner() does. */
+#define MDBX_VMERGE_THRESHOLD 32
+
+/* Merges the carried items and the tails of lists, one of which is shorter
+ * than a vector block, by the scalar loops. */
+MDBX_MAYBE_UNUSED static void vmerge_tail(pgno_t *__restrict dst, size_t a,
+                                          const pgno_t *__restrict src,
+                                          size_t b, const pgno_t *carry,
+                                          size_t c) {
+  size_t w = a + b + c;
+  const bool a_shorter = a < b;
+  const pgno_t *const x = a_shorter ? dst : src;
+  size_t n = a_shorter ? a : b, t = n + c;
+  assert(t <= 16);
+  pgno_t tmp[1 + 16];
+  const size_t tmp_len = t;
+  while (n && c)
+    tmp[t--] = MDBX_PNL_ORDERED(x[n], carry[c - 1]) ? carry[--c] : x[n--];
+  while (n)
+    tmp[t--] = x[n--];
+  while (c)
+    tmp[t--] = carry[--c];
+
+  const pgno_t *const y = a_shorter ? src : dst;
+  n = a_shorter ? b : a;
+  t = tmp_len;
+  while (n && t)
+    dst[w--] = MDBX_PNL_ORDERED(y[n], tmp[t]) ? tmp[t--] : y[n--];
+  while (t)
+    dst[w--] = tmp[t--];
+  if (a_shorter)
+    while (n)
+      dst[w--] = y[n--];
+  assert(w == n);
+}
+
+MDBX_MAYBE_UNUSED static void vmerge_fallback(pgno_t *__restrict dst, size_t a,
+                                              const pgno_t *__restrict src,
+                                              size_t b) {
+  dst[0] = /* the detent */ (MDBX_PNL_ASCENDING ? 0 : P_INVALID);
+  pnl_merge_inner(dst + a + b, dst + a, src + b, src);
+}
+
+#ifdef MDBX_ATTRIBUTE_TARGET_SSE2
+MDBX_ATTRIBUTE_TARGET_SSE2 static __always_inline void
+vminmax_sse2(const __m128i a, const __m128i b, __m128i *first, __m128i *last) {
+  const __m128i bias = _mm_set1_epi32(INT32_MIN);
+  const __m128i gt =
+      _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+  const __m128i max =
+      _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+  const __m128i min =
+      _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+  *first = MDBX_PNL_ASCENDING ? min : max;
+  *last = MDBX_PNL_ASCENDING ? max : min;
+}
+
+MDBX_ATTRIBUTE_TARGET_SSE2 static __always_inline __m128i
+vblend_sse2(const __m128i first, const __m128i last, const __m128i mask) {
+  return _mm_or_si128(_mm_and_si128(mask, last), _mm_andnot_si128(mask, first));
+}
+
+MDBX_ATTRIBUTE_TARGET_SSE2 static __always_inline __m128i
+bitonic_sse2(__m128i v) {
+  __m128i first, last;
+  vminmax_sse2(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)), &first, &last);
+  v = vblend_sse2(first, last, _mm_setr_epi32(0, 0, -1, -1));
+  vminmax_sse2(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)), &first, &last);
+  return vblend_sse2(first, last, _mm_setr_epi32(0, -1, 0, -1));
+}
+
+MDBX_MAYBE_UNUSED __hot MDBX_ATTRIBUTE_TARGET_SSE2 static void
+vmerge_sse2(pgno_t *__restrict dst, size_t a, const pgno_t *__restrict src,
+            size_t b) {
+  assert(a >= 4 && b >= 4);
+  size_t w = a + b;
+  __m128i carry, first, last;
+  if (MDBX_PNL_ORDERED(src[b], dst[a]))
+    carry = _mm_loadu_si128((const __m128i *)(dst + (a -= 4) + 1));
+  else
+    carry = _mm_loadu_si128((const __m128i *)(src + (b -= 4) + 1));
+  while (a >= 4 && b >= 4) {
+    const __m128i next =
+        MDBX_PNL_ORDERED(src[b], dst[a])
+            ? _mm_loadu_si128((const __m128i *)(dst + (a -= 4) + 1))
+            : _mm_loadu_si128((const __m128i *)(src + (b -= 4) + 1));
+    vminmax_sse2(carry, _mm_shuffle_epi32(next, _MM_SHUFFLE(0, 1, 2, 3)),
+                 &first, &last);
+    _mm_storeu_si128((__m128i *)(dst + (w -= 4) + 1), bitonic_sse2(last));
+    carry = bitonic_sse2(first);
+  }
+  pgno_t tail[4];
+  _mm_storeu_si128((__m128i *)tail, carry);
+  vmerge_tail(dst, a, src, b, tail, 4);
+}
+
+MDBX_MAYBE_UNUSED __hot MDBX_ATTRIBUTE_TARGET_SSE2 static kspan_t
+ksearch_sse2(const pgno_t *const ptr, const size_t stride, size_t length,
+             const pgno_t key, const uint32_t xmask) {
+  const __m128i mask = _mm_set1_epi32((int)xmask);
+  const __m128i k = _mm_set1_epi32((int)(key ^ xmask));
+  size_t begin = 0;
+  do {
+    const size_t step = length / 9, s = step * stride;
+    const pgno_t *const p = ptr + begin * stride;
+    const __m128i lo = _mm_setr_epi32(p[s], p[s * 2], p[s * 3], p[s * 4]);
+    const __m128i hi = _mm_setr_epi32(p[s * 5], p[s * 6], p[s * 7], p[s * 8]);
+    const __m128i lt_lo = _mm_cmpgt_epi32(k, _mm_xor_si128(lo, mask));
+    const __m128i lt_hi = _mm_cmpgt_epi32(k, _mm_xor_si128(hi, mask));
+    const size_t n = __builtin_popcount(
+        _mm_movemask_ps(_mm_castsi128_ps(lt_lo)) |
+        _mm_movemask_ps(_mm_castsi128_ps(lt_hi)) << 4);
+    begin += n * step;
+    length = (n < 8) ? step : length - 8 * step;
+  } while (length > MDBX_KSEARCH_TAIL);
+  const kspan_t span = {begin, length};
+  return span;
+}
+#endif /* MDBX_ATTRIBUTE_TARGET_SSE2 */
+
+#ifdef MDBX_ATTRIBUTE_TARGET_AVX2
+#if MDBX_PNL_ASCENDING
+#define VFIRST_AVX2(a, b) _mm256_min_epu32(a, b)
+#define VLAST_AVX2(a, b) _mm256_max_epu32(a, b)
+#else
+#define VFIRST_AVX2(a, b) _mm256_max_epu32(a, b)
+#define VLAST_AVX2(a, b) _mm256_min_epu32(a, b)
+#endif /* MDBX_PNL_ASCENDING */
+
+MDBX_ATTRIBUTE_TARGET_AVX2 static __always_inline __m256i
+bitonic_avx2(__m256i v) {
+  __m256i p = _mm256_permute2x128_si256(v, v, 1);
+  v = _mm256_blend_epi32(VFIRST_AVX2(v, p), VLAST_AVX2(v, p), 0xF0);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+  v = _mm256_blend_epi32(VFIRST_AVX2(v, p), VLAST_AVX2(v, p), 0xCC);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+  return _mm256_blend_epi32(VFIRST_AVX2(v, p), VLAST_AVX2(v, p), 0xAA);
+}
+
+MDBX_MAYBE_UNUSED __hot MDBX_ATTRIBUTE_TARGET_AVX2 static void
+vmerge_avx2(pgno_t *__restrict dst, size_t a, const pgno_t *__restrict src,
+            size_t b) {
+  assert(a >= 8 && b >= 8);
+  size_t w = a + b;
+  const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+  __m256i carry;
+  if (MDBX_PNL_ORDERED(src[b], dst[a]))
+    carry = _mm256_loadu_si256((const __m256i *)(dst + (a -= 8) + 1));
+  else
+    carry = _mm256_loadu_si256((const __m256i *)(src + (b -= 8) + 1));
+  while (a >= 8 && b >= 8) {
+    __m256i next =
+        MDBX_PNL_ORDERED(src[b], dst[a])
+            ? _mm256_loadu_si256((const __m256i *)(dst + (a -= 8) + 1))
+            : _mm256_loadu_si256((const __m256i *)(src + (b -= 8) + 1));
+    next = _mm256_permutevar8x32_epi32(next, reverse);
+    _mm256_storeu_si256((__m256i *)(dst + (w -= 8) + 1),
+                        bitonic_avx2(VLAST_AVX2(carry, next)));
+    carry = bitonic_avx2(VFIRST_AVX2(carry, next));
+  }
+  pgno_t tail[8];
+  _mm256_storeu_si256((__m256i *)tail, carry);
+  vmerge_tail(dst, a, src, b, tail, 8);
+}
+
+MDBX_MAYBE_UNUSED __hot MDBX_ATTRIBUTE_TARGET_AVX2 static kspan_t
+ksearch_avx2(const pgno_t *const ptr, const size_t stride, size_t length,
+             const pgno_t key, const uint32_t xmask) {
+  const __m256i mask = _mm256_set1_epi32((int)xmask);
+  const __m256i k = _mm256_set1_epi32((int)(key ^ xmask));
+  size_t begin = 0;
+  do {
+    const size_t step = length / 9, s = step * stride;
+    const pgno_t *const p = ptr + begin * stride;
+    const __m256i pivots =
+        _mm256_setr_epi32(p[s], p[s * 2], p[s * 3], p[s * 4], p[s * 5],
+                          p[s * 6], p[s * 7], p[s * 8]);
+    const __m256i lt = _mm256_cmpgt_epi32(k, _mm256_xor_si256(pivots, mask));
+    const size_t n =
+        __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(lt)));
+    begin += n * step;
+    length = (n < 8) ? step : length - 8 * step;
+  } while (length > MDBX_KSEARCH_TAIL);
+  const kspan_t span = {begin, length};
+  return span;
+}
+#endif /* MDBX_ATTRIBUTE_TARGET_AVX2 */
+
+#ifdef MDBX_ATTRIBUTE_TARGET_AVX512BW
+MDBX_MAYBE_UNUSED __hot MDBX_ATTRIBUTE_TARGET_AVX512BW static kspan_t
+ksearch_avx512bw(const pgno_t *const ptr, const size_t stride, size_t length,
+                 const pgno_t key, const uint32_t xmask) {
+  const __m512i mask = _mm512_set1_epi32((int)xmask);
+  const __m512i k = _mm512_set1_epi32((int)(key ^ xmask));
+  size_t begin = 0;
+  do {
+    const size_t step = length / 17, s = step * stride;
+    const pgno_t *const p = ptr + begin * stride;
+    const __m512i pivots = _mm512_setr_epi32(
+        p[s], p[s * 2], p[s * 3], p[s * 4], p[s * 5], p[s * 6], p[s * 7],
+        p[s * 8], p[s * 9], p[s * 10], p[s * 11], p[s * 12], p[s * 13],
+        p[s * 14], p[s * 15], p[s * 16]);
+    const size_t n = __builtin_popcount(
+        _mm512_cmpgt_epi32_mask(k, _mm512_xor_si512(pivots, mask)));
+    begin += n * step;
+    length = (n < 16) ? step : length - 16 * step;
+  } while (length > MDBX_KSEARCH_TAIL);
+  const kspan_t span = {begin, length};
+  return span;
+}
+#endif /* MDBX_ATTRIBUTE_TARGET_AVX512BW */
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) &&                          \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#if MDBX_PNL_ASCENDING
+#define VFIRST_NEON(a, b) vminq_u32(a, b)
+#define VLAST_NEON(a, b) vmaxq_u32(a, b)
+#else
+#define VFIRST_NEON(a, b) vmaxq_u32(a, b)
+#define VLAST_NEON(a, b) vminq_u32(a, b)
+#endif /* MDBX_PNL_ASCENDING */
+
+static __always_inline uint32x4_t bitonic_neon(uint32x4_t v) {
+  uint32x4_t p = vextq_u32(v, v, 2);
+  v = vcombine_u32(vget_low_u32(VFIRST_NEON(v, p)),
+                   vget_high_u32(VLAST_NEON(v, p)));
+  p = vrev64q_u32(v);
+  const uint32x4_t odd =
+      vreinterpretq_u32_u64(vdupq_n_u64(UINT64_C(0xFFFFFFFF00000000)));
+  return vbslq_u32(odd, VLAST_NEON(v, p), VFIRST_NEON(v, p));
+}
+
+MDBX_MAYBE_UNUSED __hot static void vmerge_neon(pgno_t *__restrict dst,
+                                                size_t a,
+                                                const pgno_t *__restrict src,
+                                                size_t b) {
+  assert(a >= 4 && b >= 4);
+  size_t w = a + b;
+  uint32x4_t carry;
+  if (MDBX_PNL_ORDERED(src[b], dst[a]))
+    carry = vld1q_u32(dst + (a -= 4) + 1);
+  else
+    carry = vld1q_u32(src + (b -= 4) + 1);
+  while (a >= 4 && b >= 4) {
+    uint32x4_t next = MDBX_PNL_ORDERED(src[b], dst[a])
+                          ? vld1q_u32(dst + (a -= 4) + 1)
+                          : vld1q_u32(src + (b -= 4) + 1);
+    next = vrev64q_u32(vextq_u32(next, next, 2));
+    vst1q_u32(dst + (w -= 4) + 1, bitonic_neon(VLAST_NEON(carry, next)));
+    carry = bitonic_neon(VFIRST_NEON(carry, next));
+  }
+  pgno_t tail[4];
+  vst1q_u32(tail, carry);
+  vmerge_tail(dst, a, src, b, tail, 4);
+}
+
+MDBX_MAYBE_UNUSED __hot static kspan_t
+ksearch_neon(const pgno_t *const ptr, const size_t stride, size_t length,
+             const pgno_t key, const uint32_t xmask) {
+  /* NEON compares unsigned integers, so the sign bit isn't flipped */
+  const uint32x4_t mask = vdupq_n_u32(xmask ^ UINT32_C(0x80000000));
+  const uint32x4_t k = vdupq_n_u32(key ^ xmask ^ UINT32_C(0x80000000));
+  size_t begin = 0;
+  do {
+    const size_t step = length / 9, s = step * stride;
+    const pgno_t *const p = ptr + begin * stride;
+    const pgno_t pivots[8] = {p[s],     p[s * 2], p[s * 3], p[s * 4],
+                              p[s * 5], p[s * 6], p[s * 7], p[s * 8]};
+    const uint32x4_t lt =
+        vaddq_u32(vshrq_n_u32(vcltq_u32(veorq_u32(vld1q_u32(pivots), mask), k),
+                              31),
+                  vshrq_n_u32(vcltq_u32(veorq_u32(vld1q_u32(pivots + 4), mask),
+                                        k),
+                              31));
+    const uint32x2_t sum = vadd_u32(vget_low_u32(lt), vget_high_u32(lt));
+    const size_t n = vget_lane_u32(vpadd_u32(sum, sum), 0);
+    begin += n * step;
+    length = (n < 8) ? step : length - 8 * step;
+  } while (length > MDBX_KSEARCH_TAIL);
+  const kspan_t span = {begin, length};
+  return span;
+}
+#endif /* __ARM_NEON || __ARM_NEON__ */
+
+#if defined(__AVX512BW__) && defined(MDBX_ATTRIBUTE_TARGET_AVX512BW)
+#define ksearch_default ksearch_avx512bw
+#define vmerge_default vmerge_avx2
+#define ksearch ksearch_default
+#define vmerge vmerge_default
+#elif defined(__AVX2__) && defined(MDBX_ATTRIBUTE_TARGET_AVX2)
+#define ksearch_default ksearch_avx2
+#define vmerge_default vmerge_avx2
+#elif defined(__SSE2__) && defined(MDBX_ATTRIBUTE_TARGET_SSE2)
+#define ksearch_default ksearch_sse2
+#define vmerge_default vmerge_sse2
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) &&                        \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define ksearch_default ksearch_neon
+#define vmerge_default vmerge_neon
+#define ksearch ksearch_default
+#define vmerge vmerge_default
+#else
+#define ksearch_default ksearch_fallback
+#define vmerge_default vmerge_fallback
+#define ksearch ksearch_default
+#define vmerge vmerge_default
+#endif
+
+#ifdef ksearch
+/* The ksearch() and vmerge() are the best or no alternatives */
+#elif !MDBX_HAVE_BUILTIN_CPU_SUPPORTS
+#define ksearch ksearch_default
+#define vmerge vmerge_default
+#else
+/* Selecting the most appropriate implementation at runtime,
+ * depending on the available CPU features, like scan4seq() does. */
+static void simd_resolve(void);
+
+static kspan_t ksearch_resolver(const pgno_t *const ptr, const size_t stride,
+                                const size_t length, const pgno_t key,
+                                const uint32_t xmask);
+static kspan_t (*ksearch)(const pgno_t *const ptr, const size_t stride,
+                          const size_t length, const pgno_t key,
+                          const uint32_t xmask) = ksearch_resolver;
+
+static void vmerge_resolver(pgno_t *__restrict dst, size_t a,
+                            const pgno_t *__restrict src, size_t b);
+static void (*vmerge)(pgno_t *__restrict dst, size_t a,
+                      const pgno_t *__restrict src,
+                      size_t b) = vmerge_resolver;
+
+static void simd_resolve(void) {
+#if __has_builtin(__builtin_cpu_init) || defined(__BUILTIN_CPU_INIT__) ||      \
+    __GNUC_PREREQ(4, 8)
+  __builtin_cpu_init();
+#endif /* __builtin_cpu_init() */
+  kspan_t (*ksearch_choice)(const pgno_t *const ptr, const size_t stride,
+                            const size_t length, const pgno_t key,
+                            const uint32_t xmask) = ksearch_default;
+  void (*vmerge_choice)(pgno_t *__restrict dst, size_t a,
+                        const pgno_t *__restrict src, size_t b) =
+      vmerge_default;
+#ifdef MDBX_ATTRIBUTE_TARGET_SSE2
+  if (__builtin_cpu_supports("sse2")) {
+    ksearch_choice = ksearch_sse2;
+    vmerge_choice = vmerge_sse2;
+  }
+#endif /* MDBX_ATTRIBUTE_TARGET_SSE2 */
+#ifdef MDBX_ATTRIBUTE_TARGET_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    ksearch_choice = ksearch_avx2;
+    vmerge_choice = vmerge_avx2;
+  }
+#endif /* MDBX_ATTRIBUTE_TARGET_AVX2 */
+#ifdef MDBX_ATTRIBUTE_TARGET_AVX512BW
+  if (__builtin_cpu_supports("avx512bw"))
+    ksearch_choice = ksearch_avx512bw;
+#endif /* MDBX_ATTRIBUTE_TARGET_AVX512BW */
+  /* Choosing of another variants should be added here. */
+  ksearch = ksearch_choice;
+  vmerge = vmerge_choice;
+}
+
+static kspan_t ksearch_resolver(const pgno_t *const ptr, const size_t stride,
+                                const size_t length, const pgno_t key,
+                                const uint32_t xmask) {
+  simd_resolve();
+  return ksearch(ptr, stride, length, key, xmask);
+}
+
+static void vmerge_resolver(pgno_t *__restrict dst, size_t a,
+                            const pgno_t *__restrict src, size_t b) {
+  simd_resolve();
+  vmerge(dst, a, src, b);
+}
+#endif /* ksearch */
+
+/* Merge the source items by runs of the adjacent page numbers, i.e. moving
+ * the whole spans of the destination items between ones. The items ordered
+ * after a run are found by galloping back from the end of destination. */
+static void pnl_merge_runs(pgno_t *__restrict dst, size_t a,
+                           const pgno_t *__restrict src, size_t b) {
+  size_t w = a + b;
+  do {
+    size_t r = b;
+    while (r > 1 &&
+           src[r - 1] == (MDBX_PNL_ASCENDING ? src[r] - 1 : src[r] + 1))
+      --r;
+
+    /* Search for the number of destination items ordered before the run */
+    const pgno_t key = src[b];
+    size_t lo = 0, hi = a, step = 1;
+    while (hi >= step) {
+      if (!MDBX_PNL_ORDERED(key, dst[hi - step + 1])) {
+        lo = hi - step + 1;
+        break;
+      }
+      hi -= step;
+      step <<= 1;
+    }
+    while (lo < hi) {
+      const size_t mid = (lo + hi + 1) >> 1;
+      if (MDBX_PNL_ORDERED(key, dst[mid]))
+        hi = mid - 1;
+      else
+        lo = mid;
+    }
+
+    const size_t moved = a - lo;
+    w -= moved;
+    memmove(dst + w + 1, dst + lo + 1, moved * sizeof(pgno_t));
+    a = lo;
+    const size_t run = b - r + 1;
+    w -= run;
+    memcpy(dst + w + 1, src + r, run * sizeof(pgno_t));
+    b = r - 1;
+  } while (b);
+  assert(w == a);
+}
+
 /* Merge a PNL onto a PNL. The destination PNL must be big enough */
 __hot static size_t pnl_merge(MDBX_PNL dst, const MDBX_PNL src) {
   assert(pnl_check_allocated(dst, MAX_PAGENO + 1));
@@ -2451,8 +2934,18 @@ __hot static size_t pnl_merge(MDBX_PNL dst, const MDBX_PNL src) {
   if (likely(src_len > 0)) {
     total += src_len;
     assert(MDBX_PNL_ALLOCLEN(dst) >= total);
-    dst[0] = /* the detent */ (MDBX_PNL_ASCENDING ? 0 : P_INVALID);
-    pnl_merge_inner(dst + total, dst + dst_len, src + src_len, src);
+    /* A dense source consists of a few long runs, e.g. a GC record of the
+     * dropped table, and is merged by runs instead of items. */
+    if (src_len > 32 && MDBX_PNL_MOST(src) - MDBX_PNL_LEAST(src) <
+                            src_len + src_len / 4) {
+      pnl_merge_runs(dst, dst_len, src, src_len);
+    } else if (src_len >= MDBX_VMERGE_THRESHOLD &&
+               dst_len >= MDBX_VMERGE_THRESHOLD) {
+      vmerge(dst, dst_len, src, src_len);
+    } else {
+      dst[0] = /* the detent */ (MDBX_PNL_ASCENDING ? 0 : P_INVALID);
+      pnl_merge_inner(dst + total, dst + dst_len, src + src_len, src);
+    }
     MDBX_PNL_SETSIZE(dst, total);
   }
   assert(pnl_check_allocated(dst, MAX_PAGENO + 1));
@@ -2521,9 +3014,73 @@ RADIXSORT_IMPL(pgno, pgno_t, MDBX_PNL_EXTRACT_KEY,
 
 SORT_IMPL(pgno_sort, false, pgno_t, MDBX_PNL_ORDERED)
 
+/* The range-compressed form of a PNL, i.e. the runs of adjacent page numbers */
+typedef struct pnl_run {
+  pgno_t first, len;
+} pnl_run_t;
+
+#define PNL_RUN_ORDERED(a, b) ((a).first < (b).first)
+SORT_IMPL(pnl_run_sort, false, pnl_run_t, PNL_RUN_ORDERED)
+
+/* Sorts a PNL by runs instead of items, if ones dominate. This is the case
+ * of a retired list of a dropped table or a rewritten large range, which is
+ * appended by the mostly contiguous spans in an arbitrary order.
+ * Returns false if the regular sort should be used. */
+static bool pnl_sort_runs(MDBX_PNL pnl) {
+  const size_t len = MDBX_PNL_GETSIZE(pnl), limit = len / 4;
+#if MDBX_PNL_PREALLOC_FOR_RADIXSORT
+  /* the buffer is the same as for the radix sort */
+  pnl_run_t *const runs = (pnl_run_t *)(pnl + len + 1);
+#else
+  pnl_run_t *const runs = osal_malloc(sizeof(pnl_run_t) * limit);
+  if (unlikely(!runs))
+    return false;
+#endif /* MDBX_PNL_PREALLOC_FOR_RADIXSORT */
+
+  bool done = false;
+  size_t n = 0;
+  for (size_t i = 1; i <= len; ++n) {
+    /* Give up early when the runs are short */
+    if (unlikely(n >= limit || n * 4 > i + 64))
+      goto bailout;
+    pgno_t lo = pnl[i], hi = lo;
+    while (++i <= len) {
+      if (pnl[i] == hi + 1)
+        hi += 1;
+      else if (pnl[i] == lo - 1)
+        lo -= 1;
+      else
+        break;
+    }
+    runs[n].first = lo;
+    runs[n].len = hi - lo + 1;
+  }
+
+  pnl_run_sort(runs, runs + n);
+  size_t w = 0;
+#if MDBX_PNL_ASCENDING
+  for (const pnl_run_t *r = runs; r < runs + n; ++r)
+    for (pgno_t pgno = r->first; pgno < r->first + r->len; ++pgno)
+      pnl[++w] = pgno;
+#else
+  for (const pnl_run_t *r = runs + n; r-- > runs;)
+    for (pgno_t pgno = r->first + r->len; pgno > r->first;)
+      pnl[++w] = --pgno;
+#endif /* MDBX_PNL_ASCENDING */
+  assert(w == len);
+  done = true;
+
+bailout:
+#if !MDBX_PNL_PREALLOC_FOR_RADIXSORT
+  osal_free(runs);
+#endif /* !MDBX_PNL_PREALLOC_FOR_RADIXSORT */
+  return done;
+}
+
 __hot __noinline static void pnl_sort_nochk(MDBX_PNL pnl) {
   if (likely(MDBX_PNL_GETSIZE(pnl) < MDBX_RADIXSORT_THRESHOLD) ||
-      unlikely(!pgno_radixsort(&MDBX_PNL_FIRST(pnl), MDBX_PNL_GETSIZE(pnl))))
+      unlikely(!pnl_sort_runs(pnl) &&
+               !pgno_radixsort(&MDBX_PNL_FIRST(pnl), MDBX_PNL_GETSIZE(pnl))))
     pgno_sort(MDBX_PNL_BEGIN(pnl), MDBX_PNL_END(pnl));
 }
 
@@ -2540,7 +3097,14 @@ SEARCH_IMPL(pgno_bsearch, pgno_t, pgno_t, MDBX_PNL_ORDERED)
 __hot __noinline static size_t pnl_search_nochk(const MDBX_PNL pnl,
                                                 pgno_t pgno) {
   const pgno_t *begin = MDBX_PNL_BEGIN(pnl);
-  const pgno_t *it = pgno_bsearch(begin, MDBX_PNL_GETSIZE(pnl), pgno);
+  size_t length = MDBX_PNL_GETSIZE(pnl);
+  const pgno_t *from = begin;
+  if (length * sizeof(pgno_t) > MDBX_KSEARCH_THRESHOLD) {
+    const kspan_t span = ksearch(begin, 1, length, pgno, KSEARCH_PNL);
+    from += span.begin;
+    length = span.length;
+  }
+  const pgno_t *it = pgno_bsearch(from, length, pgno);
   const pgno_t *end = begin + MDBX_PNL_GETSIZE(pnl);
   assert(it >= begin && it <= end);
   if (it != begin)
@@ -2604,6 +3168,19 @@ static __inline bool intersect_spilled(const MDBX_txn *txn, pgno_t pgno,
   return rc;
 }
 
+/* Drops the index of runs after pages were added into the relist. */
+static __inline void runs_invalidate(MDBX_txn *txn) {
+  if (txn->tw.relist_runs)
+    txn->tw.relist_runs->coherent = SIZE_MAX;
+}
+
+/* Keeps the index of runs coherent after pages were cut off from the relist,
+ * since the entries which became stale are verified by runs_find(). */
+static __inline void runs_cutoff(MDBX_txn *txn, size_t before, size_t after) {
+  if (txn->tw.relist_runs && txn->tw.relist_runs->coherent == before)
+    txn->tw.relist_runs->coherent = after;
+}
+
 /*----------------------------------------------------------------------------*/
 
 static __always_inline size_t txl_size2bytes(const size_t size) {
@@ -2692,6 +3269,22 @@ static void txl_sort(MDBX_TXL tl) {
   txnid_sort(MDBX_PNL_BEGIN(tl), MDBX_PNL_END(tl));
 }
 
+#if MDBX_ENABLE_GC_GAPS
+/* The same order, but admits duplicates, e.g. for snapshots of readers */
+SORT_IMPL(txnid_sort_dups, true, txnid_t, TXNID_SORT_CMP)
+
+/* Sorts and removes duplicates in the single pass */
+static void txl_sort_unique(MDBX_TXL tl) {
+  txnid_sort_dups(MDBX_PNL_BEGIN(tl), MDBX_PNL_END(tl));
+  const size_t len = MDBX_PNL_GETSIZE(tl);
+  size_t w = len ? 1 : 0;
+  for (size_t r = 2; r <= len; ++r)
+    if (tl[r] != tl[w])
+      tl[++w] = tl[r];
+  MDBX_PNL_SETSIZE(tl, w);
+}
+#endif /* MDBX_ENABLE_GC_GAPS */
+
 static int __must_check_result txl_append(MDBX_TXL *ptl, txnid_t id) {
   if (unlikely(MDBX_PNL_GETSIZE(*ptl) == MDBX_PNL_ALLOCLEN(*ptl))) {
     int rc = txl_need(ptl, MDBX_TXL_GRANULATE);
@@ -2710,6 +3303,14 @@ static int __must_check_result txl_append(MDBX_TXL *ptl, txnid_t id) {
 #define MDBX_DPL_RESERVE_GAP                                                   \
   (MDBX_DPL_GAP_FOR_MERGESORT + MDBX_DPL_GAP_FOR_EDGING)
 
+/* The dirty list longer than the threshold is accompanied by the hash index,
+ * since a binary search over a huge list is expensive due to cache misses,
+ * but sorting the list on every lookup in the unsorted tail is even worse. */
+#define MDBX_DPL_HASH_THRESHOLD 8192
+/* The number of unindexed items to be (re)indexed by a lookup unconditionally,
+ * otherwise the reindexing is deferred until it pays off. */
+#define MDBX_DPL_HASH_EAGER 64
+
 static __always_inline size_t dpl_size2bytes(ptrdiff_t size) {
   assert(size > CURSOR_STACK && (size_t)size <= MDBX_PGL_LIMIT);
 #if MDBX_DPL_PREALLOC_FOR_RADIXSORT
@@ -2746,6 +3347,8 @@ static __always_inline size_t dpl_setlen(MDBX_dpl *dl, size_t len) {
   assert(dpl_stub_pageE.mp_flags == P_BAD &&
          dpl_stub_pageE.mp_pgno == P_INVALID);
   dl->length = len;
+  if (dl->hash)
+    dl->hash->hashed = 0;
   dl->items[len + 1].ptr = (MDBX_page *)&dpl_stub_pageE;
   dl->items[len + 1].pgno = P_INVALID;
   dl->items[len + 1].extra = 0;
@@ -2765,6 +3368,8 @@ static __always_inline void dpl_clear(MDBX_dpl *dl) {
 
 static void dpl_free(MDBX_txn *txn) {
   if (likely(txn->tw.dirtylist)) {
+    osal_free(txn->tw.dirtylist->hash);
+    osal_free(txn->tw.dirtylist->refs);
     osal_free(txn->tw.dirtylist);
     txn->tw.dirtylist = NULL;
   }
@@ -2783,6 +3388,10 @@ static MDBX_dpl *dpl_reserve(MDBX_txn *txn, size_t size) {
 #endif /* malloc_usable_size */
     dl->detent = dpl_bytes2size(bytes);
     tASSERT(txn, txn->tw.dirtylist == NULL || dl->length <= dl->detent);
+    if (!txn->tw.dirtylist) {
+      dl->hash = NULL;
+      dl->refs = NULL;
+    }
     txn->tw.dirtylist = dl;
   }
   return dl;
@@ -2796,6 +3405,11 @@ static int dpl_alloc(MDBX_txn *txn) {
                         ? txn->mt_env->me_options.dp_initial
                         : txn->mt_geo.upper;
   if (txn->tw.dirtylist) {
+    /* the index and the reference bits will be re-created if required */
+    osal_free(txn->tw.dirtylist->hash);
+    txn->tw.dirtylist->hash = NULL;
+    osal_free(txn->tw.dirtylist->refs);
+    txn->tw.dirtylist->refs = NULL;
     dpl_clear(txn->tw.dirtylist);
     const int realloc_threshold = 64;
     if (likely(
@@ -2854,6 +3468,9 @@ __hot __noinline static MDBX_dpl *dpl_sort_slowpath(const MDBX_txn *txn) {
 #endif
       } while (likely(--w > l));
       assert(r == tmp - 1);
+      /* the items before the merge point are left in place */
+      if (dl->hash && dl->hash->hashed > (size_t)(l - dl->items))
+        dl->hash->hashed = l - dl->items;
       assert(dl->items[0].pgno == 0 &&
              dl->items[dl->length + 1].pgno == P_INVALID);
       if (ASSERT_ENABLED())
@@ -2863,10 +3480,14 @@ __hot __noinline static MDBX_dpl *dpl_sort_slowpath(const MDBX_txn *txn) {
       dp_sort(dl->items + 1, dl->items + dl->length + 1);
       assert(dl->items[0].pgno == 0 &&
              dl->items[dl->length + 1].pgno == P_INVALID);
+      if (dl->hash)
+        dl->hash->hashed = 0;
     }
   } else {
     assert(dl->items[0].pgno == 0 &&
            dl->items[dl->length + 1].pgno == P_INVALID);
+    if (dl->hash)
+      dl->hash->hashed = 0;
   }
   dl->sorted = dl->length;
   return dl;
@@ -2929,7 +3550,17 @@ __hot __noinline static size_t dpl_search(const MDBX_txn *txn, pgno_t pgno) {
     /* continue bsearch on the sorted part */
     break;
   }
-  return dp_bsearch(dl->items + 1, dl->sorted, pgno) - dl->items;
+  const MDBX_dp *from = dl->items + 1;
+  size_t length = dl->sorted;
+  if (length * sizeof(MDBX_dp) > MDBX_KSEARCH_THRESHOLD) {
+    STATIC_ASSERT(sizeof(MDBX_dp) % sizeof(pgno_t) == 0);
+    const kspan_t span =
+        ksearch(&from->pgno, sizeof(MDBX_dp) / sizeof(pgno_t), length, pgno,
+                KSEARCH_ASCENDING);
+    from += span.begin;
+    length = span.length;
+  }
+  return dp_bsearch(from, length, pgno) - dl->items;
 }
 
 MDBX_NOTHROW_PURE_FUNCTION static __inline unsigned
@@ -2950,7 +3581,7 @@ static __inline bool dpl_intersect(const MDBX_txn *txn, pgno_t pgno,
   tASSERT(txn, (txn->mt_flags & MDBX_TXN_RDONLY) == 0);
   tASSERT(txn, (txn->mt_flags & MDBX_WRITEMAP) == 0 || MDBX_AVOID_MSYNC);
 
-  MDBX_dpl *dl = txn->tw.dirtylist;
+  MDBX_dpl *dl = dpl_sort(txn);
   assert(dl->sorted == dl->length);
   assert(dl->items[0].pgno == 0 && dl->items[dl->length + 1].pgno == P_INVALID);
   size_t const n = dpl_search(txn, pgno);
@@ -2973,9 +3604,96 @@ static __inline bool dpl_intersect(const MDBX_txn *txn, pgno_t pgno,
   return rc;
 }
 
+static __always_inline size_t dph_slot(const MDBX_dph *dh, pgno_t pgno) {
+  /* Fibonacci hashing */
+  return (size_t)((pgno * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - dh->bits));
+}
+
+static void dph_upsert(MDBX_dph *dh, pgno_t pgno, size_t idx) {
+  const size_t mask = ((size_t)1 << dh->bits) - 1;
+  for (size_t n = dph_slot(dh, pgno);; n = (n + 1) & mask) {
+    if (dh->slots[n].pgno == pgno) {
+      dh->slots[n].idx = (uint32_t)idx;
+      return;
+    }
+    if (dh->slots[n].pgno == 0) {
+      dh->slots[n].pgno = pgno;
+      dh->slots[n].idx = (uint32_t)idx;
+      dh->used += 1;
+      return;
+    }
+  }
+}
+
+static MDBX_dph *dph_reserve(MDBX_dpl *dl) {
+  size_t bits = 10;
+  while (((size_t)1 << bits) < dl->length * 2)
+    bits += 1;
+  const size_t bytes =
+      sizeof(MDBX_dph) + ((size_t)1 << bits) * sizeof(dl->hash->slots[0]);
+  MDBX_dph *const dh = osal_calloc(1, bytes);
+  if (likely(dh)) {
+    osal_free(dl->hash);
+    dh->bits = bits;
+    dl->hash = dh;
+  }
+  return dh;
+}
+
+/* Looks up an exact pgno through the hash index, which is (re)built lazily.
+ * Returns the position within the dirty list or zero if page isn't dirty,
+ * but SIZE_MAX when the index isn't usable so dpl_search() should be used. */
+__hot __noinline static size_t dpl_hash_find(MDBX_dpl *dl, pgno_t pgno) {
+  MDBX_dph *dh = dl->hash;
+  if (unlikely(!dh || ((size_t)1 << dh->bits) < dl->length * 2)) {
+    dh = dph_reserve(dl);
+    if (unlikely(!dh))
+      return SIZE_MAX;
+    /* building is amortized by the appends since the list has been grown */
+    dh->debt = dl->length;
+  }
+
+  assert(dh->hashed <= dl->length);
+  const size_t pending = dl->length - dh->hashed;
+  if (unlikely(pending)) {
+    /* Postpone reindexing after massive removals or sorting, until the
+     * amount of lookups done without index is commensurate to the work. */
+    if (pending > MDBX_DPL_HASH_EAGER && pending > dh->debt * 16) {
+      dh->debt += 1;
+      return SIZE_MAX;
+    }
+    const size_t capacity = (size_t)1 << dh->bits;
+    if (dh->used + pending > capacity - capacity / 4) {
+      /* too many stale items, so rebuild from scratch */
+      memset(dh->slots, 0, capacity * sizeof(dh->slots[0]));
+      dh->used = dh->hashed = 0;
+    }
+    for (size_t i = dh->hashed + 1; i <= dl->length; ++i)
+      dph_upsert(dh, dl->items[i].pgno, i);
+    dh->hashed = dl->length;
+    dh->debt = 0;
+  }
+
+  const size_t mask = ((size_t)1 << dh->bits) - 1;
+  for (size_t n = dph_slot(dh, pgno); dh->slots[n].pgno; n = (n + 1) & mask)
+    if (dh->slots[n].pgno == pgno) {
+      const size_t i = dh->slots[n].idx;
+      /* the slot may be stale, but never points to a wrong item */
+      return (i <= dl->length && dl->items[i].pgno == pgno) ? i : 0;
+    }
+  return 0;
+}
+
 static __always_inline size_t dpl_exist(const MDBX_txn *txn, pgno_t pgno) {
   tASSERT(txn, (txn->mt_flags & MDBX_WRITEMAP) == 0 || MDBX_AVOID_MSYNC);
   MDBX_dpl *dl = txn->tw.dirtylist;
+  if (dl->length >= MDBX_DPL_HASH_THRESHOLD) {
+    const size_t i = dpl_hash_find(dl, pgno);
+    if (likely(i != SIZE_MAX)) {
+      assert(i == 0 || dl->items[i].pgno == pgno);
+      return i;
+    }
+  }
   size_t i = dpl_search(txn, pgno);
   assert((int)i > 0);
   return (dl->items[i].pgno == pgno) ? i : 0;
@@ -3014,6 +3732,8 @@ static void dpl_remove_ex(const MDBX_txn *txn, size_t i, size_t npages) {
   dl->pages_including_loose -= npages;
   dl->sorted -= dl->sorted >= i;
   dl->length -= 1;
+  if (dl->hash && dl->hash->hashed >= i)
+    dl->hash->hashed = i - 1 /* the following items will be shifted */;
   memmove(dl->items + i, dl->items + i + 1,
           (dl->length - i + 2) * sizeof(dl->items[0]));
   assert(dl->items[0].pgno == 0 && dl->items[dl->length + 1].pgno == P_INVALID);
@@ -3023,6 +3743,36 @@ static void dpl_remove(const MDBX_txn *txn, size_t i) {
   dpl_remove_ex(txn, i, dpl_npages(txn->tw.dirtylist, i));
 }
 
+/* Removes an item by moving the last one into its place, i.e. breaks the
+ * ordering but avoids shifting the rest of a huge list. */
+static void dpl_remove_unordered(const MDBX_txn *txn, size_t i,
+                                 size_t npages) {
+  tASSERT(txn, (txn->mt_flags & MDBX_TXN_RDONLY) == 0);
+  tASSERT(txn, (txn->mt_flags & MDBX_WRITEMAP) == 0 || MDBX_AVOID_MSYNC);
+
+  MDBX_dpl *dl = txn->tw.dirtylist;
+  assert((intptr_t)i > 0 && i <= dl->length);
+  assert(dl->items[0].pgno == 0 && dl->items[dl->length + 1].pgno == P_INVALID);
+  const size_t last = dl->length;
+  dl->pages_including_loose -= npages;
+  if (dl->sorted >= i)
+    dl->sorted = (i < last) ? i - 1 : last - 1;
+  dl->items[i] = dl->items[last];
+  dl->items[last] = dl->items[last + 1] /* the stub beyond the end */;
+  dl->length = last - 1;
+
+  MDBX_dph *const dh = dl->hash;
+  if (dh) {
+    if (dh->hashed >= last) {
+      if (i < last)
+        dph_upsert(dh, dl->items[i].pgno, i);
+      dh->hashed = last - 1;
+    } else if (dh->hashed >= i)
+      dh->hashed = i - 1;
+  }
+  assert(dl->items[0].pgno == 0 && dl->items[dl->length + 1].pgno == P_INVALID);
+}
+
 static __always_inline int __must_check_result dpl_append(MDBX_txn *txn,
                                                           pgno_t pgno,
                                                           MDBX_page *page,
@@ -3068,6 +3818,7 @@ static __always_inline int __must_check_result dpl_append(MDBX_txn *txn,
   dl->items[length].ptr = page;
   dl->items[length].pgno = pgno;
   dl->items[length].multi = npages > 1;
+  dl->items[length].heat = 0;
   dl->items[length].lru = txn->tw.dirtylru++;
   dl->length = length;
   dl->sorted = sorted;
@@ -3082,7 +3833,7 @@ static __inline uint32_t dpl_age(const MDBX_txn *txn, size_t i) {
   const MDBX_dpl *dl = txn->tw.dirtylist;
   assert((intptr_t)i > 0 && i <= dl->length);
   /* overflow could be here */
-  return (txn->tw.dirtylru - dl->items[i].lru) & UINT32_C(0x7fffFFFF);
+  return (txn->tw.dirtylru - dl->items[i].lru) & UINT32_C(0x1fffFFFF);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -3131,6 +3882,17 @@ enum {
 #define MDBX_END_SLOT 0x80    /* release any reader slot if MDBX_NOTLS */
 static int txn_end(MDBX_txn *txn, const unsigned mode);
 
+#if MDBX_ENABLE_ASYNC_SPILL
+/* Waits for writing of the spilled pages and releases ones. */
+static int spill_async_wait(MDBX_env *env);
+
+/* Ensures the spilled pages are written, i.e. could be read from the map. */
+static __always_inline int spill_async_confirm(MDBX_env *env) {
+  return likely(!env->me_spill_async.active) ? MDBX_SUCCESS
+                                             : spill_async_wait(env);
+}
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
+
 static __always_inline pgr_t page_get_inline(const uint16_t ILL,
                                              MDBX_cursor *const mc,
                                              const pgno_t pgno,
@@ -3265,6 +4027,15 @@ static void cursor_copy(const MDBX_cursor *csrc, MDBX_cursor *cdst);
 
 static int __must_check_result drop_tree(MDBX_cursor *mc,
                                          const bool may_have_subDBs);
+static int __must_check_result drop_reclaim(MDBX_txn *txn, size_t budget,
+                                            size_t *left);
+static int __must_check_result changefeed_track(MDBX_cursor *mc,
+                                                const MDBX_val *key);
+static int __must_check_result changefeed_track_current(MDBX_cursor *mc);
+static int __must_check_result changefeed_drop(MDBX_txn *txn, size_t dbi,
+                                               bool del);
+static int __must_check_result changefeed_commit(MDBX_txn *txn);
+static int __must_check_result changefeed_open(MDBX_env *env);
 static int __must_check_result fetch_sdb(MDBX_txn *txn, size_t dbi);
 static int __must_check_result setup_dbx(MDBX_dbx *const dbx,
                                          const MDBX_db *const db,
@@ -3660,11 +4431,168 @@ int mdbx_dcmp(const MDBX_txn *txn, MDBX_dbi dbi, const MDBX_val *a,
   return txn->mt_dbxs[dbi].md_dcmp(a, b);
 }
 
+#if MDBX_ENABLE_DPARENA
+/* The arena of dirty pages.
+ *
+ * Single pages and small multi-page blocks are carved out of the large
+ * anonymous mappings ("chunks"), while the released single-page slots are
+ * kept in a list for re-use within a transaction. At the end of a write
+ * transaction the whole arena is rewound at once, so there is no need to
+ * visit each dirty page for releasing, unless some large blocks were
+ * allocated by malloc() and still in use. */
+
+static __always_inline size_t dparena_chunk_bytes(const MDBX_env *env) {
+  const size_t huge = (size_t)2 << 20 /* 2 MiB, i.e. the huge page on x86 */;
+  const size_t bytes = pgno2bytes(env, 64);
+  return (bytes > huge) ? bytes : huge;
+}
+
+/* Blocks larger than the threshold are allocated by malloc() */
+static __always_inline bool dparena_fit(const MDBX_env *env, size_t num) {
+  return pgno2bytes(env, num) <= dparena_chunk_bytes(env) / 4;
+}
+
+static void *dparena_map(MDBX_env *env, size_t bytes) {
+#if defined(_WIN32) || defined(_WIN64)
+  (void)env;
+  return VirtualAlloc(NULL, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+  void *ptr;
+#ifdef MAP_HUGETLB
+  if (!env->me_dparena.no_hugetlb) {
+    ptr = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED)
+      return ptr;
+    /* don't try again, since huge pages are not configured or exhausted */
+    env->me_dparena.no_hugetlb = true;
+  }
+#endif /* MAP_HUGETLB */
+  ptr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+             -1, 0);
+  if (unlikely(ptr == MAP_FAILED))
+    return NULL;
+#if defined(MADV_HUGEPAGE)
+  (void)madvise(ptr, bytes, MADV_HUGEPAGE);
+#endif /* MADV_HUGEPAGE */
+  return ptr;
+#endif /* !Windows */
+}
+
+static void dparena_unmap(void *ptr, size_t bytes) {
+#if defined(_WIN32) || defined(_WIN64)
+  (void)bytes;
+  VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+  munmap(ptr, bytes);
+#endif /* !Windows */
+}
+
+static void *dparena_alloc(MDBX_env *env, size_t bytes) {
+  if (bytes == env->me_psize && env->me_dparena.freed) {
+    MDBX_page *np = env->me_dparena.freed;
+    MDBX_ASAN_UNPOISON_MEMORY_REGION(np, bytes);
+    env->me_dparena.freed = np->mp_next;
+    return np;
+  }
+
+  while (unlikely((size_t)(env->me_dparena.end - env->me_dparena.ptr) <
+                  bytes)) {
+    /* recycle the tail of the current chunk as single-page slots */
+    while (env->me_dparena.ptr < env->me_dparena.end) {
+      MDBX_page *dp = (MDBX_page *)env->me_dparena.ptr;
+      env->me_dparena.ptr += env->me_psize;
+      dp->mp_next = env->me_dparena.freed;
+      env->me_dparena.freed = dp;
+      MDBX_ASAN_POISON_MEMORY_REGION((char *)dp + sizeof(dp->mp_next),
+                                     env->me_psize - sizeof(dp->mp_next));
+    }
+
+    const size_t chunk_bytes = dparena_chunk_bytes(env);
+    size_t next = env->me_dparena.current + 1;
+    if (env->me_dparena.ptr == NULL)
+      next = 0 /* nothing was carved since the rewind */;
+    if (next == env->me_dparena.count) {
+      void **chunks = osal_realloc(env->me_dparena.chunks,
+                                   sizeof(void *) * (next + 1));
+      if (unlikely(!chunks))
+        return NULL;
+      env->me_dparena.chunks = chunks;
+      chunks[next] = dparena_map(env, chunk_bytes);
+      if (unlikely(!chunks[next]))
+        return NULL;
+      MDBX_ASAN_POISON_MEMORY_REGION(chunks[next], chunk_bytes);
+      env->me_dparena.count = next + 1;
+    }
+    env->me_dparena.current = next;
+    env->me_dparena.ptr = env->me_dparena.chunks[next];
+    env->me_dparena.end = env->me_dparena.ptr + chunk_bytes;
+  }
+
+  void *ptr = env->me_dparena.ptr;
+  env->me_dparena.ptr += bytes;
+  MDBX_ASAN_UNPOISON_MEMORY_REGION(ptr, bytes);
+  return ptr;
+}
+
+/* Rewinds the arena, provided all the carved blocks are no longer in use.
+ * The mapped chunks beyond the MDBX_opt_dp_reserve_limit are released. */
+static void dparena_reset(MDBX_env *env) {
+  const size_t chunk_bytes = dparena_chunk_bytes(env);
+  size_t keep = (pgno2bytes(env, env->me_options.dp_reserve_limit) +
+                 chunk_bytes - 1) /
+                chunk_bytes;
+  if (keep < 1)
+    keep = 1;
+  while (env->me_dparena.count > keep)
+    dparena_unmap(env->me_dparena.chunks[--env->me_dparena.count],
+                  chunk_bytes);
+  for (size_t i = 0; i < env->me_dparena.count; ++i)
+    MDBX_ASAN_POISON_MEMORY_REGION(env->me_dparena.chunks[i], chunk_bytes);
+  env->me_dparena.current = 0;
+  env->me_dparena.ptr = env->me_dparena.end = NULL;
+  env->me_dparena.freed = NULL;
+}
+
+static void dparena_destroy(MDBX_env *env) {
+  const size_t chunk_bytes = dparena_chunk_bytes(env);
+  while (env->me_dparena.count)
+    dparena_unmap(env->me_dparena.chunks[--env->me_dparena.count],
+                  chunk_bytes);
+  osal_free(env->me_dparena.chunks);
+  env->me_dparena.chunks = NULL;
+  env->me_dparena.ptr = env->me_dparena.end = NULL;
+  env->me_dparena.freed = NULL;
+}
+#endif /* MDBX_ENABLE_DPARENA */
+
 /* Allocate memory for a page.
  * Re-use old malloc'ed pages first for singletons, otherwise just malloc.
  * Set MDBX_TXN_ERROR on failure. */
 static MDBX_page *page_malloc(MDBX_txn *txn, size_t num) {
   MDBX_env *env = txn->mt_env;
+#if MDBX_ENABLE_DPARENA
+  MDBX_page *np;
+  const size_t size = pgno2bytes(env, num);
+  if (likely(dparena_fit(env, num))) {
+    np = dparena_alloc(env, size);
+    if (unlikely(!np)) {
+      txn->mt_flags |= MDBX_TXN_ERROR;
+      return np;
+    }
+  } else {
+    np = osal_malloc(size);
+    if (unlikely(!np)) {
+      txn->mt_flags |= MDBX_TXN_ERROR;
+      return np;
+    }
+    env->me_dparena.foreign += 1;
+  }
+  VALGRIND_MEMPOOL_ALLOC(env, np, size);
+#else
   MDBX_page *np = env->me_dp_reserve;
   size_t size = env->me_psize;
   if (likely(num == 1 && np)) {
@@ -3683,6 +4611,7 @@ static MDBX_page *page_malloc(MDBX_txn *txn, size_t num) {
     }
     VALGRIND_MEMPOOL_ALLOC(env, np, size);
   }
+#endif /* MDBX_ENABLE_DPARENA */
 
   if ((env->me_flags & MDBX_NOMEMINIT) == 0) {
     /* For a single page alloc, we init everything after the page header.
@@ -3708,6 +4637,24 @@ static void dpage_free(MDBX_env *env, MDBX_page *dp, size_t npages) {
   MDBX_ASAN_UNPOISON_MEMORY_REGION(dp, pgno2bytes(env, npages));
   if (unlikely(env->me_flags & MDBX_PAGEPERTURB))
     memset(dp, -1, pgno2bytes(env, npages));
+#if MDBX_ENABLE_DPARENA
+  VALGRIND_MEMPOOL_FREE(env, dp);
+  if (likely(dparena_fit(env, npages))) {
+    /* split the block into single-page slots for re-use */
+    for (char *ptr = (char *)dp + pgno2bytes(env, npages); ptr > (char *)dp;) {
+      ptr -= env->me_psize;
+      MDBX_page *const slot = (MDBX_page *)ptr;
+      slot->mp_next = env->me_dparena.freed;
+      env->me_dparena.freed = slot;
+      MDBX_ASAN_POISON_MEMORY_REGION(ptr + sizeof(slot->mp_next),
+                                     env->me_psize - sizeof(slot->mp_next));
+    }
+  } else {
+    eASSERT(env, env->me_dparena.foreign > 0);
+    env->me_dparena.foreign -= 1;
+    osal_free(dp);
+  }
+#else
   if (npages == 1 &&
       env->me_dp_reserve_len < env->me_options.dp_reserve_limit) {
     MDBX_ASAN_POISON_MEMORY_REGION((char *)dp + sizeof(dp->mp_next),
@@ -3721,6 +4668,7 @@ static void dpage_free(MDBX_env *env, MDBX_page *dp, size_t npages) {
     VALGRIND_MEMPOOL_FREE(env, dp);
     osal_free(dp);
   }
+#endif /* MDBX_ENABLE_DPARENA */
 }
 
 /* Return all dirty pages to dpage list */
@@ -3729,6 +4677,26 @@ static void dlist_free(MDBX_txn *txn) {
   MDBX_env *env = txn->mt_env;
   MDBX_dpl *const dl = txn->tw.dirtylist;
 
+#if MDBX_ENABLE_DPARENA
+  if (!txn->mt_parent) {
+    /* All pages carved from the arena belong to the top-level transaction
+     * at this point, thus just rewind the arena. */
+    if (unlikely(env->me_dparena.foreign || RUNNING_ON_VALGRIND ||
+                 (env->me_flags & MDBX_PAGEPERTURB))) {
+      for (size_t i = 1; i <= dl->length; i++) {
+        const size_t npages = dpl_npages(dl, i);
+        if (!dparena_fit(env, npages) || RUNNING_ON_VALGRIND ||
+            (env->me_flags & MDBX_PAGEPERTURB))
+          dpage_free(env, dl->items[i].ptr, npages);
+      }
+      eASSERT(env, env->me_dparena.foreign == 0);
+    }
+    dparena_reset(env);
+    dpl_clear(dl);
+    return;
+  }
+#endif /* MDBX_ENABLE_DPARENA */
+
   for (size_t i = 1; i <= dl->length; i++)
     dpage_free(env, dl->items[i].ptr, dpl_npages(dl, i));
 
@@ -3833,6 +4801,7 @@ static void refund_reclaimed(MDBX_txn *txn) {
   /* Scanning in descend order */
   pgno_t next_pgno = txn->mt_next_pgno;
   const MDBX_PNL pnl = txn->tw.relist;
+  const size_t before = MDBX_PNL_GETSIZE(pnl);
   tASSERT(txn, MDBX_PNL_GETSIZE(pnl) && MDBX_PNL_MOST(pnl) == next_pgno - 1);
 #if MDBX_PNL_ASCENDING
   size_t i = MDBX_PNL_GETSIZE(pnl);
@@ -3850,6 +4819,7 @@ static void refund_reclaimed(MDBX_txn *txn) {
   for (size_t move = 0; move < len; ++move)
     pnl[1 + move] = pnl[i + move];
 #endif
+  runs_cutoff(txn, before, MDBX_PNL_GETSIZE(pnl));
   VERBOSE("refunded %" PRIaPGNO " pages: %" PRIaPGNO " -> %" PRIaPGNO,
           txn->mt_next_pgno - next_pgno, txn->mt_next_pgno, next_pgno);
   txn->mt_next_pgno = next_pgno;
@@ -4068,13 +5038,16 @@ __cold static void kill_page(MDBX_txn *txn, MDBX_page *mp, pgno_t pgno,
 }
 
 /* Remove page from dirty list */
-static __inline void page_wash(MDBX_txn *txn, const size_t di,
-                               MDBX_page *const mp, const size_t npages) {
+static void page_wash_ex(MDBX_txn *txn, const size_t di, MDBX_page *const mp,
+                         const size_t npages, const bool keep_order) {
   tASSERT(txn, (txn->mt_flags & MDBX_TXN_RDONLY) == 0);
   tASSERT(txn, (txn->mt_flags & MDBX_WRITEMAP) == 0 || MDBX_AVOID_MSYNC);
   tASSERT(txn, di && di <= txn->tw.dirtylist->length &&
                    txn->tw.dirtylist->items[di].ptr == mp);
-  dpl_remove_ex(txn, di, npages);
+  if (likely(keep_order))
+    dpl_remove_ex(txn, di, npages);
+  else
+    dpl_remove_unordered(txn, di, npages);
   txn->tw.dirtyroom++;
   tASSERT(txn, txn->tw.dirtyroom + txn->tw.dirtylist->length ==
                    (txn->mt_parent ? txn->mt_parent->tw.dirtyroom
@@ -4091,14 +5064,75 @@ static __inline void page_wash(MDBX_txn *txn, const size_t di,
     dpage_free(txn->mt_env, mp, npages);
 }
 
-/* Retire, loosen or free a single page.
- *
+static __inline void page_wash(MDBX_txn *txn, const size_t di,
+                               MDBX_page *const mp, const size_t npages) {
+  page_wash_ex(txn, di, mp, npages, true);
+}
+
+static bool shadowed_in_ancestors(const MDBX_txn *txn, pgno_t pgno) {
+  tASSERT(txn, txn->mt_parent != nullptr);
+  for (MDBX_txn *parent = txn->mt_parent; parent; parent = parent->mt_parent)
+    if (dpl_exist(parent, pgno))
+      return true;
+  return false;
+}
+
+/* The notes of reclaimed pages are used only by the incremental merge into
+ * a huge dirty list of an ancestor, see txn_merge_incremental(). The dirty
+ * lists of ancestors are not changed while a nested txn is running, so the
+ * notes (and the lookups for ones) are useless unless such ancestor exists. */
+static bool shadowed_reclaimed_tracked(const MDBX_txn *txn) {
+  for (MDBX_txn *parent = txn->mt_parent; parent; parent = parent->mt_parent)
+    if (parent->tw.dirtylist &&
+        parent->tw.dirtylist->length >= MDBX_DPL_HASH_THRESHOLD)
+      return true;
+  return false;
+}
+
+/* Notes the page reclaimed by a nested txn if it is dirty in an ancestor,
+ * since such page should be removed from the parent's dirty list on commit. */
+static int shadowed_reclaimed_note(MDBX_txn *txn, pgno_t pgno) {
+  if (shadowed_reclaimed_tracked(txn) && shadowed_in_ancestors(txn, pgno)) {
+    if (!txn->tw.shadowed_reclaimed) {
+      txn->tw.shadowed_reclaimed = pnl_alloc(MDBX_PNL_INITIAL);
+      if (unlikely(!txn->tw.shadowed_reclaimed))
+        return MDBX_ENOMEM;
+    }
+    int err = pnl_need(&txn->tw.shadowed_reclaimed, 1);
+    if (unlikely(err != MDBX_SUCCESS))
+      return err;
+    MDBX_PNL pl = txn->tw.shadowed_reclaimed;
+    MDBX_PNL_SETSIZE(pl, MDBX_PNL_GETSIZE(pl) + 1);
+    MDBX_PNL_LAST(pl) = pgno;
+  }
+  return MDBX_SUCCESS;
+}
+
+/* Retire, loosen or free a single page.
+ *
  * For dirty pages, saves single pages to a list for future reuse in this same
  * txn. It has been pulled from the GC and already resides on the dirty list,
  * but has been deleted. Use these pages first before pulling again from the GC.
  *
  * If the page wasn't dirtied in this txn, just add it
  * to this txn's free list. */
+#if MDBX_ENABLE_GC_GAPS
+/* Lowers the least birth txnid of retired pages, which is unknown (zero)
+ * for pages were retired without reading.
+ *
+ * The birth is the mp_txnid of a frozen page image, which is always stamped
+ * by iov_page() with the txnid of the top-level txn which writes it, both for
+ * committed and spilled pages. The mp_txnid is also re-stamped by the merge
+ * of a nested txn and by page_touch(), but only for dirty pages, which are
+ * never retired into GC but become loose or are reclaimed immediately. */
+static __inline void retired_birth_note(MDBX_txn *txn, const MDBX_page *mp) {
+  tASSERT(txn, !mp || IS_FROZEN(txn, mp));
+  const txnid_t birth = mp ? mp->mp_txnid : 0;
+  if (txn->tw.retired_birth > birth)
+    txn->tw.retired_birth = birth;
+}
+#endif /* MDBX_ENABLE_GC_GAPS */
+
 static int page_retire_ex(MDBX_cursor *mc, const pgno_t pgno,
                           MDBX_page *mp /* maybe null */,
                           unsigned pageflags /* maybe unknown/zero */) {
@@ -4196,6 +5230,14 @@ static int page_retire_ex(MDBX_cursor *mc, const pgno_t pgno,
   }
 
 status_done:
+#if MDBX_ENABLE_ASYNC_SPILL
+  /* A page still being written should not be reused nor overwritten */
+  if (is_spilled) {
+    rc = spill_async_confirm(txn->mt_env);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+  }
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
   if (likely((pageflags & P_OVERFLOW) == 0)) {
     STATIC_ASSERT(P_BRANCH == 1);
     const bool is_branch = pageflags & P_BRANCH;
@@ -4219,6 +5261,9 @@ status_done:
   if (is_frozen) {
   retire:
     DEBUG("retire %zu page %" PRIaPGNO, npages, pgno);
+#if MDBX_ENABLE_GC_GAPS
+    retired_birth_note(txn, mp);
+#endif /* MDBX_ENABLE_GC_GAPS */
     rc = pnl_append_range(false, &txn->tw.retired_pages, pgno, npages);
     tASSERT(txn, dirtylist_check(txn));
     return rc;
@@ -4340,8 +5385,11 @@ status_done:
   reclaim:
     DEBUG("reclaim %zu %s page %" PRIaPGNO, npages, "dirty", pgno);
     rc = pnl_insert_range(&txn->tw.relist, pgno, npages);
+    runs_invalidate(txn);
     tASSERT(txn, pnl_check_allocated(txn->tw.relist,
                                      txn->mt_next_pgno - MDBX_ENABLE_REFUND));
+    if (txn->mt_parent && likely(rc == MDBX_SUCCESS))
+      rc = shadowed_reclaimed_note(txn, pgno);
     tASSERT(txn, dirtylist_check(txn));
     return rc;
   }
@@ -4499,6 +5547,66 @@ __must_check_result static int iov_write(iov_ctx_t *ctx) {
   return ctx->err;
 }
 
+#if MDBX_ENABLE_ASYNC_SPILL
+static THREAD_RESULT THREAD_CALL spill_async_thread(void *arg) {
+  MDBX_env *const env = arg;
+  const osal_ioring_write_result_t r =
+      osal_ioring_write(&env->me_spill_async.ior);
+  env->me_spill_async.err = r.err;
+  env->me_spill_async.wops = r.wops;
+  return (THREAD_RESULT)0;
+}
+
+/* Hands the collected spilled pages over to an auxiliary thread for writing,
+ * or writes ones synchronously if the thread could not be started.
+ * The pages are released by spill_async_wait() after writing completion. */
+__must_check_result static int iov_write_async(iov_ctx_t *ctx) {
+  MDBX_env *const env = ctx->env;
+  eASSERT(env, !iov_empty(ctx) && !env->me_spill_async.active);
+  if (env->me_flags & MDBX_WRITEMAP)
+    return iov_write(ctx);
+
+  osal_ioring_t swap = env->me_spill_async.ior;
+  env->me_spill_async.ior = *ctx->ior;
+  *ctx->ior = swap;
+  ctx->err = osal_thread_create(&env->me_spill_async.thread,
+                                spill_async_thread, env);
+  if (likely(ctx->err == MDBX_SUCCESS)) {
+    env->me_spill_async.active = true;
+    if (!env->me_lck->mti_eoos_timestamp.weak)
+      env->me_lck->mti_eoos_timestamp.weak = osal_monotime();
+    return MDBX_SUCCESS;
+  }
+
+  WARNING("unable to start a thread for spilling (%d), write synchronously",
+          ctx->err);
+  swap = env->me_spill_async.ior;
+  env->me_spill_async.ior = *ctx->ior;
+  *ctx->ior = swap;
+  return iov_write(ctx);
+}
+
+__noinline static int spill_async_wait(MDBX_env *env) {
+  eASSERT(env, env->me_spill_async.active);
+  env->me_spill_async.active = false;
+  iov_ctx_t ctx;
+  ctx.env = env;
+  ctx.ior = &env->me_spill_async.ior;
+  ctx.coherency_timestamp = 0;
+  ctx.err = osal_thread_join(env->me_spill_async.thread);
+  if (likely(ctx.err == MDBX_SUCCESS)) {
+    ctx.err = env->me_spill_async.err;
+#if MDBX_ENABLE_PGOP_STAT
+    env->me_lck->mti_pgop_stat.wops.weak += env->me_spill_async.wops;
+#endif /* MDBX_ENABLE_PGOP_STAT */
+  }
+  if (unlikely(ctx.err != MDBX_SUCCESS))
+    ERROR("Write error: %s", mdbx_strerror(ctx.err));
+  iov_complete(&ctx);
+  return ctx.err;
+}
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
+
 __must_check_result static int iov_page(MDBX_txn *txn, iov_ctx_t *ctx,
                                         MDBX_page *dp, size_t npages) {
   MDBX_env *const env = txn->mt_env;
@@ -4558,6 +5666,7 @@ static int spill_page(MDBX_txn *txn, iov_ctx_t *ctx, MDBX_page *dp,
 #if MDBX_ENABLE_PGOP_STAT
   txn->mt_env->me_lck->mti_pgop_stat.spill.weak += npages;
 #endif /* MDBX_ENABLE_PGOP_STAT */
+  txn->tw.spill_npages += npages;
   const pgno_t pgno = dp->mp_pgno;
   int err = iov_page(txn, ctx, dp, npages);
   if (likely(err == MDBX_SUCCESS) &&
@@ -4576,9 +5685,8 @@ static size_t cursor_keep(MDBX_txn *txn, MDBX_cursor *mc) {
     for (size_t i = 0; i < mc->mc_snum; ++i) {
       const MDBX_page *mp = mc->mc_pg[i];
       if (IS_MODIFIABLE(txn, mp) && !IS_SUBP(mp)) {
-        size_t const n = dpl_search(txn, mp->mp_pgno);
-        if (txn->tw.dirtylist->items[n].pgno == mp->mp_pgno &&
-            dpl_age(txn, n)) {
+        size_t const n = dpl_exist(txn, mp->mp_pgno);
+        if (n && dpl_age(txn, n)) {
           txn->tw.dirtylist->items[n].lru = txn->tw.dirtylru;
           ++keep;
         }
@@ -4604,10 +5712,55 @@ static size_t txn_keep(MDBX_txn *txn, MDBX_cursor *m0) {
   return keep;
 }
 
+static __always_inline void spill_refs_mark(MDBX_dpl *dl, pgno_t pgno) {
+  const size_t bit = pgno & dl->refs_mask;
+  dl->refs[bit >> 6] |= UINT64_C(1) << (bit & 63);
+}
+
+/* Updates the heat of dirty pages by the reference bits, which are set by
+ * page_touch() since the previous spilling, and resets the bits. The heat is
+ * halved for all pages when the hot ones are occupied more than a half of the
+ * dirty list, so the rarely touched pages are cooled down and the room for
+ * the new pages is always available. Since the bits are addressed by the low
+ * bits of page number, a collision just warms up an extra page. */
+static void spill_refs_update(MDBX_txn *txn) {
+  MDBX_dpl *const dl = txn->tw.dirtylist;
+  if (!dl->refs) {
+    size_t bits = 64;
+    while (bits < txn->mt_env->me_options.dp_limit)
+      bits <<= 1;
+    /* just a lack of the information in case of failure */
+    dl->refs = osal_calloc(1, bits / 8);
+    dl->refs_mask = bits - 1;
+    return;
+  }
+
+  size_t hot = 0;
+  for (size_t i = 1; i <= dl->length; ++i) {
+    const size_t bit = dl->items[i].pgno & dl->refs_mask;
+    if (((dl->refs[bit >> 6] >> (bit & 63)) & 1) && dl->items[i].heat < 3)
+      dl->items[i].heat += 1;
+    hot += dl->items[i].heat > 0;
+  }
+  if (hot > dl->length / 2)
+    for (size_t i = 1; i <= dl->length; ++i)
+      dl->items[i].heat >>= 1;
+  memset(dl->refs, 0, (dl->refs_mask + 1) / 8);
+}
+
 /* Returns the spilling priority (0..255) for a dirty page:
  *      0 = should be spilled;
  *    ...
- *  > 255 = must not be spilled. */
+ *  > 255 = must not be spilled.
+ *
+ * With MDBX_SPILL_ADAPTIVE policy the hot pages, i.e. which were touched
+ * repeatedly or reloaded after spilling, are made look younger in proportion
+ * to the heat. Thus a stream of once-touched pages (e.g. by appending or by
+ * filling a new table) is spilled first and could not push out the working
+ * set, as with CLOCK-Pro or ARC. The branch pages are just become hot since
+ * touched by every update. Nonetheless the hot pages are still spillable,
+ * otherwise a transaction with mostly hot dirty pages would run into
+ * MDBX_TXN_FULL. */
 static unsigned spill_prio(const MDBX_txn *txn, const size_t i,
                            const uint32_t reciprocal) {
   MDBX_dpl *const dl = txn->tw.dirtylist;
@@ -4645,6 +5798,10 @@ static unsigned spill_prio(const MDBX_txn *txn, const size_t i,
   tASSERT(txn, age * (uint64_t)reciprocal < UINT32_MAX);
   unsigned prio = age * reciprocal >> 24;
   tASSERT(txn, prio < 256);
+  if (dl->items[i].heat &&
+      txn->mt_env->me_options.spill_policy == MDBX_SPILL_ADAPTIVE)
+    /* keeps a non-zero prio, i.e. the page remains spillable */
+    prio -= prio * dl->items[i].heat / 4;
   if (likely(npages == 1))
     return prio = 256 - prio;
 
@@ -4739,7 +5896,14 @@ __cold static int txn_spill_slowpath(MDBX_txn *const txn, MDBX_cursor *const m0,
   tASSERT(txn, (txn->mt_flags & MDBX_TXN_RDONLY) == 0);
   tASSERT(txn, (txn->mt_flags & MDBX_WRITEMAP) == 0 || MDBX_AVOID_MSYNC);
 
+  /* Only one batch of the spilled pages could be written at a time */
+#if MDBX_ENABLE_ASYNC_SPILL
+  int rc = spill_async_confirm(txn->mt_env);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+#else
   int rc = MDBX_SUCCESS;
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
   if (unlikely(txn->tw.dirtylist->length <= txn->tw.loose_count))
     goto done;
 
@@ -4844,6 +6008,9 @@ __cold static int txn_spill_slowpath(MDBX_txn *const txn, MDBX_cursor *const m0,
    *  - дополнительно при сортировке умышленно старим large/overflow страницы,
    *    тем самым повышая их шансы на выталкивание. */
 
+  if (txn->mt_env->me_options.spill_policy == MDBX_SPILL_ADAPTIVE)
+    spill_refs_update(txn);
+
   /* get min/max of LRU-labels */
   uint32_t age_max = 0;
   for (size_t i = 1; i <= dl->length; ++i) {
@@ -4975,7 +6142,11 @@ __cold static int txn_spill_slowpath(MDBX_txn *const txn, MDBX_cursor *const m0,
 
     if (!iov_empty(&ctx)) {
       tASSERT(txn, rc == MDBX_SUCCESS);
+#if MDBX_ENABLE_ASYNC_SPILL
+      rc = iov_write_async(&ctx);
+#else
       rc = iov_write(&ctx);
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
     }
     if (unlikely(rc != MDBX_SUCCESS))
       goto bailout;
@@ -5387,6 +6558,110 @@ __cold static void meta_troika_dump(const MDBX_env *env,
 
 /*----------------------------------------------------------------------------*/
 
+#if MDBX_64BIT_CAS
+static __always_inline MDBX_rgroup *rgroup(MDBX_lockinfo *const lck,
+                                           const MDBX_reader *const r) {
+  return lck->mti_rgroups + (r - lck->mti_readers) / MDBX_RGROUP_SIZE;
+}
+#endif /* MDBX_64BIT_CAS */
+
+/* Should be called by a reader after the mr_txnid was set for a just started
+ * transaction, to keep the lower bound of the reader's group. */
+static __always_inline void rgroup_enter(MDBX_lockinfo *const lck,
+                                         const MDBX_reader *const r,
+                                         const txnid_t txnid) {
+#if MDBX_64BIT_CAS
+  MDBX_rgroup *const g = rgroup(lck, r);
+  /* The barriers pair with ones in rgroup_rescan(): either the writer will
+   * see the mr_txnid, or the rg_changed, or this reader will see the raised
+   * rg_bound and lower it back. */
+  osal_memory_barrier();
+  atomic_store32(&g->rg_changed, true, mo_Relaxed);
+  osal_memory_barrier();
+  txnid_t bound = atomic_load64(&g->rg_bound, mo_AcquireRelease);
+  while (bound > txnid && !atomic_cas64(&g->rg_bound, bound, txnid))
+    bound = atomic_load64(&g->rg_bound, mo_AcquireRelease);
+#else
+  (void)lck;
+  (void)r;
+  (void)txnid;
+#endif /* MDBX_64BIT_CAS */
+}
+
+/* Should be called after the mr_txnid of an active reader was reset,
+ * since the lower bound of the reader's group may be raised now. */
+static __always_inline void rgroup_leave(MDBX_lockinfo *const lck,
+                                         const MDBX_reader *const r) {
+#if MDBX_64BIT_CAS
+  atomic_store32(&rgroup(lck, r)->rg_changed, true, mo_AcquireRelease);
+#else
+  (void)lck;
+  (void)r;
+#endif /* MDBX_64BIT_CAS */
+}
+
+/* Scans the given range of the reader table, kicks the stuck readers and
+ * returns the oldest txnid in use, or MAX_TXNID if there are no readers. */
+static txnid_t readers_scan(MDBX_lockinfo *const lck, const size_t begin,
+                            const size_t end, const size_t snap_nreaders,
+                            const txnid_t steady, const txnid_t prev_oldest) {
+  const uint32_t nothing_changed = MDBX_STRING_TETRAD("None");
+  txnid_t oldest = MAX_TXNID;
+  for (size_t i = begin; i < end; ++i) {
+    const uint32_t pid =
+        atomic_load32(&lck->mti_readers[i].mr_pid, mo_AcquireRelease);
+    if (!pid)
+      continue;
+    jitter4testing(true);
+
+    const txnid_t rtxn = safe64_read(&lck->mti_readers[i].mr_txnid);
+    if (unlikely(rtxn < prev_oldest)) {
+      if (unlikely(nothing_changed ==
+                   atomic_load32(&lck->mti_readers_refresh_flag,
+                                 mo_AcquireRelease)) &&
+          safe64_reset_compare(&lck->mti_readers[i].mr_txnid, rtxn)) {
+        NOTICE("kick stuck reader[%zu of %zu].pid_%u %" PRIaTXN
+               " < prev-oldest %" PRIaTXN ", steady-txn %" PRIaTXN,
+               i, snap_nreaders, pid, rtxn, prev_oldest, steady);
+      }
+      continue;
+    }
+
+    if (rtxn < oldest) {
+      oldest = rtxn;
+      if (!MDBX_DEBUG && !MDBX_FORCE_ASSERTIONS && oldest == prev_oldest)
+        break;
+    }
+  }
+  return oldest;
+}
+
+#if MDBX_64BIT_CAS
+/* Rescans the readers of the group and raises its lower bound if possible.
+ * Returns the oldest txnid in use by readers of the group. */
+static txnid_t rgroup_rescan(MDBX_lockinfo *const lck, MDBX_rgroup *const g,
+                             const size_t snap_nreaders, const txnid_t steady,
+                             const txnid_t prev_oldest) {
+  atomic_store32(&g->rg_changed, false, mo_Relaxed);
+  osal_memory_barrier();
+  const txnid_t bound = atomic_load64(&g->rg_bound, mo_AcquireRelease);
+  const size_t begin = (g - lck->mti_rgroups) * (size_t)MDBX_RGROUP_SIZE;
+  const size_t end = (begin + MDBX_RGROUP_SIZE < snap_nreaders)
+                         ? begin + MDBX_RGROUP_SIZE
+                         : snap_nreaders;
+  const txnid_t oldest = readers_scan(lck, begin, end, snap_nreaders, steady,
+                                      prev_oldest);
+  if (oldest > bound && atomic_cas64(&g->rg_bound, bound, oldest)) {
+    /* A reader which was missed by the scan above have set the rg_changed,
+     * but could not see the raised rg_bound, so lower it back. */
+    osal_memory_barrier();
+    if (atomic_load32(&g->rg_changed, mo_AcquireRelease))
+      atomic_cas64(&g->rg_bound, oldest, bound);
+  }
+  return oldest;
+}
+#endif /* MDBX_64BIT_CAS */
+
 /* Find oldest txnid still referenced. */
 static txnid_t find_oldest_reader(MDBX_env *const env, const txnid_t steady) {
   const uint32_t nothing_changed = MDBX_STRING_TETRAD("None");
@@ -5412,32 +6687,32 @@ static txnid_t find_oldest_reader(MDBX_env *const env, const txnid_t steady) {
         atomic_load32(&lck->mti_numreaders, mo_AcquireRelease);
     new_oldest = steady;
 
-    for (size_t i = 0; i < snap_nreaders; ++i) {
-      const uint32_t pid =
-          atomic_load32(&lck->mti_readers[i].mr_pid, mo_AcquireRelease);
-      if (!pid)
-        continue;
-      jitter4testing(true);
-
-      const txnid_t rtxn = safe64_read(&lck->mti_readers[i].mr_txnid);
-      if (unlikely(rtxn < prev_oldest)) {
-        if (unlikely(nothing_changed ==
-                     atomic_load32(&lck->mti_readers_refresh_flag,
-                                   mo_AcquireRelease)) &&
-            safe64_reset_compare(&lck->mti_readers[i].mr_txnid, rtxn)) {
-          NOTICE("kick stuck reader[%zu of %zu].pid_%u %" PRIaTXN
-                 " < prev-oldest %" PRIaTXN ", steady-txn %" PRIaTXN,
-                 i, snap_nreaders, pid, rtxn, prev_oldest, steady);
-        }
+#if MDBX_64BIT_CAS
+    /* Only the groups whose lower bound is below the current candidate are
+     * interesting. Such group is rescanned if it was changed since the last
+     * rescan, otherwise its lower bound is exact. */
+    const size_t snap_ngroups =
+        (snap_nreaders + MDBX_RGROUP_SIZE - 1) / MDBX_RGROUP_SIZE;
+    for (size_t i = 0; i < snap_ngroups; ++i) {
+      MDBX_rgroup *const g = lck->mti_rgroups + i;
+      txnid_t oldest = atomic_load64(&g->rg_bound, mo_AcquireRelease);
+      if (oldest >= new_oldest)
         continue;
-      }
-
-      if (rtxn < new_oldest) {
-        new_oldest = rtxn;
+      if (oldest < prev_oldest ||
+          atomic_load32(&g->rg_changed, mo_AcquireRelease))
+        oldest = rgroup_rescan(lck, g, snap_nreaders, steady, prev_oldest);
+      if (oldest < new_oldest) {
+        new_oldest = oldest;
         if (!MDBX_DEBUG && !MDBX_FORCE_ASSERTIONS && new_oldest == prev_oldest)
           break;
       }
     }
+#else
+    const txnid_t oldest = readers_scan(lck, 0, snap_nreaders, snap_nreaders,
+                                        steady, prev_oldest);
+    if (oldest < new_oldest)
+      new_oldest = oldest;
+#endif /* MDBX_64BIT_CAS */
   }
 
   if (new_oldest != prev_oldest) {
@@ -5508,10 +6783,13 @@ __hot static int __must_check_result page_dirty(MDBX_txn *txn, MDBX_page *mp,
       MDBX_page *loose = txn->tw.loose_pages;
       DEBUG("purge-and-reclaim loose page %" PRIaPGNO, loose->mp_pgno);
       rc = pnl_insert_range(&txn->tw.relist, loose->mp_pgno, 1);
+      runs_invalidate(txn);
+      if (txn->mt_parent && likely(rc == MDBX_SUCCESS))
+        rc = shadowed_reclaimed_note(txn, loose->mp_pgno);
       if (unlikely(rc != MDBX_SUCCESS))
         goto bailout;
-      size_t di = dpl_search(txn, loose->mp_pgno);
-      tASSERT(txn, txn->tw.dirtylist->items[di].ptr == loose);
+      size_t di = dpl_exist(txn, loose->mp_pgno);
+      tASSERT(txn, di && txn->tw.dirtylist->items[di].ptr == loose);
       dpl_remove(txn, di);
       txn->tw.loose_pages = loose->mp_next;
       txn->tw.loose_count--;
@@ -5851,6 +7129,12 @@ __cold static int map_resize(MDBX_env *env, const pgno_t used_pgno,
       goto bailout;
     }
 
+    /* The reader slots are claimed without locking (see bind_rslot()), so
+     * announce the remap before scanning, in order the threads which have
+     * claimed a slot concurrently either to be found or to back off. */
+    atomic_store32(&env->me_rslot_remap, true, mo_Relaxed);
+    osal_memory_barrier();
+
     /* looking for readers from this process */
     const size_t snap_nreaders =
         atomic_load32(&lck->mti_numreaders, mo_AcquireRelease);
@@ -5861,6 +7145,7 @@ __cold static int map_resize(MDBX_env *env, const pgno_t used_pgno,
           lck->mti_readers[i].mr_tid.weak != osal_thread_self()) {
         /* the base address of the mapping can't be changed since
          * the other reader thread from this process exists. */
+        atomic_store32(&env->me_rslot_remap, false, mo_AcquireRelease);
         osal_rdt_unlock(env);
         mresize_flags &= ~(MDBX_MRESIZE_MAY_UNMAP | MDBX_MRESIZE_MAY_MOVE);
         break;
@@ -6004,8 +7289,10 @@ bailout:
   }
 #else
   if (env->me_lck_mmap.lck &&
-      (mresize_flags & (MDBX_MRESIZE_MAY_UNMAP | MDBX_MRESIZE_MAY_MOVE)) != 0)
+      (mresize_flags & (MDBX_MRESIZE_MAY_UNMAP | MDBX_MRESIZE_MAY_MOVE)) != 0) {
+    atomic_store32(&env->me_rslot_remap, false, mo_AcquireRelease);
     osal_rdt_unlock(env);
+  }
   int err = osal_fastmutex_release(&env->me_remap_guard);
 #endif /* Windows */
   if (err != MDBX_SUCCESS) {
@@ -6214,33 +7501,6 @@ MDBX_MAYBE_UNUSED static __always_inline size_t __builtin_clzl(size_t value) {
 
 #if !MDBX_PNL_ASCENDING
 
-#if !defined(MDBX_ATTRIBUTE_TARGET) &&                                         \
-    (__has_attribute(__target__) || __GNUC_PREREQ(5, 0))
-#define MDBX_ATTRIBUTE_TARGET(target) __attribute__((__target__(target)))
-#endif /* MDBX_ATTRIBUTE_TARGET */
-
-#if defined(__SSE2__)
-#define MDBX_ATTRIBUTE_TARGET_SSE2 /* nope */
-#elif (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__amd64__)
-#define __SSE2__
-#define MDBX_ATTRIBUTE_TARGET_SSE2 /* nope */
-#elif defined(MDBX_ATTRIBUTE_TARGET) && defined(__ia32__)
-#define MDBX_ATTRIBUTE_TARGET_SSE2 MDBX_ATTRIBUTE_TARGET("sse2")
-#endif /* __SSE2__ */
-
-#if defined(__AVX2__)
-#define MDBX_ATTRIBUTE_TARGET_AVX2 /* nope */
-#elif defined(MDBX_ATTRIBUTE_TARGET) && defined(__ia32__)
-#define MDBX_ATTRIBUTE_TARGET_AVX2 MDBX_ATTRIBUTE_TARGET("avx2")
-#endif /* __AVX2__ */
-
-#if defined(__AVX512BW__)
-#define MDBX_ATTRIBUTE_TARGET_AVX512BW /* nope */
-#elif defined(MDBX_ATTRIBUTE_TARGET) && defined(__ia32__) &&                   \
-    (__GNUC_PREREQ(6, 0) || __CLANG_PREREQ(5, 0))
-#define MDBX_ATTRIBUTE_TARGET_AVX512BW MDBX_ATTRIBUTE_TARGET("avx512bw")
-#endif /* __AVX512BW__ */
-
 #ifdef MDBX_ATTRIBUTE_TARGET_SSE2
 MDBX_ATTRIBUTE_TARGET_SSE2 static __always_inline unsigned
 diffcmp2mask_sse2(const pgno_t *const ptr, const ptrdiff_t offset,
@@ -6574,6 +7834,193 @@ static pgno_t *scan4seq_resolver(pgno_t *range, const size_t len,
 }
 #endif /* scan4seq */
 
+/* The reclaimed list longer than the threshold is accompanied by the index of
+ * runs of pages, since a multi-page allocation failed to find a sequence by
+ * scanning. Thus repeated scans of a huge and fragmented list are avoided
+ * while reading GC records one by one in search of a sequence. */
+#define MDBX_RUNS_THRESHOLD 2048
+
+static __always_inline size_t runs_bucket(size_t npages) {
+  assert(npages > 1 && npages <= MAX_PAGENO);
+  const size_t log2 = 31 - __builtin_clz((uint32_t)npages);
+  return (log2 < 2) ? npages
+                    : ((log2 - 1) << 2) + ((npages >> (log2 - 2)) & 3);
+}
+
+static void runs_free(MDBX_runs *runs) {
+  if (runs) {
+    for (size_t n = 0; n < MDBX_RUNS_BUCKETS; ++n)
+      osal_free(runs->buckets[n].items);
+    osal_free(runs);
+  }
+}
+
+/* Returns the position of the first run within the bucket, which is not
+ * shorter than the given number of pages, since the runs are kept ordered by
+ * the length within a bucket. */
+static size_t runs_lower_bound(const MDBX_runs *runs, size_t n,
+                               size_t npages) {
+  size_t lo = 0, hi = runs->buckets[n].length;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) >> 1;
+    if (runs->buckets[n].items[mid].npages < npages)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static void runs_add(MDBX_runs *runs, pgno_t pgno, size_t npages) {
+  const size_t n = runs_bucket(npages);
+  if (unlikely(runs->buckets[n].length == runs->buckets[n].allocated)) {
+    const size_t wanna =
+        runs->buckets[n].allocated ? runs->buckets[n].allocated * 2 : 16;
+    void *ptr = osal_realloc(runs->buckets[n].items,
+                             wanna * sizeof(runs->buckets[n].items[0]));
+    if (unlikely(!ptr)) {
+      /* the index is just an accelerator, so drop it rather than fail */
+      runs->coherent = SIZE_MAX;
+      return;
+    }
+    runs->buckets[n].items = ptr;
+    runs->buckets[n].allocated = (uint32_t)wanna;
+  }
+  const size_t i = runs_lower_bound(runs, n, npages);
+  memmove(&runs->buckets[n].items[i + 1], &runs->buckets[n].items[i],
+          (runs->buckets[n].length - i) * sizeof(runs->buckets[n].items[0]));
+  runs->buckets[n].items[i].pgno = pgno;
+  runs->buckets[n].items[i].npages = (pgno_t)npages;
+  runs->buckets[n].length += 1;
+  runs->count += 1;
+}
+
+static void runs_remove(MDBX_runs *runs, size_t n, size_t i) {
+  assert(i < runs->buckets[n].length && runs->count > 0);
+  runs->buckets[n].length -= 1;
+  memmove(&runs->buckets[n].items[i], &runs->buckets[n].items[i + 1],
+          (runs->buckets[n].length - i) * sizeof(runs->buckets[n].items[0]));
+  runs->count -= 1;
+}
+
+/* Adds all runs within the given positions of a sorted PNL. */
+static void runs_collect(MDBX_runs *runs, const MDBX_PNL pnl, size_t begin,
+                         const size_t end) {
+  const pgno_t step = MDBX_PNL_ASCENDING ? 1 : (pgno_t)-1;
+  while (begin < end) {
+    size_t last = begin;
+    while (last < end && pnl[last + 1] == pnl[last] + step)
+      ++last;
+    if (last > begin)
+      runs_add(runs, MDBX_PNL_ASCENDING ? pnl[begin] : pnl[last],
+               last - begin + 1);
+    begin = last + 1;
+  }
+}
+
+/* Adds all runs which are remained within the span of pages. */
+static void runs_rescan(MDBX_runs *runs, const MDBX_PNL pnl, pgno_t pgno,
+                        size_t npages) {
+  const size_t begin = pnl_search_nochk(
+      pnl, MDBX_PNL_ASCENDING ? pgno : pgno + (pgno_t)npages - 1);
+  const size_t end = pnl_search_nochk(
+      pnl, MDBX_PNL_ASCENDING ? pgno + (pgno_t)npages : pgno - 1);
+  if (end > begin + 1)
+    runs_collect(runs, pnl, begin, end - 1);
+}
+
+static void runs_build(MDBX_txn *txn) {
+  MDBX_runs *runs = txn->tw.relist_runs;
+  if (!runs) {
+    runs = osal_calloc(1, sizeof(MDBX_runs));
+    if (unlikely(!runs))
+      return;
+    txn->tw.relist_runs = runs;
+  }
+  runs->count = 0;
+  for (size_t n = 0; n < MDBX_RUNS_BUCKETS; ++n)
+    runs->buckets[n].length = 0;
+  runs->coherent = MDBX_PNL_GETSIZE(txn->tw.relist);
+  runs_collect(runs, txn->tw.relist, 1, MDBX_PNL_GETSIZE(txn->tw.relist));
+}
+
+/* Updates the index after the GC-record was merged into the relist. */
+static void runs_merged(MDBX_txn *txn, const MDBX_PNL gc_pnl) {
+  MDBX_runs *const runs = txn->tw.relist_runs;
+  const MDBX_PNL pnl = txn->tw.relist;
+  const size_t len = MDBX_PNL_GETSIZE(pnl);
+  if (runs->count > len) {
+    /* too many stale entries */
+    runs_build(txn);
+    return;
+  }
+  runs->coherent = len;
+  pgno_t lo = 1, hi = 0;
+  for (size_t i = 1; i <= MDBX_PNL_GETSIZE(gc_pnl); ++i) {
+    const pgno_t pgno = gc_pnl[i];
+    if (pgno >= lo && pgno <= hi)
+      continue;
+    size_t first = pnl_search_nochk(pnl, pgno), last = first;
+    assert(first <= len && pnl[first] == pgno);
+    const pgno_t step = MDBX_PNL_ASCENDING ? 1 : (pgno_t)-1;
+    while (first > 1 && pnl[first - 1] + step == pnl[first])
+      --first;
+    while (last < len && pnl[last + 1] == pnl[last] + step)
+      ++last;
+    lo = MDBX_PNL_ASCENDING ? pnl[first] : pnl[last];
+    hi = MDBX_PNL_ASCENDING ? pnl[last] : pnl[first];
+    if (last > first)
+      runs_add(runs, lo, last - first + 1);
+  }
+}
+
+/* Returns the position of the lowest of the given number of pages in the
+ * relist, or nullptr if these pages are not free anymore. */
+static pgno_t *runs_check(const MDBX_PNL pnl, pgno_t pgno, size_t num) {
+  const size_t i = pnl_search_nochk(pnl, pgno);
+  if (i > MDBX_PNL_GETSIZE(pnl) || pnl[i] != pgno)
+    return nullptr;
+#if MDBX_PNL_ASCENDING
+  if (i + num - 1 > MDBX_PNL_GETSIZE(pnl) ||
+      pnl[i + num - 1] != pgno + num - 1)
+    return nullptr;
+#else
+  if (i < num || pnl[i - num + 1] != pgno + num - 1)
+    return nullptr;
+#endif /* MDBX_PNL sort-order */
+  return pnl + i;
+}
+
+/* Finds a sequence of pages in the relist by the index of runs, i.e. the
+ * best-fit run, which is the shortest suitable one from the bucket of
+ * requested size or from the nearest larger non-empty bucket. */
+static pgno_t *runs_find(MDBX_runs *runs, const MDBX_PNL pnl, size_t num) {
+  const size_t want = runs_bucket(num);
+  while (true) {
+    size_t n = want, i = runs_lower_bound(runs, n, num);
+    if (i == runs->buckets[n].length) {
+      do {
+        if (++n == MDBX_RUNS_BUCKETS)
+          return nullptr;
+      } while (!runs->buckets[n].length);
+      assert(n > want && runs->buckets[n].length > 0);
+      i = 0;
+    }
+
+    const pgno_t pgno = runs->buckets[n].items[i].pgno;
+    const size_t npages = runs->buckets[n].items[i].npages;
+    runs_remove(runs, n, i);
+    pgno_t *const range = runs_check(pnl, pgno, num);
+    if (likely(range)) {
+      if (npages > num + 1)
+        runs_add(runs, pgno + (pgno_t)num, npages - num);
+      return range;
+    }
+    /* the entry is stale, so re-index the pages which still remain */
+    runs_rescan(runs, pnl, pgno, npages);
+  }
+}
+
 //------------------------------------------------------------------------------
 
 /* Allocate page numbers and memory for writing.  Maintain mt_last_reclaimed,
@@ -6598,6 +8045,65 @@ static pgno_t *scan4seq_resolver(pgno_t *range, const size_t len,
 #define MDBX_ALLOC_COALESCE 4    /* внутреннее состояние */
 #define MDBX_ALLOC_SHOULD_SCAN 8 /* внутреннее состояние */
 #define MDBX_ALLOC_LIFO 16       /* внутреннее состояние */
+#define MDBX_ALLOC_GAPS 32       /* внутреннее состояние */
+
+/* Finds a sequence of pages in the relist, either by scanning or by the index
+ * of runs if one is coherent with the relist. */
+static pgno_t *relist_seek(MDBX_txn *txn, const size_t num, uint8_t flags) {
+  const size_t len = MDBX_PNL_GETSIZE(txn->tw.relist);
+  MDBX_runs *const runs = txn->tw.relist_runs;
+  if (runs && runs->coherent == len && !(flags & MDBX_ALLOC_RESERVE)) {
+    pgno_t *const range = runs_find(runs, txn->tw.relist, num);
+    eASSERT(txn->mt_env,
+            !range || range == runs_check(txn->tw.relist, *range, num));
+    return range;
+  }
+  pgno_t *range = txn->tw.relist + (MDBX_PNL_ASCENDING ? 1 : len);
+  range = scan4seq(range, len, num - 1);
+  eASSERT(txn->mt_env, range == scan4range_checker(txn->tw.relist, num - 1));
+  return range;
+}
+
+/* The maximal number of items at the tail of the relist, among which a page
+ * is chosen near to the cursor's one, i.e. the limit of items to be shifted
+ * while cutting the chosen page off from the middle of the relist. */
+#define MDBX_ALLOC_LOCALITY_WINDOW 1024
+
+/* Chooses a single page from the relist to be used for the cursor. Returns
+ * a position of the page which is nearest to the left sibling of the page the
+ * cursor is working on, so the siblings are kept closer in the file. Otherwise,
+ * i.e. for the GC itself which is updating from the relist or for relocating
+ * pages by mdbx_env_defrag(), returns a position of the lowest page. */
+static __always_inline pgno_t *relist_nearby(const MDBX_cursor *mc,
+                                             const MDBX_PNL pnl) {
+  const size_t len = MDBX_PNL_GETSIZE(pnl);
+  pgno_t *const lowest = pnl + (MDBX_PNL_ASCENDING ? 1 : len);
+#if MDBX_ENABLE_ALLOC_LOCALITY && !MDBX_PNL_ASCENDING
+  if (len > 1 && mc->mc_snum && mc->mc_dbi != FREE_DBI &&
+      !(mc->mc_flags & C_DEFRAG)) {
+    /* prefer the page right after the left sibling */
+    pgno_t hint = mc->mc_pg[mc->mc_top]->mp_pgno;
+    if (mc->mc_top) {
+      const MDBX_page *const parent = mc->mc_pg[mc->mc_top - 1];
+      const size_t ki = mc->mc_ki[mc->mc_top - 1];
+      if (ki > 0 && ki <= page_numkeys(parent))
+        hint = node_pgno(page_node(parent, ki - 1)) + 1;
+    }
+    const size_t window = (len < MDBX_ALLOC_LOCALITY_WINDOW)
+                              ? len
+                              : MDBX_ALLOC_LOCALITY_WINDOW;
+    pgno_t *const begin = lowest - window + 1;
+    const size_t n = pgno_bsearch(begin, window, hint) - begin;
+    if (n == window)
+      return lowest;
+    pgno_t *const it = begin + n;
+    return (n && it[-1] - hint < hint - it[0]) ? it - 1 : it;
+  }
+#else
+  (void)mc;
+#endif /* MDBX_ENABLE_ALLOC_LOCALITY */
+  return lowest;
+}
 
 static __inline bool is_gc_usable(MDBX_txn *txn, const MDBX_cursor *mc,
                                   const uint8_t flags) {
@@ -6615,32 +8121,222 @@ static __inline bool is_gc_usable(MDBX_txn *txn, const MDBX_cursor *mc,
   return true;
 }
 
+#if MDBX_ENABLE_GC_GAPS
+static bool is_gap_reclaimed(const MDBX_txn *txn, txnid_t id) {
+  /* The nested txns don't reclaim between snapshots, but should skip
+   * the records which were reclaimed such way by ancestors. */
+  for (; txn; txn = txn->mt_parent)
+    if (txn->tw.gap_reclaimed) {
+      const size_t len = MDBX_PNL_GETSIZE(txn->tw.gap_reclaimed);
+      for (size_t i = 1; i <= len; ++i)
+        if (txn->tw.gap_reclaimed[i] == id)
+          return true;
+    }
+  return false;
+}
+#endif /* MDBX_ENABLE_GC_GAPS */
+
 __hot static bool is_already_reclaimed(const MDBX_txn *txn, txnid_t id) {
   const size_t len = MDBX_PNL_GETSIZE(txn->tw.lifo_reclaimed);
   for (size_t i = 1; i <= len; ++i)
     if (txn->tw.lifo_reclaimed[i] == id)
       return true;
+#if MDBX_ENABLE_GC_GAPS
+  return is_gap_reclaimed(txn, id);
+#else
   return false;
+#endif /* MDBX_ENABLE_GC_GAPS */
+}
+
+#if MDBX_ENABLE_GC_GAPS
+/* Pages of a GC record are visible only by snapshots which are not older
+ * than the least birth of ones and older than the record itself. Thus
+ * the record could be reclaimed even above the oldest reader, if there is
+ * no live snapshot within such interval.
+ *
+ * The births are tracked only for records put by this process, since
+ * the GC records don't store one. Snapshots are the readers' txnids
+ * and the last steady meta, like for find_oldest_reader(). A reader which
+ * starts after the scan gets the recent meta, i.e. is newer than any
+ * record, otherwise it will retry on the meta change. */
+
+/* Forgets the births of records which are reachable by the regular
+ * reclaiming and collects the txnids of live snapshots in the descending
+ * order. Returns false if there are no candidates to reclaim. */
+static bool gc_gaps_prepare(MDBX_txn *txn, const txnid_t oldest) {
+  MDBX_env *const env = txn->mt_env;
+  MDBX_gc_birth *const items = env->me_gc_births.items;
+  size_t n = env->me_gc_births.length, i = 0;
+  while (i < n && items[i].id <= oldest)
+    ++i;
+  if (i) {
+    memmove(items, items + i, (n - i) * sizeof(MDBX_gc_birth));
+    env->me_gc_births.length = n -= i;
+  }
+
+  bool candidates = false;
+  for (i = 0; i < n && !candidates; ++i)
+    candidates = items[i].birth > oldest;
+  MDBX_lockinfo *const lck = env->me_lck_mmap.lck;
+  if (!candidates || unlikely(lck == NULL /* exclusive without-lck mode */))
+    return false;
+
+  if (unlikely(!txn->tw.gap_reclaimed) &&
+      unlikely(!(txn->tw.gap_reclaimed = txl_alloc())))
+    return false;
+  if (unlikely(!env->me_gc_births.snapshots) &&
+      unlikely(!(env->me_gc_births.snapshots = txl_alloc())))
+    return false;
+
+  MDBX_PNL_SETSIZE(env->me_gc_births.snapshots, 0);
+  if (unlikely(txl_append(&env->me_gc_births.snapshots,
+                          txn->tw.troika.txnid[txn->tw.troika.prefer_steady]) !=
+               MDBX_SUCCESS))
+    return false;
+  const size_t snap_nreaders =
+      atomic_load32(&lck->mti_numreaders, mo_AcquireRelease);
+  for (i = 0; i < snap_nreaders; ++i) {
+    if (!atomic_load32(&lck->mti_readers[i].mr_pid, mo_AcquireRelease))
+      continue;
+    const txnid_t rtxn = safe64_read(&lck->mti_readers[i].mr_txnid);
+    if (rtxn < txn->mt_txnid &&
+        unlikely(txl_append(&env->me_gc_births.snapshots, rtxn) !=
+                 MDBX_SUCCESS))
+      return false;
+  }
+  /* many readers may share the same snapshot */
+  txl_sort_unique(env->me_gc_births.snapshots);
+  return true;
+}
+
+/* Returns the key of next GC record after the given one, which isn't
+ * visible by any of collected snapshots, or zero if there are no such. */
+static txnid_t gc_gaps_next(const MDBX_txn *txn, const txnid_t after) {
+  const MDBX_env *const env = txn->mt_env;
+  const MDBX_TXL snapshots = env->me_gc_births.snapshots;
+  size_t newer = MDBX_PNL_GETSIZE(snapshots);
+  for (size_t i = 0; i < env->me_gc_births.length; ++i) {
+    const MDBX_gc_birth *const item = env->me_gc_births.items + i;
+    /* Find the most recent snapshot older than the record */
+    while (newer && snapshots[newer] < item->id)
+      --newer;
+    if (item->id > after &&
+        (newer == MDBX_PNL_GETSIZE(snapshots) ||
+         snapshots[newer + 1] < item->birth) &&
+        !is_gap_reclaimed(txn, item->id))
+      return item->id;
+  }
+  return 0;
+}
+
+/* Updates the births after a successful commit, i.e. forgets the records
+ * which were reclaimed and notes the ones which were put by the txn. */
+static void gc_gaps_commit(MDBX_txn *txn, const txnid_t commit_txnid) {
+  MDBX_env *const env = txn->mt_env;
+  MDBX_gc_birth *items = env->me_gc_births.items;
+  size_t n = env->me_gc_births.length;
+  if (txn->tw.gap_reclaimed && MDBX_PNL_GETSIZE(txn->tw.gap_reclaimed)) {
+    size_t w = 0;
+    for (size_t r = 0; r < n; ++r)
+      if (!is_gap_reclaimed(txn, items[r].id))
+        items[w++] = items[r];
+    env->me_gc_births.length = n = w;
+  }
+
+  const txnid_t birth = txn->tw.retired_birth;
+  if (MDBX_PNL_GETSIZE(txn->tw.retired_pages) == 0 || birth == 0)
+    return;
+  eASSERT(env, n == 0 || items[n - 1].id < txn->mt_txnid);
+  const size_t wanna = n + (size_t)(commit_txnid - txn->mt_txnid) + 1;
+  if (wanna > env->me_gc_births.allocated) {
+    const size_t allocated = (wanna > 42) ? wanna + wanna / 2 : 64;
+    items = osal_realloc(items, allocated * sizeof(MDBX_gc_birth));
+    if (unlikely(!items))
+      return /* the births are just a hint */;
+    env->me_gc_births.items = items;
+    env->me_gc_births.allocated = allocated;
+  }
+  for (txnid_t id = txn->mt_txnid; id <= commit_txnid; ++id) {
+    items[n].id = id;
+    items[n].birth = birth;
+    ++n;
+  }
+  env->me_gc_births.length = n;
+}
+#endif /* MDBX_ENABLE_GC_GAPS */
+
+static void gc_prefetch_drop(MDBX_env *env) {
+  pnl_free(env->me_gc_prefetch.relist);
+  txl_free(env->me_gc_prefetch.ids);
+  memset(&env->me_gc_prefetch, 0, sizeof(env->me_gc_prefetch));
+}
+
+/* Takes over the GC records prefetched by mdbx_env_gc_prefetch() from the
+ * same snapshot, as if ones were reclaimed by this txn. */
+static int gc_prefetch_adopt(MDBX_txn *txn) {
+  MDBX_env *const env = txn->mt_env;
+  const MDBX_TXL ids = env->me_gc_prefetch.ids;
+  const MDBX_PNL relist = env->me_gc_prefetch.relist;
+  tASSERT(txn, !txn->mt_parent && txn->tw.last_reclaimed == 0 &&
+                   MDBX_PNL_GETSIZE(ids) > 0 &&
+                   pnl_check(relist, txn->mt_next_pgno));
+
+  int err = pnl_need(&txn->tw.relist, MDBX_PNL_GETSIZE(relist));
+  if (unlikely(err != MDBX_SUCCESS))
+    return err;
+  if (env->me_gc_prefetch.lifo) {
+    if (!txn->tw.lifo_reclaimed &&
+        unlikely(!(txn->tw.lifo_reclaimed = txl_alloc())))
+      return MDBX_ENOMEM;
+    err = txl_need(&txn->tw.lifo_reclaimed, MDBX_PNL_GETSIZE(ids));
+    if (unlikely(err != MDBX_SUCCESS))
+      return err;
+    for (size_t i = 1; i <= MDBX_PNL_GETSIZE(ids); ++i)
+      txl_xappend(txn->tw.lifo_reclaimed, ids[i]);
+  }
+  txn->tw.last_reclaimed = MDBX_PNL_LAST(ids);
+  TRACE("adopt %zu prefetched GC records, last id #%" PRIaTXN ", len %zu",
+        MDBX_PNL_GETSIZE(ids), txn->tw.last_reclaimed,
+        MDBX_PNL_GETSIZE(relist));
+
+  pnl_merge(txn->tw.relist, relist);
+  runs_invalidate(txn);
+  gc_prefetch_drop(env);
+  eASSERT(env, pnl_check_allocated(txn->tw.relist, txn->mt_next_pgno));
+  if (MDBX_ENABLE_REFUND &&
+      unlikely(MDBX_PNL_MOST(txn->tw.relist) == txn->mt_next_pgno - 1))
+    txn_refund(txn);
+  return MDBX_SUCCESS;
+}
+
+#if MDBX_ENABLE_PROFGC
+/* Returns the GC profiling counters to be updated by the given cursor,
+ * or NULL if the profiling is not enabled by MDBX_opt_gc_profiling. */
+static __always_inline profgc_stat_t *profgc(const MDBX_cursor *mc) {
+  MDBX_env *const env = mc->mc_txn->mt_env;
+  if (likely(!env->me_options.gc_profiling))
+    return nullptr;
+  return (mc->mc_dbi == FREE_DBI) ? &env->me_lck->mti_pgop_stat.gc_prof.self
+                                  : &env->me_lck->mti_pgop_stat.gc_prof.work;
 }
+#endif /* MDBX_ENABLE_PROFGC */
 
 static pgr_t page_alloc_slowpath(const MDBX_cursor *mc, const size_t num,
                                  uint8_t flags) {
 #if MDBX_ENABLE_PROFGC
-  const uint64_t monotime_before = osal_monotime();
-  size_t majflt_before;
-  const uint64_t cputime_before = osal_cputime(&majflt_before);
-  uint64_t monotime_shot = 0;
+  profgc_stat_t *const prof = profgc(mc);
+  uint64_t monotime_before = 0, cputime_before = 0, monotime_shot = 0;
+  size_t majflt_before = 0;
+  if (unlikely(prof)) {
+    monotime_before = osal_monotime();
+    cputime_before = osal_cputime(&majflt_before);
+    prof->spe_counter += 1;
+  }
 #endif /* MDBX_ENABLE_PROFGC */
 
   pgr_t ret;
   MDBX_txn *const txn = mc->mc_txn;
   MDBX_env *const env = txn->mt_env;
-#if MDBX_ENABLE_PROFGC
-  profgc_stat_t *const prof = (mc->mc_dbi == FREE_DBI)
-                                  ? &env->me_lck->mti_pgop_stat.gc_prof.self
-                                  : &env->me_lck->mti_pgop_stat.gc_prof.work;
-  prof->spe_counter += 1;
-#endif /* MDBX_ENABLE_PROFGC */
 
   eASSERT(env, num > 0 || (flags & MDBX_ALLOC_RESERVE));
   eASSERT(env, pnl_check_allocated(txn->tw.relist,
@@ -6650,14 +8346,13 @@ static pgr_t page_alloc_slowpath(const MDBX_cursor *mc, const size_t num,
   size_t newnext, re_len = MDBX_PNL_GETSIZE(txn->tw.relist);
   if (num > 1) {
 #if MDBX_ENABLE_PROFGC
-    prof->xpages += 1;
+    if (unlikely(prof))
+      prof->xpages += 1;
 #endif /* MDBX_ENABLE_PROFGC */
     if (re_len >= num) {
       eASSERT(env, MDBX_PNL_LAST(txn->tw.relist) < txn->mt_next_pgno &&
                        MDBX_PNL_FIRST(txn->tw.relist) < txn->mt_next_pgno);
-      range = txn->tw.relist + (MDBX_PNL_ASCENDING ? 1 : re_len);
-      range = scan4seq(range, re_len, num - 1);
-      eASSERT(env, range == scan4range_checker(txn->tw.relist, num - 1));
+      range = relist_seek(txn, num, flags);
       if (likely(range)) {
         pgno = *range;
         goto done;
@@ -6693,6 +8388,7 @@ static pgr_t page_alloc_slowpath(const MDBX_cursor *mc, const size_t num,
 retry_gc_refresh_oldest:;
   txnid_t oldest = txn_oldest_reader(txn);
 retry_gc_have_oldest:
+  flags &= ~MDBX_ALLOC_GAPS;
   if (unlikely(oldest >= txn->mt_txnid)) {
     ERROR("unexpected/invalid oldest-readed txnid %" PRIaTXN
           " for current-txnid %" PRIaTXN,
@@ -6702,6 +8398,19 @@ retry_gc_have_oldest:
   }
   const txnid_t detent = oldest + 1;
 
+  if (unlikely(env->me_gc_prefetch.ids) && !txn->mt_parent &&
+      (flags & MDBX_ALLOC_RESERVE) == 0 && mc->mc_dbi != FREE_DBI &&
+      txn->tw.last_reclaimed == 0) {
+    eASSERT(env, env->me_gc_prefetch.txnid + xMDBX_TXNID_STEP ==
+                         txn->mt_txnid &&
+                     MDBX_PNL_LAST(env->me_gc_prefetch.ids) < detent);
+    ret.err = gc_prefetch_adopt(txn);
+    if (unlikely(ret.err != MDBX_SUCCESS))
+      goto fail;
+    re_len = MDBX_PNL_GETSIZE(txn->tw.relist);
+    flags |= MDBX_ALLOC_SHOULD_SCAN;
+  }
+
   txnid_t id = 0;
   MDBX_cursor_op op = MDBX_FIRST;
   if (flags & MDBX_ALLOC_LIFO) {
@@ -6723,13 +8432,28 @@ retry_gc_have_oldest:
     op = MDBX_SET_RANGE;
   }
 
+  if (flags & MDBX_ALLOC_SHOULD_SCAN) {
+    /* Scan the prefetched pages before reading the next GC record */
+    ret.err = MDBX_SUCCESS;
+    goto scan;
+  }
+
 next_gc:;
+#if MDBX_ENABLE_GC_GAPS
+  if (flags & MDBX_ALLOC_GAPS) {
+    id = gc_gaps_next(txn, id);
+    if (!id)
+      goto depleted_gc;
+    op = MDBX_SET;
+  }
+#endif /* MDBX_ENABLE_GC_GAPS */
   MDBX_val key;
   key.iov_base = &id;
   key.iov_len = sizeof(id);
 
 #if MDBX_ENABLE_PROFGC
-  prof->rsteps += 1;
+  if (unlikely(prof))
+    prof->rsteps += 1;
 #endif /* MDBX_ENABLE_PROFGC */
 
   /* Seek first/next GC record */
@@ -6741,6 +8465,8 @@ next_gc:;
       op = MDBX_PREV;
       goto next_gc;
     }
+    if (flags & MDBX_ALLOC_GAPS)
+      goto next_gc;
     goto depleted_gc;
   }
   if (unlikely(key.iov_len != sizeof(txnid_t))) {
@@ -6748,7 +8474,9 @@ next_gc:;
     goto fail;
   }
   id = unaligned_peek_u64(4, key.iov_base);
-  if (flags & MDBX_ALLOC_LIFO) {
+  if (flags & MDBX_ALLOC_GAPS) {
+    eASSERT(env, op == MDBX_SET && id >= detent);
+  } else if (flags & MDBX_ALLOC_LIFO) {
     op = MDBX_PREV;
     if (id >= detent || is_already_reclaimed(txn, id))
       goto next_gc;
@@ -6756,6 +8484,10 @@ next_gc:;
     op = MDBX_NEXT;
     if (unlikely(id >= detent))
       goto depleted_gc;
+#if MDBX_ENABLE_GC_GAPS
+    if (unlikely(is_gap_reclaimed(txn, id)))
+      goto next_gc;
+#endif /* MDBX_ENABLE_GC_GAPS */
   }
 
   /* Reading next GC record */
@@ -6766,14 +8498,22 @@ next_gc:;
     goto fail;
 
   pgno_t *gc_pnl = (pgno_t *)data.iov_base;
+  const size_t gc_words =
+      (gc_pnl[0] & MDBX_GC_EXTENT) ? gc_pnl[0] - MDBX_GC_EXTENT : 0;
   if (unlikely(data.iov_len % sizeof(pgno_t) ||
-               data.iov_len < MDBX_PNL_SIZEOF(gc_pnl) ||
-               !pnl_check(gc_pnl, txn->mt_next_pgno))) {
+               data.iov_len < (gc_words ? (gc_words + 1) * sizeof(pgno_t)
+                                        : MDBX_PNL_SIZEOF(gc_pnl)) ||
+               (!gc_words && !pnl_check(gc_pnl, txn->mt_next_pgno)))) {
     ret.err = MDBX_CORRUPTED;
     goto fail;
   }
 
-  const size_t gc_len = MDBX_PNL_GETSIZE(gc_pnl);
+  const size_t gc_len = gc_words ? gc_extents_count(gc_pnl + 1, gc_words)
+                                 : MDBX_PNL_GETSIZE(gc_pnl);
+  if (unlikely(gc_words && !gc_len)) {
+    ret.err = MDBX_CORRUPTED;
+    goto fail;
+  }
   TRACE("gc-read: id #%" PRIaTXN " len %zu, re-list will %zu ", id, gc_len,
         gc_len + re_len);
 
@@ -6784,18 +8524,19 @@ next_gc:;
       eASSERT(env, flags & MDBX_ALLOC_COALESCE);
       eASSERT(env, num > 0);
 #if MDBX_ENABLE_PROFGC
-      env->me_lck->mti_pgop_stat.gc_prof.coalescences += 1;
+      if (unlikely(prof))
+        env->me_lck->mti_pgop_stat.gc_prof.coalescences += 1;
 #endif /* MDBX_ENABLE_PROFGC */
       TRACE("clear %s %s", "MDBX_ALLOC_COALESCE", "since got threshold");
       if (re_len >= num) {
         eASSERT(env, MDBX_PNL_LAST(txn->tw.relist) < txn->mt_next_pgno &&
                          MDBX_PNL_FIRST(txn->tw.relist) < txn->mt_next_pgno);
-        range = txn->tw.relist + (MDBX_PNL_ASCENDING ? 1 : re_len);
-        pgno = *range;
-        if (num == 1)
+        if (num == 1) {
+          range = relist_nearby(mc, txn->tw.relist);
+          pgno = *range;
           goto done;
-        range = scan4seq(range, re_len, num - 1);
-        eASSERT(env, range == scan4range_checker(txn->tw.relist, num - 1));
+        }
+        range = relist_seek(txn, num, flags);
         if (likely(range)) {
           pgno = *range;
           goto done;
@@ -6822,18 +8563,38 @@ next_gc:;
   }
 
   /* Remember ID of readed GC record */
-  txn->tw.last_reclaimed = id;
-  if (flags & MDBX_ALLOC_LIFO) {
-    ret.err = txl_append(&txn->tw.lifo_reclaimed, id);
+  if (flags & MDBX_ALLOC_GAPS) {
+#if MDBX_ENABLE_GC_GAPS
+    ret.err = txl_append(&txn->tw.gap_reclaimed, id);
     if (unlikely(ret.err != MDBX_SUCCESS))
       goto fail;
+#endif /* MDBX_ENABLE_GC_GAPS */
+  } else {
+    txn->tw.last_reclaimed = id;
+    if (flags & MDBX_ALLOC_LIFO) {
+      ret.err = txl_append(&txn->tw.lifo_reclaimed, id);
+      if (unlikely(ret.err != MDBX_SUCCESS))
+        goto fail;
+    }
   }
 
   /* Append PNL from GC record to tw.relist */
-  ret.err = pnl_need(&txn->tw.relist, gc_len);
+  ret.err = pnl_need(&txn->tw.relist, gc_words ? 2 * gc_len + 2 : gc_len);
   if (unlikely(ret.err != MDBX_SUCCESS))
     goto fail;
 
+  if (gc_words) {
+    /* Expand the extent-encoded record into a temp PNL at the tail */
+    gc_pnl = txn->tw.relist + MDBX_PNL_ALLOCLEN(txn->tw.relist) - gc_len - 1;
+    gc_extents_expand((pgno_t *)data.iov_base + 1, gc_words,
+                      MDBX_PNL_BEGIN(gc_pnl));
+    MDBX_PNL_SETSIZE(gc_pnl, gc_len);
+    if (unlikely(!pnl_check(gc_pnl, txn->mt_next_pgno))) {
+      ret.err = MDBX_CORRUPTED;
+      goto fail;
+    }
+  }
+
   if (LOG_ENABLED(MDBX_LOG_EXTRA)) {
     DEBUG_EXTRA("readed GC-pnl txn %" PRIaTXN " root %" PRIaPGNO
                 " len %zu, PNL",
@@ -6843,8 +8604,26 @@ next_gc:;
     DEBUG_EXTRA_PRINT(", next_pgno %u\n", txn->mt_next_pgno);
   }
 
+  /* Note the pages which are dirty in ancestors for txn_merge_incremental() */
+  if (txn->mt_parent && shadowed_reclaimed_tracked(txn)) {
+    for (size_t i = gc_len; i; i--) {
+      ret.err = shadowed_reclaimed_note(txn, gc_pnl[i]);
+      if (unlikely(ret.err != MDBX_SUCCESS))
+        goto fail;
+    }
+  }
+
   /* Merge in descending sorted order */
-  re_len = pnl_merge(txn->tw.relist, gc_pnl);
+  if (txn->tw.relist_runs &&
+      txn->tw.relist_runs->coherent == MDBX_PNL_GETSIZE(txn->tw.relist)) {
+    re_len = pnl_merge(txn->tw.relist, gc_pnl);
+    runs_merged(txn, gc_pnl);
+  } else {
+    re_len = pnl_merge(txn->tw.relist, gc_pnl);
+    if (num > 1 && !(flags & MDBX_ALLOC_RESERVE) &&
+        re_len >= MDBX_RUNS_THRESHOLD)
+      runs_build(txn);
+  }
   flags |= MDBX_ALLOC_SHOULD_SCAN;
   if (AUDIT_ENABLED()) {
     if (unlikely(!pnl_check(txn->tw.relist, txn->mt_next_pgno))) {
@@ -6878,7 +8657,7 @@ next_gc:;
 
   /* TODO: delete reclaimed records */
 
-  eASSERT(env, op == MDBX_PREV || op == MDBX_NEXT);
+  eASSERT(env, op == MDBX_PREV || op == MDBX_NEXT || op == MDBX_SET);
   if (flags & MDBX_ALLOC_COALESCE) {
     TRACE("%s: last id #%" PRIaTXN ", re-len %zu", "coalesce-continue", id,
           re_len);
@@ -6891,12 +8670,12 @@ scan:
   if (re_len >= num) {
     eASSERT(env, MDBX_PNL_LAST(txn->tw.relist) < txn->mt_next_pgno &&
                      MDBX_PNL_FIRST(txn->tw.relist) < txn->mt_next_pgno);
-    range = txn->tw.relist + (MDBX_PNL_ASCENDING ? 1 : re_len);
-    pgno = *range;
-    if (num == 1)
+    if (num == 1) {
+      range = relist_nearby(mc, txn->tw.relist);
+      pgno = *range;
       goto done;
-    range = scan4seq(range, re_len, num - 1);
-    eASSERT(env, range == scan4range_checker(txn->tw.relist, num - 1));
+    }
+    range = relist_seek(txn, num, flags);
     if (likely(range)) {
       pgno = *range;
       goto done;
@@ -6914,6 +8693,21 @@ depleted_gc:
   if (flags & MDBX_ALLOC_SHOULD_SCAN)
     goto scan;
 
+#if MDBX_ENABLE_GC_GAPS
+  /* Try the records above the oldest reader, which are invisible by all
+   * live snapshots. Avoid this for GC updating, since reclaimed records
+   * are deleted by update_gc() before the reservation. */
+  if ((flags & (MDBX_ALLOC_RESERVE | MDBX_ALLOC_GAPS)) == 0 && num &&
+      mc->mc_dbi != FREE_DBI && !txn->mt_parent &&
+      env->me_gc_births.length &&
+      re_len < env->me_options.rp_augment_limit &&
+      gc_gaps_prepare(txn, oldest)) {
+    flags += MDBX_ALLOC_GAPS;
+    id = oldest;
+    goto next_gc;
+  }
+#endif /* MDBX_ENABLE_GC_GAPS */
+
   //-------------------------------------------------------------------------
 
   /* There is no suitable pages in the GC and to be able to allocate
@@ -6954,7 +8748,8 @@ depleted_gc:
       /* wipe steady checkpoint in MDBX_UTTERLY_NOSYNC mode
        * without any auto-sync threshold(s). */
 #if MDBX_ENABLE_PROFGC
-      env->me_lck->mti_pgop_stat.gc_prof.wipes += 1;
+      if (unlikely(prof))
+        env->me_lck->mti_pgop_stat.gc_prof.wipes += 1;
 #endif /* MDBX_ENABLE_PROFGC */
       ret.err = wipe_steady(txn, detent);
       DEBUG("gc-wipe-steady, rc %d", ret.err);
@@ -6976,7 +8771,8 @@ depleted_gc:
          (autosync_threshold | autosync_period) == 0)) {
       /* make steady checkpoint. */
 #if MDBX_ENABLE_PROFGC
-      env->me_lck->mti_pgop_stat.gc_prof.flushes += 1;
+      if (unlikely(prof))
+        env->me_lck->mti_pgop_stat.gc_prof.flushes += 1;
 #endif /* MDBX_ENABLE_PROFGC */
       MDBX_meta meta = *recent.ptr_c;
       ret.err = sync_locked(env, env->me_flags & MDBX_WRITEMAP, &meta,
@@ -7040,7 +8836,8 @@ no_gc:
   eASSERT(env, aligned >= newnext);
 
 #if MDBX_ENABLE_PROFGC
-  monotime_shot = osal_monotime();
+  if (unlikely(prof))
+    monotime_shot = osal_monotime();
 #endif /* MDBX_ENABLE_PROFGC */
   VERBOSE("try growth datafile to %zu pages (+%zu)", aligned,
           aligned - txn->mt_end_pgno);
@@ -7072,6 +8869,7 @@ done:
       for (const pgno_t *const end = txn->tw.relist + re_len; ++range <= end;)
         range[-(ptrdiff_t)num] = *range;
 #endif
+      runs_cutoff(txn, re_len, re_len - num);
       MDBX_PNL_SETSIZE(txn->tw.relist, re_len -= num);
       eASSERT(env, pnl_check_allocated(txn->tw.relist,
                                        txn->mt_next_pgno - MDBX_ENABLE_REFUND));
@@ -7083,7 +8881,7 @@ done:
     }
 
 #if MDBX_ENABLE_PROFGC
-    if (!monotime_shot)
+    if (unlikely(prof) && !monotime_shot)
       monotime_shot = osal_monotime();
 #endif /* MDBX_ENABLE_PROFGC */
     if (env->me_flags & MDBX_WRITEMAP) {
@@ -7143,15 +8941,17 @@ done:
   eASSERT(env, pnl_check_allocated(txn->tw.relist,
                                    txn->mt_next_pgno - MDBX_ENABLE_REFUND));
 #if MDBX_ENABLE_PROFGC
-  size_t majflt_after;
-  prof->rtime_cpu += osal_cputime(&majflt_after) - cputime_before;
-  prof->majflt += majflt_after - majflt_before;
-  const uint64_t monotime_now = osal_monotime();
-  if (monotime_shot) {
-    prof->xtime_monotonic += monotime_shot - monotime_before;
-    prof->rtime_monotonic += monotime_now - monotime_shot;
-  } else
-    prof->rtime_monotonic += monotime_now - monotime_before;
+  if (unlikely(prof)) {
+    size_t majflt_after;
+    prof->rtime_cpu += osal_cputime(&majflt_after) - cputime_before;
+    prof->majflt += majflt_after - majflt_before;
+    const uint64_t monotime_now = osal_monotime();
+    if (monotime_shot) {
+      prof->xtime_monotonic += monotime_shot - monotime_before;
+      prof->rtime_monotonic += monotime_now - monotime_shot;
+    } else
+      prof->rtime_monotonic += monotime_now - monotime_before;
+  }
 #endif /* MDBX_ENABLE_PROFGC */
   return ret;
 }
@@ -7187,22 +8987,20 @@ __hot static pgr_t page_alloc(const MDBX_cursor *mc) {
   if (likely(len > 0)) {
     MDBX_env *const env = txn->mt_env;
 
+    pgno_t *const item = relist_nearby(mc, pnl);
+    const pgno_t pgno = *item;
+    memmove(item, item + 1, (char *)(pnl + len) - (char *)item);
     MDBX_PNL_SETSIZE(pnl, len - 1);
-#if MDBX_PNL_ASCENDING
-    const pgno_t pgno = pnl[1];
-    for (size_t i = 1; i < len; ++i)
-      pnl[i] = pnl[i + 1];
-#else
-    const pgno_t pgno = pnl[len];
-#endif
+    runs_cutoff(txn, len, len - 1);
 
 #if MDBX_ENABLE_PROFGC
-    const uint64_t monotime_before = osal_monotime();
-    size_t majflt_before;
-    const uint64_t cputime_before = osal_cputime(&majflt_before);
-    profgc_stat_t *const prof = (mc->mc_dbi == FREE_DBI)
-                                    ? &env->me_lck->mti_pgop_stat.gc_prof.self
-                                    : &env->me_lck->mti_pgop_stat.gc_prof.work;
+    profgc_stat_t *const prof = profgc(mc);
+    uint64_t monotime_before = 0, cputime_before = 0;
+    size_t majflt_before = 0;
+    if (unlikely(prof)) {
+      monotime_before = osal_monotime();
+      cputime_before = osal_cputime(&majflt_before);
+    }
 #endif /* MDBX_ENABLE_PROFGC */
     pgr_t ret;
     if (env->me_flags & MDBX_WRITEMAP) {
@@ -7227,10 +9025,12 @@ __hot static pgr_t page_alloc(const MDBX_cursor *mc) {
     tASSERT(txn, pnl_check_allocated(txn->tw.relist,
                                      txn->mt_next_pgno - MDBX_ENABLE_REFUND));
 #if MDBX_ENABLE_PROFGC
-    size_t majflt_after;
-    prof->rtime_cpu += osal_cputime(&majflt_after) - cputime_before;
-    prof->majflt += majflt_after - majflt_before;
-    prof->xtime_monotonic += osal_monotime() - monotime_before;
+    if (unlikely(prof)) {
+      size_t majflt_after;
+      prof->rtime_cpu += osal_cputime(&majflt_after) - cputime_before;
+      prof->majflt += majflt_after - majflt_before;
+      prof->xtime_monotonic += osal_monotime() - monotime_before;
+    }
 #endif /* MDBX_ENABLE_PROFGC */
     return ret;
   }
@@ -7318,6 +9118,11 @@ static pgr_t __must_check_result page_unspill(MDBX_txn *const txn,
 #if MDBX_ENABLE_PGOP_STAT
     txn->mt_env->me_lck->mti_pgop_stat.unspill.weak += npages;
 #endif /* MDBX_ENABLE_PGOP_STAT */
+    txn->tw.unspill_npages += npages;
+    /* the page was spilled prematurely, so make it hot */
+    MDBX_dpl *const dl = txn->tw.dirtylist;
+    tASSERT(txn, dl->items[dl->length].ptr == ret.page);
+    dl->items[dl->length].heat = 2;
     ret.page->mp_flags |= (scan == txn) ? 0 : P_SPILLED;
     ret.err = MDBX_SUCCESS;
     return ret;
@@ -7360,8 +9165,11 @@ __hot static int page_touch(MDBX_cursor *mc) {
     tASSERT(txn, dirtylist_check(txn));
   }
 
-  if (IS_MODIFIABLE(txn, mp) || IS_SUBP(mp))
+  if (IS_MODIFIABLE(txn, mp) || IS_SUBP(mp)) {
+    if (txn->tw.dirtylist && txn->tw.dirtylist->refs && !IS_SUBP(mp))
+      spill_refs_mark(txn->tw.dirtylist, mp->mp_pgno);
     return MDBX_SUCCESS;
+  }
 
   if (IS_FROZEN(txn, mp)) {
     /* CoW the page */
@@ -7378,6 +9186,9 @@ __hot static int page_touch(MDBX_cursor *mc) {
     DEBUG("touched db %d page %" PRIaPGNO " -> %" PRIaPGNO, DDBI(mc),
           mp->mp_pgno, pgno);
     tASSERT(txn, mp->mp_pgno != pgno);
+#if MDBX_ENABLE_GC_GAPS
+    retired_birth_note(txn, mp);
+#endif /* MDBX_ENABLE_GC_GAPS */
     pnl_xappend(txn->tw.retired_pages, mp->mp_pgno);
     /* Update the parent page, if any, to point to the new page */
     if (mc->mc_top) {
@@ -7683,6 +9494,134 @@ __cold int mdbx_env_sync_poll(MDBX_env *env) {
 }
 #endif /* LIBMDBX_NO_EXPORTS_LEGACY_API */
 
+int mdbx_env_gc_prefetch(MDBX_env *env) {
+  int rc = check_env(env, true);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  if (unlikely(env->me_flags & MDBX_RDONLY))
+    return MDBX_EACCESS;
+  if (unlikely(env->me_txn0->mt_owner == osal_thread_self()))
+    return MDBX_BUSY;
+
+  /* Read the GC records without the writer lock, i.e. concurrently with
+   * a write transaction which may be running. */
+  MDBX_txn *txn;
+  rc = mdbx_txn_begin(env, nullptr, MDBX_TXN_RDONLY, &txn);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  const bool lifo = (env->me_flags & MDBX_LIFORECLAIM) != 0;
+  const txnid_t oldest =
+      atomic_load64(&env->me_lck->mti_oldest_reader, mo_AcquireRelease);
+  MDBX_PNL relist = pnl_alloc(MDBX_PNL_INITIAL);
+  MDBX_TXL ids = txl_alloc();
+  if (unlikely(!relist || !ids)) {
+    rc = MDBX_ENOMEM;
+    goto bailout;
+  }
+
+  MDBX_cursor_couple cx;
+  rc = cursor_init(&cx.outer, txn, FREE_DBI);
+  if (unlikely(rc != MDBX_SUCCESS))
+    goto bailout;
+
+  txnid_t id = oldest - 1;
+  MDBX_cursor_op op = lifo ? MDBX_SET_RANGE : MDBX_FIRST;
+  while (MDBX_PNL_GETSIZE(relist) < env->me_maxgc_ov1page / 2) {
+    MDBX_val key, data;
+    key.iov_base = &id;
+    key.iov_len = sizeof(id);
+    rc = mdbx_cursor_get(&cx.outer, &key, &data, op);
+    if (rc == MDBX_NOTFOUND && op == MDBX_SET_RANGE) {
+      op = MDBX_LAST;
+      continue;
+    }
+    if (rc == MDBX_NOTFOUND)
+      break;
+    if (unlikely(rc != MDBX_SUCCESS))
+      goto bailout;
+    if (unlikely(key.iov_len != sizeof(txnid_t))) {
+      rc = MDBX_CORRUPTED;
+      goto bailout;
+    }
+    id = unaligned_peek_u64(4, key.iov_base);
+    op = lifo ? MDBX_PREV : MDBX_NEXT;
+    if (id >= oldest) {
+      if (lifo)
+        continue;
+      break;
+    }
+
+    const pgno_t *const gc_pnl = (const pgno_t *)data.iov_base;
+    const size_t gc_words =
+        (gc_pnl[0] & MDBX_GC_EXTENT) ? gc_pnl[0] - MDBX_GC_EXTENT : 0;
+    if (unlikely(data.iov_len % sizeof(pgno_t) ||
+                 data.iov_len < (gc_words ? (gc_words + 1) * sizeof(pgno_t)
+                                          : MDBX_PNL_SIZEOF(gc_pnl)))) {
+      rc = MDBX_CORRUPTED;
+      goto bailout;
+    }
+    const size_t gc_len = gc_words ? gc_extents_count(gc_pnl + 1, gc_words)
+                                   : MDBX_PNL_GETSIZE(gc_pnl);
+    rc = pnl_need(&relist, gc_len + gc_len + 2);
+    if (unlikely(rc != MDBX_SUCCESS))
+      goto bailout;
+    rc = txl_append(&ids, id);
+    if (unlikely(rc != MDBX_SUCCESS))
+      goto bailout;
+
+    /* Copy the record into a temp PNL at the tail, then merge ones */
+    MDBX_PNL tail = relist + MDBX_PNL_ALLOCLEN(relist) - gc_len - 1;
+    if (gc_words)
+      gc_extents_expand(gc_pnl + 1, gc_words, MDBX_PNL_BEGIN(tail));
+    else
+      memcpy(MDBX_PNL_BEGIN(tail), MDBX_PNL_BEGIN(gc_pnl),
+             gc_len * sizeof(pgno_t));
+    MDBX_PNL_SETSIZE(tail, gc_len);
+    if (unlikely((gc_words && !gc_len) ||
+                 !pnl_check(tail, txn->mt_next_pgno))) {
+      rc = MDBX_CORRUPTED;
+      goto bailout;
+    }
+    pnl_merge(relist, tail);
+  }
+
+  const txnid_t snap_txnid = txn->mt_txnid;
+  rc = mdbx_txn_abort(txn);
+  txn = nullptr;
+  if (likely(rc == MDBX_SUCCESS) && MDBX_PNL_GETSIZE(ids)) {
+    /* Hand over the prepared list while no write transaction is running
+     * and the GC is the same as it was read. */
+    rc = mdbx_txn_lock(env, true);
+    if (likely(rc == MDBX_SUCCESS)) {
+      const meta_troika_t troika = meta_tap(env);
+      rc = MDBX_RESULT_TRUE;
+      if (meta_recent(env, &troika).txnid == snap_txnid) {
+        gc_prefetch_drop(env);
+        env->me_gc_prefetch.relist = relist;
+        env->me_gc_prefetch.ids = ids;
+        env->me_gc_prefetch.txnid = snap_txnid;
+        env->me_gc_prefetch.lifo = lifo;
+        relist = nullptr;
+        ids = nullptr;
+        rc = MDBX_SUCCESS;
+      }
+      mdbx_txn_unlock(env);
+    }
+  } else if (rc == MDBX_SUCCESS)
+    rc = MDBX_RESULT_TRUE;
+
+bailout:
+  pnl_free(relist);
+  txl_free(ids);
+  if (txn) {
+    int err = mdbx_txn_abort(txn);
+    if (unlikely(err != MDBX_SUCCESS) && !MDBX_IS_ERROR(rc))
+      rc = err;
+  }
+  return rc;
+}
+
 /* Back up parent txn's cursors, then grab the originals for tracking */
 static int cursor_shadow(MDBX_txn *parent, MDBX_txn *nested) {
   tASSERT(parent, parent->mt_cursors[FREE_DBI] == nullptr);
@@ -7867,12 +9806,155 @@ typedef struct {
   MDBX_reader *rslot;
 } bind_rslot_result;
 
+#if MDBX_ENABLE_READERS_SHARDING
+/* Returns the first slot of the readers group which is local for the CPU the
+ * current thread is running on, or the capacity of readers table if unknown. */
+static size_t rslot_local(const size_t capacity) {
+  const int cpu = osal_cpu_current();
+  if (unlikely(cpu < 0))
+    return capacity;
+  const size_t ngroups = (capacity + MDBX_RGROUP_SIZE - 1) / MDBX_RGROUP_SIZE;
+  return (size_t)cpu % ngroups * MDBX_RGROUP_SIZE;
+}
+#endif /* MDBX_ENABLE_READERS_SHARDING */
+
+static __always_inline bool rslot_try(MDBX_env *env, MDBX_reader *const r,
+                                      const uintptr_t tid) {
+  if (atomic_load32(&r->mr_pid, mo_Relaxed) == 0 &&
+      atomic_cas32(&r->mr_pid, 0, env->me_pid)) {
+    safe64_reset(&r->mr_txnid, true);
+    r->mr_tid.weak = tid;
+    return true;
+  }
+  return false;
+}
+
+/* Claims a free slot of the readers table by CAS of mr_pid from zero, i.e.
+ * without locking. The scan starts after the slot claimed last time by this
+ * process, so the concurrent threads hardly collide on the same slots.
+ *
+ * With the MDBX_ENABLE_READERS_SHARDING the slots of the group local for the
+ * current CPU are tried first. If there are no free ones, but the group could
+ * be populated by the readers table growth, then nullptr is returned to grow
+ * under the lock, see bind_rslot().
+ *
+ * The capacity is the me_maxreaders loaded once by the caller, since it could
+ * be increased concurrently by readers_adopt(). */
+static MDBX_reader *rslot_claim(MDBX_env *env, const uintptr_t tid,
+                                const size_t capacity) {
+  MDBX_lockinfo *const lck = env->me_lck;
+  size_t nreaders = atomic_load32(&lck->mti_numreaders, mo_AcquireRelease);
+  /* The slots beyond the local capacity are used only after adopting
+   * the growth of the readers table made by other process. */
+  if (unlikely(nreaders > capacity))
+    nreaders = capacity;
+#if MDBX_ENABLE_READERS_SHARDING
+  const size_t local = rslot_local(capacity);
+  if (likely(local < capacity)) {
+    const size_t end = (local + MDBX_RGROUP_SIZE < nreaders)
+                           ? local + MDBX_RGROUP_SIZE
+                           : nreaders;
+    for (size_t slot = local; slot < end; ++slot)
+      if (rslot_try(env, &lck->mti_readers[slot], tid))
+        return &lck->mti_readers[slot];
+    if (end < local + MDBX_RGROUP_SIZE && nreaders < capacity)
+      return nullptr;
+  }
+#endif /* MDBX_ENABLE_READERS_SHARDING */
+  size_t slot = atomic_load32(&env->me_rslot_hint, mo_Relaxed);
+  for (size_t n = 0; n < nreaders; ++n, ++slot) {
+    if (slot >= nreaders)
+      slot = 0;
+    if (rslot_try(env, &lck->mti_readers[slot], tid)) {
+      atomic_store32(&env->me_rslot_hint, (uint32_t)slot + 1, mo_Relaxed);
+      return &lck->mti_readers[slot];
+    }
+  }
+  return nullptr;
+}
+
+#if !(defined(_WIN32) || defined(_WIN64))
+/* Takes in account the growth of the readers table, including one made by
+ * other processes. Should be called under the lock of readers table.
+ * The new capacity is published after the range of the thread-key is
+ * extended, since the fast path of bind_rslot() uses it un-mutexed. */
+static void readers_adopt(MDBX_env *env, size_t capacity) {
+  eASSERT(env, capacity <= MDBX_READERS_LIMIT &&
+                   sizeof(MDBX_lockinfo) + capacity * sizeof(MDBX_reader) <=
+                       env->me_lck_mmap.limit);
+  if (capacity > env->me_maxreaders.weak) {
+    if (env->me_flags & MDBX_ENV_TXKEY)
+      rthc_extend(env->me_txkey, &env->me_lck->mti_readers[capacity]);
+    atomic_store32(&env->me_maxreaders, (uint32_t)capacity, mo_AcquireRelease);
+  }
+}
+
+/* Grows the readers table by extending the lck-file within the address space
+ * reserved by the mapping, i.e. without moving the slots which are used
+ * un-mutexed. The new capacity is published after the file is extended, so
+ * other processes could adopt it at any time. Should be called under the lock
+ * of readers table. */
+__cold static int readers_grow(MDBX_env *env) {
+  const size_t current = env->me_maxreaders.weak;
+  size_t limit =
+      (env->me_lck_mmap.limit - sizeof(MDBX_lockinfo)) / sizeof(MDBX_reader);
+  if (limit > env->me_options.readers_growth_limit)
+    limit = env->me_options.readers_growth_limit;
+  if (current >= limit)
+    return MDBX_READERS_FULL;
+
+  const size_t wanna = (current * 2 < limit) ? current * 2 : limit;
+  const size_t bytes =
+      ceil_powerof2(wanna * sizeof(MDBX_reader) + sizeof(MDBX_lockinfo),
+                    env->me_os_psize);
+  eASSERT(env, bytes <= env->me_lck_mmap.limit);
+  size_t capacity = (bytes - sizeof(MDBX_lockinfo)) / sizeof(MDBX_reader);
+  if (capacity > MDBX_READERS_LIMIT)
+    capacity = MDBX_READERS_LIMIT;
+
+  const int err = osal_ftruncate(env->me_lfd, bytes);
+  if (unlikely(err != MDBX_SUCCESS)) {
+    ERROR("unable to grow the readers table, error %d", err);
+    return err;
+  }
+  env->me_lck_mmap.current = bytes;
+  env->me_lck_mmap.filesize = bytes;
+  atomic_store32(&env->me_lck->mti_readers_capacity, (uint32_t)capacity,
+                 mo_AcquireRelease);
+  NOTICE("the readers table is grown from %zu to %zu slots", current,
+         capacity);
+  readers_adopt(env, capacity);
+  return MDBX_SUCCESS;
+}
+#endif /* !Windows */
+
 static bind_rslot_result bind_rslot(MDBX_env *env, const uintptr_t tid) {
   eASSERT(env, env->me_lck_mmap.lck);
   eASSERT(env, env->me_lck->mti_magic_and_version == MDBX_LOCK_MAGIC);
   eASSERT(env, env->me_lck->mti_os_and_format == MDBX_LOCK_FORMAT);
 
-  bind_rslot_result result = {osal_rdt_lock(env), nullptr};
+  bind_rslot_result result = {MDBX_SUCCESS, nullptr};
+#if !(defined(_WIN32) || defined(_WIN64))
+  /* Fast path: the liveness of this process is already marked and a free
+   * slot is available. Otherwise, as well as the readers table growth and
+   * cleanup of dead readers, the slow path under the mutex is used.
+   * On Windows the mutex is required to suspend the threads for remap. */
+  if (likely(env->me_live_reader == env->me_pid && env->me_map &&
+             !(env->me_flags & MDBX_FATAL_ERROR))) {
+    result.rslot = rslot_claim(
+        env, tid, atomic_load32(&env->me_maxreaders, mo_AcquireRelease));
+    if (likely(result.rslot)) {
+      osal_memory_barrier();
+      if (likely(!atomic_load32(&env->me_rslot_remap, mo_Relaxed)))
+        goto bound;
+      /* back off until the remap is done, see map_resize() */
+      atomic_store32(&result.rslot->mr_pid, 0, mo_AcquireRelease);
+      result.rslot = nullptr;
+    }
+  }
+#endif /* !Windows */
+
+  result.err = osal_rdt_lock(env);
   if (unlikely(MDBX_IS_ERROR(result.err)))
     return result;
   if (unlikely(env->me_flags & MDBX_FATAL_ERROR)) {
@@ -7896,41 +9978,71 @@ static bind_rslot_result bind_rslot(MDBX_env *env, const uintptr_t tid) {
   }
 
   result.err = MDBX_SUCCESS;
-  size_t slot, nreaders;
   while (1) {
-    nreaders = env->me_lck->mti_numreaders.weak;
-    for (slot = 0; slot < nreaders; slot++)
-      if (!atomic_load32(&env->me_lck->mti_readers[slot].mr_pid,
-                         mo_AcquireRelease))
-        break;
+    /* only readers_adopt() changes it and is called under the same lock */
+    const size_t capacity = env->me_maxreaders.weak;
+    result.rslot = rslot_claim(env, tid, capacity);
+    if (result.rslot)
+      break;
 
-    if (likely(slot < env->me_maxreaders))
+    const size_t nreaders = env->me_lck->mti_numreaders.weak;
+    if (likely(nreaders < capacity)) {
+      size_t slot = nreaders;
+#if MDBX_ENABLE_READERS_SHARDING
+      /* Skip up to the local group, the slots beyond mti_numreaders were
+       * never used since the lck-file initialization, i.e. are zeroed. */
+      const size_t local = rslot_local(capacity);
+      if (local > slot && local < capacity)
+        slot = local;
+#endif /* MDBX_ENABLE_READERS_SHARDING */
+      /* Grow the readers table, carefully since other code uses it
+       * un-mutexed: first setup the slot, including the claim, since
+       * the free slots are claimed lock-free, next publish it in
+       * lck->mti_numreaders. After that, it is safe for mdbx_env_close()
+       * to touch it. */
+      result.rslot = &env->me_lck->mti_readers[slot];
+      atomic_store32(&result.rslot->mr_pid, env->me_pid, mo_Relaxed);
+      safe64_reset(&result.rslot->mr_txnid, true);
+      result.rslot->mr_tid.weak = tid;
+      atomic_store32(&env->me_lck->mti_numreaders, (uint32_t)slot + 1,
+                     mo_AcquireRelease);
+      atomic_store32(&env->me_rslot_hint, (uint32_t)slot + 1, mo_Relaxed);
       break;
+    }
 
-    result.err = cleanup_dead_readers(env, true, NULL);
-    if (result.err != MDBX_RESULT_TRUE) {
-      osal_rdt_unlock(env);
-      result.err =
-          (result.err == MDBX_SUCCESS) ? MDBX_READERS_FULL : result.err;
-      return result;
+#if !(defined(_WIN32) || defined(_WIN64))
+    const size_t grown =
+        atomic_load32(&env->me_lck->mti_readers_capacity, mo_AcquireRelease);
+    if (grown > capacity) {
+      /* the readers table was grown by other process */
+      readers_adopt(env, grown);
+      continue;
     }
-  }
+#endif /* !Windows */
 
-  result.rslot = &env->me_lck->mti_readers[slot];
-  /* Claim the reader slot, carefully since other code
-   * uses the reader table un-mutexed: First reset the
-   * slot, next publish it in lck->mti_numreaders.  After
-   * that, it is safe for mdbx_env_close() to touch it.
-   * When it will be closed, we can finally claim it. */
-  atomic_store32(&result.rslot->mr_pid, 0, mo_AcquireRelease);
-  safe64_reset(&result.rslot->mr_txnid, true);
-  if (slot == nreaders)
-    env->me_lck->mti_numreaders.weak = (uint32_t)++nreaders;
-  result.rslot->mr_tid.weak = (env->me_flags & MDBX_NOTLS) ? 0 : tid;
-  atomic_store32(&result.rslot->mr_pid, env->me_pid, mo_AcquireRelease);
+    int dead = 0;
+    result.err = cleanup_dead_readers(env, true, &dead);
+    if (result.err == MDBX_RESULT_TRUE ||
+        (result.err == MDBX_SUCCESS && dead))
+      continue;
+#if !(defined(_WIN32) || defined(_WIN64))
+    if (result.err == MDBX_SUCCESS) {
+      result.err = readers_grow(env);
+      if (result.err == MDBX_SUCCESS)
+        continue;
+    }
+#endif /* !Windows */
+    osal_rdt_unlock(env);
+    result.err = (result.err == MDBX_SUCCESS) ? MDBX_READERS_FULL : result.err;
+    return result;
+  }
+  result.err = MDBX_SUCCESS;
   osal_rdt_unlock(env);
 
-  if (likely(env->me_flags & MDBX_ENV_TXKEY)) {
+#if !(defined(_WIN32) || defined(_WIN64))
+bound:
+#endif /* !Windows */
+  if (likely(env->me_flags & MDBX_ENV_TXKEY) && tid) {
     eASSERT(env, env->me_live_reader == env->me_pid);
     thread_rthc_set(env->me_txkey, result.rslot);
   }
@@ -8140,7 +10252,23 @@ static bool coherency_check_meta(const MDBX_env *env,
 }
 
 /* Common code for mdbx_txn_begin() and mdbx_txn_renew(). */
-static int txn_renew(MDBX_txn *txn, const unsigned flags) {
+/* Setup db info */
+static void txn_dbi_setup(MDBX_txn *txn) {
+  const MDBX_env *const env = txn->mt_env;
+  osal_compiler_barrier();
+  memset(txn->mt_cursors, 0, sizeof(MDBX_cursor *) * txn->mt_numdbs);
+  for (size_t i = CORE_DBS; i < txn->mt_numdbs; i++) {
+    const unsigned db_flags = env->me_dbflags[i];
+    txn->mt_dbs[i].md_flags = db_flags & DB_PERSISTENT_FLAGS;
+    txn->mt_dbistate[i] =
+        (db_flags & DB_VALID) ? DBI_VALID | DBI_USRVALID | DBI_STALE : 0;
+  }
+  txn->mt_dbistate[MAIN_DBI] = DBI_VALID | DBI_USRVALID;
+  txn->mt_dbistate[FREE_DBI] = DBI_VALID;
+}
+
+static int txn_renew(MDBX_txn *txn, const unsigned flags,
+                     const uint64_t lock_deadline) {
   MDBX_env *env = txn->mt_env;
   int rc;
 
@@ -8151,7 +10279,8 @@ static int txn_renew(MDBX_txn *txn, const unsigned flags) {
   }
 #endif /* MDBX_ENV_CHECKPID */
 
-  STATIC_ASSERT(sizeof(MDBX_reader) == 32);
+  STATIC_ASSERT(sizeof(MDBX_reader) ==
+                (MDBX_ENABLE_READERS_SHARDING ? MDBX_CACHELINE_SIZE : 32));
 #if MDBX_LOCKING > 0
   STATIC_ASSERT(offsetof(MDBX_lockinfo, mti_wlock) % MDBX_CACHELINE_SIZE == 0);
   STATIC_ASSERT(offsetof(MDBX_lockinfo, mti_rlock) % MDBX_CACHELINE_SIZE == 0);
@@ -8166,12 +10295,15 @@ static int txn_renew(MDBX_txn *txn, const unsigned flags) {
 
   const uintptr_t tid = osal_thread_self();
   if (flags & MDBX_TXN_RDONLY) {
-    eASSERT(env, (flags & ~(MDBX_TXN_RO_BEGIN_FLAGS | MDBX_WRITEMAP)) == 0);
-    txn->mt_flags =
-        MDBX_TXN_RDONLY | (env->me_flags & (MDBX_NOTLS | MDBX_WRITEMAP));
+    eASSERT(env, (flags & ~(MDBX_TXN_RO_BEGIN_FLAGS | MDBX_WRITEMAP |
+                            MDBX_NOTLS)) == 0);
+    /* The MDBX_NOTLS in flags is used for a shared snapshot, whose reader
+     * slot should not be bound to the thread, see mdbx_snapshot_acquire() */
+    txn->mt_flags = MDBX_TXN_RDONLY | ((env->me_flags | flags) &
+                                       (MDBX_NOTLS | MDBX_WRITEMAP));
     MDBX_reader *r = txn->to.reader;
     STATIC_ASSERT(sizeof(uintptr_t) <= sizeof(r->mr_tid));
-    if (likely(env->me_flags & MDBX_ENV_TXKEY)) {
+    if (likely(env->me_flags & MDBX_ENV_TXKEY) && !(flags & MDBX_NOTLS)) {
       eASSERT(env, !(env->me_flags & MDBX_NOTLS));
       r = thread_rthc_get(env->me_txkey);
       if (likely(r)) {
@@ -8185,7 +10317,7 @@ static int txn_renew(MDBX_txn *txn, const unsigned flags) {
         }
       }
     } else {
-      eASSERT(env, !env->me_lck_mmap.lck || (env->me_flags & MDBX_NOTLS));
+      eASSERT(env, !env->me_lck_mmap.lck || (txn->mt_flags & MDBX_NOTLS));
     }
 
     if (likely(r)) {
@@ -8193,7 +10325,8 @@ static int txn_renew(MDBX_txn *txn, const unsigned flags) {
                    r->mr_txnid.weak < SAFE64_INVALID_THRESHOLD))
         return MDBX_BAD_RSLOT;
     } else if (env->me_lck_mmap.lck) {
-      bind_rslot_result brs = bind_rslot(env, tid);
+      bind_rslot_result brs =
+          bind_rslot(env, (txn->mt_flags & MDBX_NOTLS) ? 0 : tid);
       if (unlikely(brs.err != MDBX_SUCCESS))
         return brs.err;
       r = brs.rslot;
@@ -8230,10 +10363,11 @@ static int txn_renew(MDBX_txn *txn, const unsigned flags) {
             unaligned_peek_u64_volatile(4, head.ptr_v->mm_pages_retired),
             mo_Relaxed);
         safe64_write(&r->mr_txnid, head.txnid);
+        rgroup_enter(env->me_lck, r, head.txnid);
         eASSERT(env, r->mr_pid.weak == osal_getpid());
         eASSERT(env,
                 r->mr_tid.weak ==
-                    ((env->me_flags & MDBX_NOTLS) ? 0 : osal_thread_self()));
+                    ((txn->mt_flags & MDBX_NOTLS) ? 0 : osal_thread_self()));
         eASSERT(env, r->mr_txnid.weak == head.txnid ||
                          (r->mr_txnid.weak >= SAFE64_INVALID_THRESHOLD &&
                           head.txnid < env->me_lck->mti_oldest_reader.weak));
@@ -8262,8 +10396,10 @@ static int txn_renew(MDBX_txn *txn, const unsigned flags) {
                 "metapages are too volatile");
           rc = MDBX_PROBLEM;
           txn->mt_txnid = INVALID_TXNID;
-          if (likely(r))
+          if (likely(r)) {
             safe64_reset(&r->mr_txnid, false);
+            rgroup_leave(env->me_lck, r);
+          }
           goto bailout;
         }
         timestamp = 0;
@@ -8278,16 +10414,20 @@ static int txn_renew(MDBX_txn *txn, const unsigned flags) {
 
       if (unlikely(rc != MDBX_RESULT_TRUE)) {
         txn->mt_txnid = INVALID_TXNID;
-        if (likely(r))
+        if (likely(r)) {
           safe64_reset(&r->mr_txnid, false);
+          rgroup_leave(env->me_lck, r);
+        }
         goto bailout;
       }
     }
 
     if (unlikely(txn->mt_txnid < MIN_TXNID || txn->mt_txnid > MAX_TXNID)) {
       ERROR("%s", "environment corrupted by died writer, must shutdown!");
-      if (likely(r))
+      if (likely(r)) {
         safe64_reset(&r->mr_txnid, false);
+        rgroup_leave(env->me_lck, r);
+      }
       txn->mt_txnid = INVALID_TXNID;
       rc = MDBX_CORRUPTED;
       goto bailout;
@@ -8323,9 +10463,12 @@ static int txn_renew(MDBX_txn *txn, const unsigned flags) {
 
     /* Not yet touching txn == env->me_txn0, it may be active */
     jitter4testing(false);
-    rc = mdbx_txn_lock(env, !!(flags & MDBX_TXN_TRY));
+    const uint64_t lock_begin = osal_monotime();
+    rc = (flags & MDBX_TXN_TRY) ? mdbx_txn_lock(env, true)
+                                : osal_txn_lock_until(env, lock_deadline);
     if (unlikely(rc))
       return rc;
+    const uint64_t lock_wait = osal_monotime() - lock_begin;
     if (unlikely(env->me_flags & MDBX_FATAL_ERROR)) {
       mdbx_txn_unlock(env);
       return MDBX_PANIC;
@@ -8370,6 +10513,16 @@ static int txn_renew(MDBX_txn *txn, const unsigned flags) {
     txn->tw.last_reclaimed = 0;
     if (txn->tw.lifo_reclaimed)
       MDBX_PNL_SETSIZE(txn->tw.lifo_reclaimed, 0);
+#if MDBX_ENABLE_GC_GAPS
+    if (txn->tw.gap_reclaimed)
+      MDBX_PNL_SETSIZE(txn->tw.gap_reclaimed, 0);
+    txn->tw.retired_birth = MAX_TXNID;
+#endif /* MDBX_ENABLE_GC_GAPS */
+    if (unlikely(env->me_gc_prefetch.ids) &&
+        (env->me_gc_prefetch.txnid != head.txnid ||
+         env->me_gc_prefetch.lifo != ((env->me_flags & MDBX_LIFORECLAIM) != 0)))
+      /* GC was changed since the prefetch */
+      gc_prefetch_drop(env);
     env->me_txn = txn;
     txn->mt_numdbs = env->me_numdbs;
     memcpy(txn->mt_dbiseqs, env->me_dbiseqs, txn->mt_numdbs * sizeof(unsigned));
@@ -8390,19 +10543,11 @@ static int txn_renew(MDBX_txn *txn, const unsigned flags) {
       txn->tw.dirtyroom = MAX_PAGENO;
       txn->tw.dirtylru = 0;
     }
+    txn->tw.spill_npages = txn->tw.unspill_npages = 0;
+    txn->tw.lock_wait = lock_wait;
   }
 
-  /* Setup db info */
-  osal_compiler_barrier();
-  memset(txn->mt_cursors, 0, sizeof(MDBX_cursor *) * txn->mt_numdbs);
-  for (size_t i = CORE_DBS; i < txn->mt_numdbs; i++) {
-    const unsigned db_flags = env->me_dbflags[i];
-    txn->mt_dbs[i].md_flags = db_flags & DB_PERSISTENT_FLAGS;
-    txn->mt_dbistate[i] =
-        (db_flags & DB_VALID) ? DBI_VALID | DBI_USRVALID | DBI_STALE : 0;
-  }
-  txn->mt_dbistate[MAIN_DBI] = DBI_VALID | DBI_USRVALID;
-  txn->mt_dbistate[FREE_DBI] = DBI_VALID;
+  txn_dbi_setup(txn);
   txn->mt_front =
       txn->mt_txnid + ((flags & (MDBX_WRITEMAP | MDBX_RDONLY)) == 0);
 
@@ -8525,7 +10670,7 @@ int mdbx_txn_renew(MDBX_txn *txn) {
       return rc;
   }
 
-  rc = txn_renew(txn, MDBX_TXN_RDONLY);
+  rc = txn_renew(txn, MDBX_TXN_RDONLY, 0);
   if (rc == MDBX_SUCCESS) {
     txn->mt_owner = osal_thread_self();
     DEBUG("renew txn %" PRIaTXN "%c %p on env %p, root page %" PRIaPGNO
@@ -8557,10 +10702,34 @@ void *mdbx_txn_get_userctx(const MDBX_txn *txn) {
   return check_txn(txn, MDBX_TXN_FINISHED) ? nullptr : txn->mt_userctx;
 }
 
-int mdbx_txn_begin_ex(MDBX_env *env, MDBX_txn *parent, MDBX_txn_flags_t flags,
-                      MDBX_txn **ret, void *context) {
+/* Allocates a txn with the arrays for all DBI-handles of environment. */
+static MDBX_txn *txn_alloc(MDBX_env *env, const unsigned flags) {
+  const size_t tsize = sizeof(MDBX_txn);
+  const size_t size =
+      tsize + env->me_maxdbs * (sizeof(MDBX_db) + sizeof(MDBX_cursor *) + 1);
+  MDBX_txn *const txn = osal_malloc(size);
+  if (unlikely(txn == NULL)) {
+    DEBUG("calloc: %s", "failed");
+    return NULL;
+  }
+#if MDBX_DEBUG
+  memset(txn, 0xCD, size);
+  VALGRIND_MAKE_MEM_UNDEFINED(txn, size);
+#endif /* MDBX_DEBUG */
+  memset(txn, 0, tsize);
+  txn->mt_dbxs = env->me_dbxs; /* static */
+  txn->mt_dbs = (MDBX_db *)((char *)txn + tsize);
+  txn->mt_cursors = (MDBX_cursor **)(txn->mt_dbs + env->me_maxdbs);
+  txn->mt_dbistate = (uint8_t *)txn + size - env->me_maxdbs;
+  txn->mt_flags = flags;
+  txn->mt_env = env;
+  return txn;
+}
+
+static int txn_begin(MDBX_env *env, MDBX_txn *parent, MDBX_txn_flags_t flags,
+                     MDBX_txn **ret, void *context,
+                     const uint64_t lock_deadline) {
   MDBX_txn *txn;
-  size_t size, tsize;
 
   if (unlikely(!ret))
     return MDBX_EINVAL;
@@ -8610,23 +10779,9 @@ int mdbx_txn_begin_ex(MDBX_env *env, MDBX_txn *parent, MDBX_txn_flags_t flags,
     goto renew;
   }
 
-  size = env->me_maxdbs * (sizeof(MDBX_db) + sizeof(MDBX_cursor *) + 1);
-  size += tsize = sizeof(MDBX_txn);
-  if (unlikely((txn = osal_malloc(size)) == NULL)) {
-    DEBUG("calloc: %s", "failed");
+  txn = txn_alloc(env, flags);
+  if (unlikely(!txn))
     return MDBX_ENOMEM;
-  }
-#if MDBX_DEBUG
-  memset(txn, 0xCD, size);
-  VALGRIND_MAKE_MEM_UNDEFINED(txn, size);
-#endif /* MDBX_DEBUG */
-  memset(txn, 0, tsize);
-  txn->mt_dbxs = env->me_dbxs; /* static */
-  txn->mt_dbs = (MDBX_db *)((char *)txn + tsize);
-  txn->mt_cursors = (MDBX_cursor **)(txn->mt_dbs + env->me_maxdbs);
-  txn->mt_dbistate = (uint8_t *)txn + size - env->me_maxdbs;
-  txn->mt_flags = flags;
-  txn->mt_env = env;
 
   if (parent) {
     tASSERT(parent, dirtylist_check(parent));
@@ -8657,6 +10812,9 @@ int mdbx_txn_begin_ex(MDBX_env *env, MDBX_txn *parent, MDBX_txn_flags_t flags,
         tASSERT(parent, di && parent->tw.dirtylist->items[di].ptr == lp);
         tASSERT(parent, lp->mp_flags == P_LOOSE);
         rc = pnl_insert_range(&parent->tw.relist, lp->mp_pgno, 1);
+        runs_invalidate(parent);
+        if (parent->mt_parent && likely(rc == MDBX_SUCCESS))
+          rc = shadowed_reclaimed_note(parent, lp->mp_pgno);
         if (unlikely(rc != MDBX_SUCCESS))
           goto nested_failed;
         parent->tw.loose_pages = lp->mp_next;
@@ -8671,8 +10829,12 @@ int mdbx_txn_begin_ex(MDBX_env *env, MDBX_txn *parent, MDBX_txn_flags_t flags,
     }
     txn->tw.dirtyroom = parent->tw.dirtyroom;
     txn->tw.dirtylru = parent->tw.dirtylru;
+    txn->tw.spill_npages = txn->tw.unspill_npages = 0;
 
-    dpl_sort(parent);
+    /* A huge list isn't sorted here, since it is indexed by hash for lookups
+     * and the sorting is costly after txn_merge_incremental() */
+    if (parent->tw.dirtylist->length < MDBX_DPL_HASH_THRESHOLD)
+      dpl_sort(parent);
     if (parent->tw.spilled.list)
       spill_purge(parent);
 
@@ -8697,6 +10859,9 @@ int mdbx_txn_begin_ex(MDBX_env *env, MDBX_txn *parent, MDBX_txn_flags_t flags,
     txn->tw.retired_pages = parent->tw.retired_pages;
     parent->tw.retired_pages =
         (void *)(intptr_t)MDBX_PNL_GETSIZE(parent->tw.retired_pages);
+#if MDBX_ENABLE_GC_GAPS
+    txn->tw.retired_birth = parent->tw.retired_birth;
+#endif /* MDBX_ENABLE_GC_GAPS */
 
     txn->mt_txnid = parent->mt_txnid;
     txn->mt_front = parent->mt_front + 1;
@@ -8733,7 +10898,7 @@ int mdbx_txn_begin_ex(MDBX_env *env, MDBX_txn *parent, MDBX_txn_flags_t flags,
   } else { /* MDBX_TXN_RDONLY */
     txn->mt_dbiseqs = env->me_dbiseqs;
   renew:
-    rc = txn_renew(txn, flags);
+    rc = txn_renew(txn, flags, lock_deadline);
   }
 
   if (unlikely(rc != MDBX_SUCCESS)) {
@@ -8765,48 +10930,188 @@ int mdbx_txn_begin_ex(MDBX_env *env, MDBX_txn *parent, MDBX_txn_flags_t flags,
   return rc;
 }
 
-int mdbx_txn_info(const MDBX_txn *txn, MDBX_txn_info *info, bool scan_rlt) {
-  int rc = check_txn(txn, MDBX_TXN_FINISHED);
+int mdbx_txn_begin_ex(MDBX_env *env, MDBX_txn *parent, MDBX_txn_flags_t flags,
+                      MDBX_txn **ret, void *context) {
+  return txn_begin(env, parent, flags, ret, context, 0);
+}
+
+int mdbx_txn_begin_timed(MDBX_env *env, MDBX_txn *parent,
+                         MDBX_txn_flags_t flags, MDBX_txn **ret,
+                         unsigned timeout_seconds_16dot16, void *context) {
+  const uint64_t deadline =
+      timeout_seconds_16dot16
+          ? osal_monotime() + osal_16dot16_to_monotime(timeout_seconds_16dot16)
+          : 0;
+  return txn_begin(env, parent, flags, ret, context, deadline);
+}
+
+static void snapshot_unref(MDBX_snapshot *snapshot) {
+  if (atomic_sub32(&snapshot->ms_refs, 1) == 1) {
+    MDBX_txn *const txn = snapshot->ms_txn;
+    DEBUG("release snapshot %p of txn %" PRIaTXN, (void *)snapshot,
+          txn->mt_txnid);
+    (void)txn_end(txn, MDBX_END_ABORT | MDBX_END_UPDATE | MDBX_END_SLOT |
+                           MDBX_END_FREE);
+    snapshot->ms_txn = nullptr;
+    osal_free(snapshot);
+  }
+}
+
+int mdbx_snapshot_acquire(MDBX_env *env, MDBX_snapshot **ret) {
+  if (unlikely(!ret))
+    return MDBX_EINVAL;
+  *ret = NULL;
+
+  int rc = check_env(env, true);
   if (unlikely(rc != MDBX_SUCCESS))
     return rc;
 
-  if (unlikely(!info))
-    return MDBX_EINVAL;
+  MDBX_snapshot *const snapshot = osal_malloc(sizeof(MDBX_snapshot));
+  MDBX_txn *const txn = txn_alloc(env, MDBX_TXN_RDONLY);
+  if (unlikely(!snapshot || !txn)) {
+    osal_free(snapshot);
+    osal_free(txn);
+    return MDBX_ENOMEM;
+  }
 
-  MDBX_env *const env = txn->mt_env;
-#if MDBX_ENV_CHECKPID
-  if (unlikely(env->me_pid != osal_getpid())) {
-    env->me_flags |= MDBX_FATAL_ERROR;
-    return MDBX_PANIC;
+  /* The reader slot is held by an internal txn, which isn't bound
+   * to the thread and never used directly. */
+  txn->mt_dbiseqs = env->me_dbiseqs;
+  rc = txn_renew(txn,
+                 MDBX_TXN_RDONLY | MDBX_NOTLS | (env->me_flags & MDBX_WRITEMAP),
+                 0);
+  if (unlikely(rc != MDBX_SUCCESS)) {
+    osal_free(snapshot);
+    osal_free(txn);
+    return rc;
   }
-#endif /* MDBX_ENV_CHECKPID */
+  txn->mt_signature = MDBX_MT_SIGNATURE;
 
-  info->txn_id = txn->mt_txnid;
-  info->txn_space_used = pgno2bytes(env, txn->mt_geo.next);
+  snapshot->ms_signature = MDBX_MS_SIGNATURE;
+  atomic_store32(&snapshot->ms_refs, 1, mo_Relaxed);
+  snapshot->ms_txn = txn;
+  *ret = snapshot;
+  DEBUG("acquire snapshot %p of txn %" PRIaTXN " on env %p", (void *)snapshot,
+        txn->mt_txnid, (void *)env);
+  return MDBX_SUCCESS;
+}
 
-  if (txn->mt_flags & MDBX_TXN_RDONLY) {
-    meta_ptr_t head;
-    uint64_t head_retired;
-    meta_troika_t troika = meta_tap(env);
-    do {
-      /* fetch info from volatile head */
-      head = meta_recent(env, &troika);
-      head_retired =
-          unaligned_peek_u64_volatile(4, head.ptr_v->mm_pages_retired);
-      info->txn_space_limit_soft = pgno2bytes(env, head.ptr_v->mm_geo.now);
-      info->txn_space_limit_hard = pgno2bytes(env, head.ptr_v->mm_geo.upper);
-      info->txn_space_leftover =
-          pgno2bytes(env, head.ptr_v->mm_geo.now - head.ptr_v->mm_geo.next);
-    } while (unlikely(meta_should_retry(env, &troika)));
+int mdbx_snapshot_release(MDBX_snapshot *snapshot) {
+  if (unlikely(!snapshot))
+    return MDBX_EINVAL;
 
-    info->txn_reader_lag = head.txnid - info->txn_id;
-    info->txn_space_dirty = info->txn_space_retired = 0;
-    uint64_t reader_snapshot_pages_retired;
-    if (txn->to.reader &&
-        head_retired >
-            (reader_snapshot_pages_retired = atomic_load64(
-                 &txn->to.reader->mr_snapshot_pages_retired, mo_Relaxed))) {
-      info->txn_space_dirty = info->txn_space_retired = pgno2bytes(
+  if (unlikely(snapshot->ms_signature != MDBX_MS_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  /* the txns created from the snapshot are still using it */
+  snapshot->ms_signature = 0;
+  snapshot_unref(snapshot);
+  return MDBX_SUCCESS;
+}
+
+int mdbx_txn_begin_snapshot(MDBX_snapshot *snapshot, MDBX_txn **ret,
+                            void *context) {
+  if (unlikely(!ret))
+    return MDBX_EINVAL;
+  *ret = NULL;
+
+  if (unlikely(!snapshot))
+    return MDBX_EINVAL;
+
+  if (unlikely(snapshot->ms_signature != MDBX_MS_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  const MDBX_txn *const origin = snapshot->ms_txn;
+  MDBX_env *const env = origin->mt_env;
+  int rc = check_env(env, true);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  if (env->me_txn0 && unlikely(env->me_txn0->mt_owner == osal_thread_self()) &&
+      (runtime_flags & MDBX_DBG_LEGACY_OVERLAP) == 0)
+    return MDBX_TXN_OVERLAPPING;
+
+  MDBX_txn *const txn = txn_alloc(
+      env, MDBX_TXN_RDONLY | (env->me_flags & (MDBX_NOTLS | MDBX_WRITEMAP)));
+  if (unlikely(!txn))
+    return MDBX_ENOMEM;
+
+  /* Just copy the state of the snapshot, without touching the reader table
+   * nor the meta-pages, since the MVCC-version is retained by the snapshot */
+  txn->mt_dbiseqs = env->me_dbiseqs;
+  txn->mt_txnid = origin->mt_txnid;
+  txn->mt_front = origin->mt_front;
+  txn->mt_geo = origin->mt_geo;
+  txn->mt_canary = origin->mt_canary;
+  memcpy(txn->mt_dbs, origin->mt_dbs, CORE_DBS * sizeof(MDBX_db));
+  txn->mt_numdbs = env->me_numdbs;
+  txn_dbi_setup(txn);
+  atomic_add32(&snapshot->ms_refs, 1);
+  txn->to.snapshot = snapshot;
+#if defined(_WIN32) || defined(_WIN64)
+  /* such txn has no own reader slot, so its thread will not be suspended
+   * for remap, therefore hold the guard like a regular reader could do */
+  if ((txn->mt_flags & MDBX_NOTLS) == 0) {
+    txn->mt_flags |= MDBX_SHRINK_ALLOWED;
+    osal_srwlock_AcquireShared(&env->me_remap_guard);
+  }
+#endif /* Windows */
+
+  txn->mt_owner = osal_thread_self();
+  txn->mt_signature = MDBX_MT_SIGNATURE;
+  txn->mt_userctx = context;
+  *ret = txn;
+  DEBUG("begin txn %" PRIaTXN "r %p of snapshot %p on env %p, "
+        "root page %" PRIaPGNO "/%" PRIaPGNO,
+        txn->mt_txnid, (void *)txn, (void *)snapshot, (void *)env,
+        txn->mt_dbs[MAIN_DBI].md_root, txn->mt_dbs[FREE_DBI].md_root);
+  return MDBX_SUCCESS;
+}
+
+int mdbx_txn_info(const MDBX_txn *txn, MDBX_txn_info *info, bool scan_rlt) {
+  int rc = check_txn(txn, MDBX_TXN_FINISHED);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  if (unlikely(!info))
+    return MDBX_EINVAL;
+
+  MDBX_env *const env = txn->mt_env;
+#if MDBX_ENV_CHECKPID
+  if (unlikely(env->me_pid != osal_getpid())) {
+    env->me_flags |= MDBX_FATAL_ERROR;
+    return MDBX_PANIC;
+  }
+#endif /* MDBX_ENV_CHECKPID */
+
+  info->txn_id = txn->mt_txnid;
+  info->txn_space_used = pgno2bytes(env, txn->mt_geo.next);
+
+  if (txn->mt_flags & MDBX_TXN_RDONLY) {
+    meta_ptr_t head;
+    uint64_t head_retired;
+    meta_troika_t troika = meta_tap(env);
+    do {
+      /* fetch info from volatile head */
+      head = meta_recent(env, &troika);
+      head_retired =
+          unaligned_peek_u64_volatile(4, head.ptr_v->mm_pages_retired);
+      info->txn_space_limit_soft = pgno2bytes(env, head.ptr_v->mm_geo.now);
+      info->txn_space_limit_hard = pgno2bytes(env, head.ptr_v->mm_geo.upper);
+      info->txn_space_leftover =
+          pgno2bytes(env, head.ptr_v->mm_geo.now - head.ptr_v->mm_geo.next);
+    } while (unlikely(meta_should_retry(env, &troika)));
+
+    info->txn_reader_lag = head.txnid - info->txn_id;
+    info->txn_space_dirty = info->txn_space_retired = 0;
+    const MDBX_reader *const reader =
+        txn->to.snapshot ? txn->to.snapshot->ms_txn->to.reader : txn->to.reader;
+    uint64_t reader_snapshot_pages_retired;
+    if (reader &&
+        head_retired >
+            (reader_snapshot_pages_retired = atomic_load64(
+                 &reader->mr_snapshot_pages_retired, mo_Relaxed))) {
+      info->txn_space_dirty = info->txn_space_retired = pgno2bytes(
           env, (pgno_t)(head_retired - reader_snapshot_pages_retired));
 
       size_t retired_next_reader = 0;
@@ -8840,7 +11145,7 @@ int mdbx_txn_info(const MDBX_txn *txn, MDBX_txn_info *info, bool scan_rlt) {
               retired_next_reader = pgno2bytes(
                   env, (pgno_t)(snap_retired -
                                 atomic_load64(
-                                    &txn->to.reader->mr_snapshot_pages_retired,
+                                    &reader->mr_snapshot_pages_retired,
                                     mo_Relaxed)));
             }
           }
@@ -9125,6 +11430,12 @@ static int txn_end(MDBX_txn *txn, const unsigned mode) {
   if (!(mode & MDBX_END_EOTDONE)) /* !(already closed cursors) */
     cursors_eot(txn, false);
 
+#if MDBX_ENABLE_ASYNC_SPILL
+  /* a write error doesn't matter here since the pages are discarded */
+  if (!(txn->mt_flags & MDBX_TXN_RDONLY))
+    (void)spill_async_confirm(env);
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
+
   int rc = MDBX_SUCCESS;
   if (txn->mt_flags & MDBX_TXN_RDONLY) {
     if (txn->to.reader) {
@@ -9142,6 +11453,7 @@ static int txn_end(MDBX_txn *txn, const unsigned mode) {
 #endif
         atomic_store32(&slot->mr_snapshot_pages_used, 0, mo_Relaxed);
         safe64_reset(&slot->mr_txnid, false);
+        rgroup_leave(env->me_lck, slot);
         atomic_store32(&env->me_lck->mti_readers_refresh_flag, true,
                        mo_Relaxed);
       } else {
@@ -9149,10 +11461,14 @@ static int txn_end(MDBX_txn *txn, const unsigned mode) {
         eASSERT(env, slot->mr_txnid.weak >= SAFE64_INVALID_THRESHOLD);
       }
       if (mode & MDBX_END_SLOT) {
-        if ((env->me_flags & MDBX_ENV_TXKEY) == 0)
+        if ((env->me_flags & MDBX_ENV_TXKEY) == 0 ||
+            (txn->mt_flags & MDBX_NOTLS))
           atomic_store32(&slot->mr_pid, 0, mo_Relaxed);
         txn->to.reader = NULL;
       }
+    } else if (txn->to.snapshot) {
+      snapshot_unref(txn->to.snapshot);
+      txn->to.snapshot = NULL;
     }
 #if defined(_WIN32) || defined(_WIN64)
     if (txn->mt_flags & MDBX_SHRINK_ALLOWED)
@@ -9179,8 +11495,11 @@ static int txn_end(MDBX_txn *txn, const unsigned mode) {
       eASSERT(env, txn->mt_parent == NULL);
       /* Export or close DBI handles created in this txn */
       dbi_update(txn, mode & MDBX_END_UPDATE);
+      /* Forget the changes tracked for the change feed */
+      env->me_changefeed.txnid = 0;
       pnl_shrink(&txn->tw.retired_pages);
       pnl_shrink(&txn->tw.relist);
+      runs_invalidate(txn);
       if (!(env->me_flags & MDBX_WRITEMAP))
         dlist_free(txn);
       /* The writer mutex was locked in mdbx_txn_begin. */
@@ -9220,6 +11539,8 @@ static int txn_end(MDBX_txn *txn, const unsigned mode) {
       dlist_free(txn);
       dpl_free(txn);
       pnl_free(txn->tw.relist);
+      runs_free(txn->tw.relist_runs);
+      pnl_free(txn->tw.shadowed_reclaimed);
 
       if (parent->mt_geo.upper != txn->mt_geo.upper ||
           parent->mt_geo.now != txn->mt_geo.now) {
@@ -9336,9 +11657,21 @@ __cold static int audit_ex(MDBX_txn *txn, size_t retired_stored,
             goto skip;
       } else if (id <= txn->tw.last_reclaimed)
         goto skip;
+#if MDBX_ENABLE_GC_GAPS
+      if (is_gap_reclaimed(txn, id))
+        goto skip;
+#endif /* MDBX_ENABLE_GC_GAPS */
     }
 
-    gc += *(pgno_t *)data.iov_base;
+    const pgno_t counter = *(pgno_t *)data.iov_base;
+    if (unlikely((counter & MDBX_GC_EXTENT) &&
+                 (counter - MDBX_GC_EXTENT + 1) * sizeof(pgno_t) >
+                     data.iov_len))
+      return MDBX_CORRUPTED;
+    gc += (counter & MDBX_GC_EXTENT)
+              ? gc_extents_count((pgno_t *)data.iov_base + 1,
+                                 counter - MDBX_GC_EXTENT)
+              : counter;
   skip:;
   }
   tASSERT(txn, rc == MDBX_NOTFOUND);
@@ -9437,6 +11770,9 @@ typedef struct gc_update_context {
   size_t retired_stored, loop;
   size_t settled, cleaned_slot, reused_slot, filled_slot;
   txnid_t cleaned_id, rid;
+#if MDBX_ENABLE_GC_GAPS
+  size_t gap_cleaned;
+#endif /* MDBX_ENABLE_GC_GAPS */
   bool lifo, dense;
 #if MDBX_ENABLE_BIGFOOT
   txnid_t bigfoot;
@@ -9564,6 +11900,73 @@ static __inline void gcu_clean_reserved(MDBX_env *env, MDBX_val pnl) {
     memset(pnl.iov_base, 0, pnl.iov_len);
 }
 
+#if MDBX_ENABLE_GC_EXTENTS
+/* Returns the number of items from the head (or the tail) of the sorted
+ * slice of a PNL which could be stored within the limit of extent-encoded
+ * words, and the number of such words. */
+static size_t gcu_extents_fit(const pgno_t *items, const size_t n,
+                              const size_t limit, const size_t max_items,
+                              const bool from_tail, size_t *words) {
+  const intptr_t dir = from_tail ? -1 : 1;
+  const pgno_t step = (pgno_t)(MDBX_PNL_ASCENDING ? dir : -dir);
+  size_t taken = 0, used = 0;
+  while (taken < n && taken < max_items && used < limit) {
+    const pgno_t *const first =
+        from_tail ? items + n - 1 - taken : items + taken;
+    size_t len = 1;
+    while (taken + len < n && first[dir * (intptr_t)len] ==
+                                  first[dir * (intptr_t)(len - 1)] + step)
+      ++len;
+    if (len > max_items - taken)
+      len = max_items - taken;
+    if (len > 2) {
+      if (used + 2 > limit)
+        len = 1;
+      used += (len > 2) ? 2 : 1;
+    } else {
+      if (len > limit - used)
+        len = limit - used;
+      used += len;
+    }
+    taken += len;
+  }
+  *words = used;
+  return taken;
+}
+
+/* Stores the sorted slice of a PNL into the GC record, in the extent-encoded
+ * form if the one is shorter. */
+static void gcu_extents_store(pgno_t *dst, const pgno_t *items, const size_t n,
+                              const size_t words) {
+  assert(words <= n);
+  if (words == n) {
+    /* no runs, so keep the plain form which is readable by older versions */
+    *dst++ = (pgno_t)n;
+    memcpy(dst, items, n * sizeof(pgno_t));
+    return;
+  }
+
+  pgno_t *const head = dst++;
+  const pgno_t step = MDBX_PNL_ASCENDING ? 1 : (pgno_t)-1;
+  for (size_t i = 0; i < n;) {
+    size_t len = 1;
+    while (i + len < n && items[i + len] == items[i + len - 1] + step)
+      ++len;
+    if (len > 2) {
+      *dst++ = (MDBX_PNL_ASCENDING ? items[i] : items[i + len - 1]) |
+               MDBX_GC_EXTENT;
+      *dst++ = (pgno_t)len;
+    } else {
+      for (size_t j = 0; j < len; ++j)
+        *dst++ = items[i + j];
+    }
+    i += len;
+  }
+  assert((size_t)(dst - head - 1) == words);
+  *head = (pgno_t)words | MDBX_GC_EXTENT;
+}
+#endif /* MDBX_ENABLE_GC_EXTENTS */
+
 /* Cleanups reclaimed GC (aka freeDB) records, saves the retired-list (aka
  * freelist) of current transaction to GC, puts back into GC leftover of the
  * reclaimed pages with chunking. This recursive changes the reclaimed-list,
@@ -9625,6 +12028,30 @@ retry:
 
     tASSERT(txn, pnl_check_allocated(txn->tw.relist,
                                      txn->mt_next_pgno - MDBX_ENABLE_REFUND));
+#if MDBX_ENABLE_GC_GAPS
+    /* Удаляем записи, переработанные между снимками читателей. */
+    while (txn->tw.gap_reclaimed &&
+           ctx->gap_cleaned < MDBX_PNL_GETSIZE(txn->tw.gap_reclaimed)) {
+      txnid_t gap_id = txn->tw.gap_reclaimed[++ctx->gap_cleaned];
+      key.iov_base = &gap_id;
+      key.iov_len = sizeof(gap_id);
+      rc = mdbx_cursor_get(&ctx->cursor, &key, NULL, MDBX_SET);
+      if (rc == MDBX_NOTFOUND)
+        continue;
+      if (unlikely(rc != MDBX_SUCCESS))
+        goto bailout;
+      if (likely(!ctx->dense)) {
+        rc = gcu_prepare_backlog(txn, ctx, false);
+        if (unlikely(rc != MDBX_SUCCESS))
+          goto bailout;
+      }
+      TRACE("%s: cleanup-gap-reclaimed-id %" PRIaTXN, dbg_prefix_mode, gap_id);
+      tASSERT(txn, *txn->mt_cursors == &ctx->cursor);
+      rc = mdbx_cursor_del(&ctx->cursor, 0);
+      if (unlikely(rc != MDBX_SUCCESS))
+        goto bailout;
+    }
+#endif /* MDBX_ENABLE_GC_GAPS */
     if (ctx->lifo) {
       if (ctx->cleaned_slot < (txn->tw.lifo_reclaimed
                                    ? MDBX_PNL_GETSIZE(txn->tw.lifo_reclaimed)
@@ -9758,6 +12185,7 @@ retry:
         MDBX_PNL_SETSIZE(loose, count);
         pnl_sort(loose, txn->mt_next_pgno);
         pnl_merge(txn->tw.relist, loose);
+        runs_invalidate(txn);
         TRACE("%s: append %zu loose-pages to reclaimed-pages", dbg_prefix_mode,
               txn->tw.loose_count);
       }
@@ -9837,11 +12265,27 @@ retry:
           key.iov_base = &ctx->bigfoot;
           const size_t left =
               MDBX_PNL_GETSIZE(txn->tw.retired_pages) - ctx->retired_stored;
+#if MDBX_ENABLE_GC_EXTENTS
+          /* limit the number of pages within a slice to be reclaimed at once */
+          const size_t max_items =
+              (ctx->bigfoot == MAX_TXNID) ? left
+              : (env->me_options.rp_augment_limit > env->me_maxgc_ov1page)
+                  ? env->me_options.rp_augment_limit
+                  : env->me_maxgc_ov1page;
+          size_t words;
+          const size_t chunk = gcu_extents_fit(
+              txn->tw.retired_pages + 1 +
+                  ((ctx->lifo == MDBX_PNL_ASCENDING) ? 0 : ctx->retired_stored),
+              left, (ctx->bigfoot < MAX_TXNID) ? env->me_maxgc_ov1page : left,
+              max_items, ctx->lifo == MDBX_PNL_ASCENDING, &words);
+          data.iov_len = (words + 1) * sizeof(pgno_t);
+#else
           const size_t chunk =
               (left > env->me_maxgc_ov1page && ctx->bigfoot < MAX_TXNID)
                   ? env->me_maxgc_ov1page
                   : left;
           data.iov_len = (chunk + 1) * sizeof(pgno_t);
+#endif /* MDBX_ENABLE_GC_EXTENTS */
           rc = mdbx_cursor_put(&ctx->cursor, &key, &data, MDBX_RESERVE);
           if (unlikely(rc != MDBX_SUCCESS))
             goto bailout;
@@ -9858,10 +12302,14 @@ retry:
              *  - the larger pgno is at the ending of retired list
              *    and should be placed with the smaller txnid.
              */
+#if MDBX_ENABLE_GC_EXTENTS
+            gcu_extents_store(data.iov_base, begin + 1, chunk, words);
+#else
             const pgno_t save = *begin;
             *begin = (pgno_t)chunk;
             memcpy(data.iov_base, begin, data.iov_len);
             *begin = save;
+#endif /* MDBX_ENABLE_GC_EXTENTS */
             TRACE("%s: put-retired/bigfoot @ %" PRIaTXN
                   " (slice #%u) #%zu [%zu..%zu] of %zu",
                   dbg_prefix_mode, ctx->bigfoot,
@@ -9877,6 +12325,27 @@ retry:
       /* Write to last page of GC */
       key.iov_len = sizeof(txnid_t);
       key.iov_base = &txn->mt_txnid;
+#if MDBX_ENABLE_GC_EXTENTS
+      size_t words, stored;
+      do {
+        gcu_prepare_backlog(txn, ctx, true);
+        pnl_sort(txn->tw.retired_pages, txn->mt_next_pgno);
+        stored = gcu_extents_fit(
+            MDBX_PNL_BEGIN(txn->tw.retired_pages),
+            MDBX_PNL_GETSIZE(txn->tw.retired_pages), MAX_PAGENO, MAX_PAGENO,
+            false, &words);
+        data.iov_len = (words + 1) * sizeof(pgno_t);
+        rc = mdbx_cursor_put(&ctx->cursor, &key, &data, MDBX_RESERVE);
+        if (unlikely(rc != MDBX_SUCCESS))
+          goto bailout;
+        /* Retry if tw.retired_pages[] grew during the Put() */
+      } while (stored < MDBX_PNL_GETSIZE(txn->tw.retired_pages));
+
+      ctx->retired_stored = stored;
+      eASSERT(env, stored == MDBX_PNL_GETSIZE(txn->tw.retired_pages));
+      gcu_extents_store(data.iov_base, MDBX_PNL_BEGIN(txn->tw.retired_pages),
+                        ctx->retired_stored, words);
+#else
       do {
         gcu_prepare_backlog(txn, ctx, true);
         data.iov_len = MDBX_PNL_SIZEOF(txn->tw.retired_pages);
@@ -9890,6 +12359,7 @@ retry:
       pnl_sort(txn->tw.retired_pages, txn->mt_next_pgno);
       eASSERT(env, data.iov_len == MDBX_PNL_SIZEOF(txn->tw.retired_pages));
       memcpy(data.iov_base, txn->tw.retired_pages, data.iov_len);
+#endif /* MDBX_ENABLE_GC_EXTENTS */
 
       TRACE("%s: put-retired #%u @ %" PRIaTXN, dbg_prefix_mode,
             ctx->retired_stored, txn->mt_txnid);
@@ -10360,7 +12830,8 @@ bailout:
 
   MDBX_PNL_SETSIZE(txn->tw.relist, 0);
 #if MDBX_ENABLE_PROFGC
-  env->me_lck->mti_pgop_stat.gc_prof.wloops += ctx->loop;
+  if (unlikely(env->me_options.gc_profiling))
+    env->me_lck->mti_pgop_stat.gc_prof.wloops += ctx->loop;
 #endif /* MDBX_ENABLE_PROFGC */
   TRACE("<<< %zu loops, rc = %d", ctx->loop, rc);
   return rc;
@@ -10418,35 +12889,12 @@ static __always_inline bool check_dbi(MDBX_txn *txn, MDBX_dbi dbi,
 int mdbx_txn_commit(MDBX_txn *txn) { return __inline_mdbx_txn_commit(txn); }
 #endif /* LIBMDBX_NO_EXPORTS_LEGACY_API */
 
-/* Merge child txn into parent */
-static __inline void txn_merge(MDBX_txn *const parent, MDBX_txn *const txn,
-                               const size_t parent_retired_len) {
-  tASSERT(txn, (txn->mt_flags & MDBX_WRITEMAP) == 0);
-  MDBX_dpl *const src = dpl_sort(txn);
-
-  /* Remove refunded pages from parent's dirty list */
-  MDBX_dpl *const dst = dpl_sort(parent);
-  if (MDBX_ENABLE_REFUND) {
-    size_t n = dst->length;
-    while (n && dst->items[n].pgno >= parent->mt_next_pgno) {
-      const unsigned npages = dpl_npages(dst, n);
-      dpage_free(txn->mt_env, dst->items[n].ptr, npages);
-      --n;
-    }
-    parent->tw.dirtyroom += dst->sorted - n;
-    dst->sorted = dpl_setlen(dst, n);
-    tASSERT(parent,
-            parent->tw.dirtyroom + parent->tw.dirtylist->length ==
-                (parent->mt_parent ? parent->mt_parent->tw.dirtyroom
-                                   : parent->mt_env->me_options.dp_limit));
-  }
-
-  /* Remove reclaimed pages from parent's dirty list */
-  const MDBX_PNL reclaimed_list = parent->tw.relist;
-  dpl_sift(parent, reclaimed_list, false);
-
-  /* Move retired pages from parent's dirty & spilled list to reclaimed */
-  size_t r, w, d, s, l;
+/* Move retired pages from parent's dirty & spilled list to reclaimed */
+static void txn_merge_retired(MDBX_txn *const parent,
+                              const size_t parent_retired_len,
+                              const bool keep_order) {
+  MDBX_dpl *const dst = parent->tw.dirtylist;
+  size_t r, w, l;
   for (r = w = parent_retired_len;
        ++r <= MDBX_PNL_GETSIZE(parent->tw.retired_pages);) {
     const pgno_t pgno = parent->tw.retired_pages[r];
@@ -10459,7 +12907,7 @@ static __inline void txn_merge(MDBX_txn *const parent, MDBX_txn *const txn,
       tASSERT(parent, (dp->mp_flags & ~(P_LEAF | P_LEAF2 | P_BRANCH |
                                         P_OVERFLOW | P_SPILLED)) == 0);
       npages = dpl_npages(dst, di);
-      page_wash(parent, di, dp, npages);
+      page_wash_ex(parent, di, dp, npages, keep_order);
       kind = "dirty";
       l = 1;
       if (unlikely(npages > l)) {
@@ -10501,9 +12949,139 @@ static __inline void txn_merge(MDBX_txn *const parent, MDBX_txn *const txn,
     DEBUG("reclaim retired parent's %u -> %zu %s page %" PRIaPGNO, npages, l,
           kind, pgno);
     int err = pnl_insert_range(&parent->tw.relist, pgno, l);
-    ENSURE(txn->mt_env, err == MDBX_SUCCESS);
+    ENSURE(parent->mt_env, err == MDBX_SUCCESS);
+    runs_invalidate(parent);
+    if (parent->mt_parent && shadowed_reclaimed_tracked(parent) &&
+        shadowed_in_ancestors(parent, pgno)) {
+      /* Must not fail since space was preserved before merge. */
+      MDBX_PNL pl = parent->tw.shadowed_reclaimed;
+      ENSURE(parent->mt_env, MDBX_PNL_GETSIZE(pl) < MDBX_PNL_ALLOCLEN(pl));
+      MDBX_PNL_SETSIZE(pl, MDBX_PNL_GETSIZE(pl) + 1);
+      MDBX_PNL_LAST(pl) = pgno;
+    }
   }
   MDBX_PNL_SETSIZE(parent->tw.retired_pages, w);
+}
+
+/* Incremental merging of a small child's dirty list into a huge parent's one.
+ * Instead of walking and merging both lists, the child's pages are looked up
+ * in the parent's list by the hash index, so the cost is proportional to the
+ * child's dirty pages only. The parent's list is left partially unsorted.
+ * Returns false when not applicable, and nothing was changed in such case. */
+static bool txn_merge_incremental(MDBX_txn *const parent, MDBX_txn *const txn,
+                                  const size_t parent_retired_len,
+                                  const pgno_t parent_next_pgno) {
+  MDBX_dpl *const src = txn->tw.dirtylist;
+  MDBX_dpl *const dst = parent->tw.dirtylist;
+  if (dst->length < MDBX_DPL_HASH_THRESHOLD || src->length > dst->length / 8)
+    return false;
+  /* reconciliation of spilled pages requires the complete merge */
+  if ((parent->tw.spilled.list && MDBX_PNL_GETSIZE(parent->tw.spilled.list)) ||
+      (txn->tw.spilled.list && MDBX_PNL_GETSIZE(txn->tw.spilled.list)))
+    return false;
+  /* parent's dirty pages could be refunded by the child */
+  if (parent->mt_next_pgno < parent_next_pgno)
+    return false;
+  /* large/overflow pages could be only replaced by the same ones */
+  for (size_t s = 1; s <= src->length; ++s)
+    if (src->items[s].multi) {
+      const size_t di = dpl_exist(parent, src->items[s].pgno);
+      if (di && dpl_npages(dst, di) != dpl_npages(src, s))
+        return false;
+    }
+
+  DEBUG("incremental merge %zu dirty-pages into %zu", src->length,
+        dst->length);
+  txn_merge_retired(parent, parent_retired_len, false);
+
+  /* Remove pages reclaimed by the child from parent's dirty list */
+  if (txn->tw.shadowed_reclaimed) {
+    const MDBX_PNL pl = txn->tw.shadowed_reclaimed;
+    for (size_t i = 1; i <= MDBX_PNL_GETSIZE(pl); ++i) {
+      const size_t di = dpl_exist(parent, pl[i]);
+      if (di) {
+        DEBUG("remove reclaimed parent's dirty page %" PRIaPGNO, pl[i]);
+        page_wash_ex(parent, di, dst->items[di].ptr, dpl_npages(dst, di),
+                     false);
+      }
+    }
+  }
+
+  /* Replace parent's pages shadowed by the child, and append the rest */
+  for (size_t s = 1; s <= src->length; ++s) {
+    MDBX_page *const sp = src->items[s].ptr;
+    tASSERT(parent, (sp->mp_flags & ~(P_LEAF | P_LEAF2 | P_BRANCH | P_OVERFLOW |
+                                      P_LOOSE | P_SPILLED)) == 0);
+    if (sp->mp_flags != P_LOOSE) {
+      sp->mp_txnid = parent->mt_front;
+      sp->mp_flags &= ~P_SPILLED;
+    }
+    const pgno_t pgno = src->items[s].pgno;
+    const unsigned npages = dpl_npages(src, s);
+    const size_t di = dpl_exist(parent, pgno);
+    if (di) {
+      tASSERT(parent, dst == parent->tw.dirtylist);
+      const unsigned d_npages = dpl_npages(dst, di);
+      dpage_free(txn->mt_env, dst->items[di].ptr, d_npages);
+      dst->pages_including_loose += npages - (size_t)d_npages;
+      dst->items[di] = src->items[s];
+    } else {
+      int err = dpl_append(parent, pgno, sp, npages);
+      ENSURE(txn->mt_env, err == MDBX_SUCCESS);
+      parent->tw.dirtylist->items[parent->tw.dirtylist->length].extra =
+          src->items[s].extra;
+      parent->tw.dirtyroom -= 1;
+    }
+  }
+  assert(parent->tw.dirtyroom <= parent->mt_env->me_options.dp_limit);
+  parent->tw.dirtylru = txn->tw.dirtylru;
+
+  tASSERT(parent, dirtylist_check(parent));
+  dpl_free(txn);
+  if (txn->tw.spilled.list) {
+    if (parent->tw.spilled.list)
+      pnl_free(txn->tw.spilled.list);
+    else {
+      parent->tw.spilled.list = txn->tw.spilled.list;
+      parent->tw.spilled.least_removed = txn->tw.spilled.least_removed;
+    }
+  }
+  parent->mt_flags &= ~MDBX_TXN_HAS_CHILD;
+  return true;
+}
+
+/* Merge child txn into parent */
+static __inline void txn_merge(MDBX_txn *const parent, MDBX_txn *const txn,
+                               const size_t parent_retired_len,
+                               const pgno_t parent_next_pgno) {
+  tASSERT(txn, (txn->mt_flags & MDBX_WRITEMAP) == 0);
+  if (txn_merge_incremental(parent, txn, parent_retired_len, parent_next_pgno))
+    return;
+  MDBX_dpl *const src = dpl_sort(txn);
+
+  /* Remove refunded pages from parent's dirty list */
+  MDBX_dpl *const dst = dpl_sort(parent);
+  if (MDBX_ENABLE_REFUND) {
+    size_t n = dst->length;
+    while (n && dst->items[n].pgno >= parent->mt_next_pgno) {
+      const unsigned npages = dpl_npages(dst, n);
+      dpage_free(txn->mt_env, dst->items[n].ptr, npages);
+      --n;
+    }
+    parent->tw.dirtyroom += dst->sorted - n;
+    dst->sorted = dpl_setlen(dst, n);
+    tASSERT(parent,
+            parent->tw.dirtyroom + parent->tw.dirtylist->length ==
+                (parent->mt_parent ? parent->mt_parent->tw.dirtyroom
+                                   : parent->mt_env->me_options.dp_limit));
+  }
+
+  /* Remove reclaimed pages from parent's dirty list */
+  const MDBX_PNL reclaimed_list = parent->tw.relist;
+  dpl_sift(parent, reclaimed_list, false);
+
+  txn_merge_retired(parent, parent_retired_len, true);
+  size_t r, w, d, s, l;
 
   /* Filter-out parent spill list */
   if (parent->tw.spilled.list &&
@@ -10772,10 +13350,20 @@ static __inline void txn_merge(MDBX_txn *const parent, MDBX_txn *const txn,
 }
 
 int mdbx_txn_commit_ex(MDBX_txn *txn, MDBX_commit_latency *latency) {
+  return mdbx_txn_commit_info(txn, latency, nullptr, 0);
+}
+
+int mdbx_txn_commit_info(MDBX_txn *txn, MDBX_commit_latency *latency,
+                         MDBX_commit_info *info, size_t bytes) {
+  if (unlikely(info && bytes != sizeof(MDBX_commit_info)))
+    return MDBX_EINVAL;
+
   STATIC_ASSERT(MDBX_TXN_FINISHED ==
                 MDBX_TXN_BLOCKED - MDBX_TXN_HAS_CHILD - MDBX_TXN_ERROR);
   const uint64_t ts_0 = latency ? osal_monotime() : 0;
   uint64_t ts_1 = 0, ts_2 = 0, ts_3 = 0, ts_4 = 0, ts_5 = 0, gc_cputime = 0;
+  size_t spill_npages = 0, unspill_npages = 0;
+  uint64_t lock_wait = 0;
 
   MDBX_env *const env = txn->mt_env;
   int rc = check_txn(txn, MDBX_TXN_FINISHED);
@@ -10814,6 +13402,12 @@ int mdbx_txn_commit_ex(MDBX_txn *txn, MDBX_commit_latency *latency) {
     goto fail;
   }
 
+#if MDBX_ENABLE_ASYNC_SPILL
+  rc = spill_async_confirm(env);
+  if (unlikely(rc != MDBX_SUCCESS))
+    goto fail;
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
+
   if (txn->mt_parent) {
     tASSERT(txn, audit_ex(txn, 0, false) == 0);
     eASSERT(env, txn != env->me_txn0);
@@ -10868,6 +13462,26 @@ int mdbx_txn_commit_ex(MDBX_txn *txn, MDBX_commit_latency *latency) {
       spill_purge(txn);
     }
 
+    /* Preserve space for the reclaimed pages which are dirty in ancestors,
+     * including the retired by child but dirty or spilled in the parent. */
+    const size_t shadowed_delta =
+        retired_delta + (txn->tw.shadowed_reclaimed
+                             ? MDBX_PNL_GETSIZE(txn->tw.shadowed_reclaimed)
+                             : 0);
+    if (parent->mt_parent && shadowed_delta) {
+      if (!parent->tw.shadowed_reclaimed) {
+        parent->tw.shadowed_reclaimed = pnl_alloc(shadowed_delta);
+        if (unlikely(!parent->tw.shadowed_reclaimed)) {
+          rc = MDBX_ENOMEM;
+          goto fail;
+        }
+      } else {
+        rc = pnl_need(&parent->tw.shadowed_reclaimed, shadowed_delta);
+        if (unlikely(rc != MDBX_SUCCESS))
+          goto fail;
+      }
+    }
+
     if (unlikely(txn->tw.dirtylist->length + parent->tw.dirtylist->length >
                      parent->tw.dirtylist->detent &&
                  !dpl_reserve(parent, txn->tw.dirtylist->length +
@@ -10883,12 +13497,21 @@ int mdbx_txn_commit_ex(MDBX_txn *txn, MDBX_commit_latency *latency) {
 
     parent->tw.retired_pages = txn->tw.retired_pages;
     txn->tw.retired_pages = NULL;
+#if MDBX_ENABLE_GC_GAPS
+    parent->tw.retired_birth = txn->tw.retired_birth;
+#endif /* MDBX_ENABLE_GC_GAPS */
 
     pnl_free(parent->tw.relist);
     parent->tw.relist = txn->tw.relist;
     txn->tw.relist = NULL;
+    runs_free(parent->tw.relist_runs);
+    parent->tw.relist_runs = txn->tw.relist_runs;
+    txn->tw.relist_runs = NULL;
     parent->tw.last_reclaimed = txn->tw.last_reclaimed;
+    parent->tw.spill_npages += txn->tw.spill_npages;
+    parent->tw.unspill_npages += txn->tw.unspill_npages;
 
+    const pgno_t parent_next_pgno = parent->mt_next_pgno;
     parent->mt_geo = txn->mt_geo;
     parent->mt_canary = txn->mt_canary;
     parent->mt_flags |= txn->mt_flags & MDBX_TXN_DIRTY;
@@ -10925,7 +13548,21 @@ int mdbx_txn_commit_ex(MDBX_txn *txn, MDBX_commit_latency *latency) {
       ts_4 = /* no write */ ts_3;
       ts_5 = /* no sync */ ts_4;
     }
-    txn_merge(parent, txn, parent_retired_len);
+    txn_merge(parent, txn, parent_retired_len, parent_next_pgno);
+    if (txn->tw.shadowed_reclaimed) {
+      /* pass to the parent, since these pages may be dirty in its ancestors */
+      if (parent->mt_parent) {
+        const MDBX_PNL src = txn->tw.shadowed_reclaimed;
+        const MDBX_PNL dst = parent->tw.shadowed_reclaimed;
+        tASSERT(parent, MDBX_PNL_ALLOCLEN(dst) >=
+                            MDBX_PNL_GETSIZE(dst) + MDBX_PNL_GETSIZE(src));
+        memcpy(dst + MDBX_PNL_GETSIZE(dst) + 1, src + 1,
+               MDBX_PNL_SIZEOF(src) - sizeof(pgno_t));
+        MDBX_PNL_SETSIZE(dst, MDBX_PNL_GETSIZE(dst) + MDBX_PNL_GETSIZE(src));
+      }
+      pnl_free(txn->tw.shadowed_reclaimed);
+      txn->tw.shadowed_reclaimed = nullptr;
+    }
     env->me_txn = parent;
     parent->mt_child = NULL;
     tASSERT(parent, dirtylist_check(parent));
@@ -10944,6 +13581,8 @@ int mdbx_txn_commit_ex(MDBX_txn *txn, MDBX_commit_latency *latency) {
     }
 #endif /* MDBX_ENABLE_REFUND */
 
+    spill_npages = txn->tw.spill_npages;
+    unspill_npages = txn->tw.unspill_npages;
     txn->mt_signature = 0;
     osal_free(txn);
     tASSERT(parent, audit_ex(parent, 0, false) == 0);
@@ -10962,11 +13601,33 @@ int mdbx_txn_commit_ex(MDBX_txn *txn, MDBX_commit_latency *latency) {
   cursors_eot(txn, false);
   end_mode |= MDBX_END_EOTDONE;
 
+  if (env->me_drop_pending && env->me_options.drop_reclaim_budget &&
+      (txn->mt_flags & MDBX_TXN_DIRTY)) {
+    /* reclaim a bounded chunk of tables dropped by mdbx_drop_deferred() */
+    rc = drop_reclaim(txn, env->me_options.drop_reclaim_budget, nullptr);
+    if (unlikely(rc != MDBX_SUCCESS)) {
+      /* the commit itself is not affected unless the txn was broken */
+      if (txn->mt_flags & MDBX_TXN_ERROR)
+        goto fail;
+      WARNING("deferred drop reclaiming failed, error %d", rc);
+    }
+  }
+
+  if (env->me_options.changefeed_limit && (txn->mt_flags & MDBX_TXN_DIRTY)) {
+    /* record the tables changed by this txn for mdbx_changes_enum() */
+    rc = changefeed_commit(txn);
+    if (unlikely(rc != MDBX_SUCCESS))
+      goto fail;
+  }
+
   if ((!txn->tw.dirtylist || txn->tw.dirtylist->length == 0) &&
       (txn->mt_flags & (MDBX_TXN_DIRTY | MDBX_TXN_SPILLS)) == 0) {
     for (intptr_t i = txn->mt_numdbs; --i >= 0;)
       tASSERT(txn, (txn->mt_dbistate[i] & DBI_DIRTY) == 0);
 #if defined(MDBX_NOSUCCESS_EMPTY_COMMIT) && MDBX_NOSUCCESS_EMPTY_COMMIT
+    spill_npages = txn->tw.spill_npages;
+    unspill_npages = txn->tw.unspill_npages;
+    lock_wait = txn->tw.lock_wait;
     rc = txn_end(txn, end_mode);
     if (unlikely(rc != MDBX_SUCCESS))
       goto fail;
@@ -11106,9 +13767,17 @@ int mdbx_txn_commit_ex(MDBX_txn *txn, MDBX_commit_latency *latency) {
     goto fail;
   }
 
+#if MDBX_ENABLE_GC_GAPS
+  gc_gaps_commit(txn, commit_txnid);
+#endif /* MDBX_ENABLE_GC_GAPS */
   end_mode = MDBX_END_COMMITTED | MDBX_END_UPDATE | MDBX_END_EOTDONE;
 
 done:
+  if (!(txn->mt_flags & MDBX_TXN_RDONLY)) {
+    spill_npages = txn->tw.spill_npages;
+    unspill_npages = txn->tw.unspill_npages;
+    lock_wait = txn->tw.lock_wait;
+  }
   rc = txn_end(txn, end_mode);
 
 provide_latency:
@@ -11160,9 +13829,21 @@ provide_latency:
     latency->ending = ts_5 ? osal_monotime_to_16dot16(ts_6 - ts_5) : 0;
     latency->whole = osal_monotime_to_16dot16_noUnderflow(ts_6 - ts_0);
   }
+  if (info) {
+    info->spill_pages =
+        (spill_npages < UINT32_MAX) ? (uint32_t)spill_npages : UINT32_MAX;
+    info->unspill_pages =
+        (unspill_npages < UINT32_MAX) ? (uint32_t)unspill_npages : UINT32_MAX;
+    info->lock_wait = osal_monotime_to_16dot16(lock_wait);
+  }
   return rc;
 
 fail:
+  if (!(txn->mt_flags & MDBX_TXN_RDONLY)) {
+    spill_npages = txn->tw.spill_npages;
+    unspill_npages = txn->tw.unspill_npages;
+    lock_wait = txn->tw.lock_wait;
+  }
   txn->mt_flags |= MDBX_TXN_ERROR;
   mdbx_txn_abort(txn);
   goto provide_latency;
@@ -12010,10 +14691,21 @@ static int sync_locked(MDBX_env *env, unsigned flags, MDBX_meta *const pending,
   }
 
   MDBX_lockinfo *const lck = env->me_lck_mmap.lck;
-  if (likely(lck))
+  if (likely(lck)) {
     /* toggle oldest refresh */
     atomic_store32(&lck->mti_readers_refresh_flag, false, mo_Relaxed);
 
+    if (pending->unsafe_txnid != head.txnid) {
+      /* notify mdbx_env_wait_txnid() waiters, the barrier is paired with
+       * the increment of mti_commit_waiters by a waiter */
+      atomic_store32(&lck->mti_commit_txnid, (uint32_t)pending->unsafe_txnid,
+                     mo_AcquireRelease);
+      osal_memory_barrier();
+      if (atomic_load32(&lck->mti_commit_waiters, mo_Relaxed))
+        osal_futex_wake(&lck->mti_commit_txnid.weak);
+    }
+  }
+
   return MDBX_SUCCESS;
 
 fail:
@@ -12148,7 +14840,7 @@ __cold int mdbx_env_create(MDBX_env **penv) {
   if (unlikely(!env))
     return MDBX_ENOMEM;
 
-  env->me_maxreaders = DEFAULT_READERS;
+  env->me_maxreaders.weak = DEFAULT_READERS;
   env->me_maxdbs = env->me_numdbs = CORE_DBS;
   env->me_lazy_fd = env->me_dsync_fd = env->me_fd4meta = env->me_fd4data =
 #if defined(_WIN32) || defined(_WIN64)
@@ -12169,8 +14861,11 @@ __cold int mdbx_env_create(MDBX_env **penv) {
   env->me_options.spill_max_denominator = 8;
   env->me_options.spill_min_denominator = 8;
   env->me_options.spill_parent4child_denominator = 0;
+  env->me_options.spill_policy = MDBX_SPILL_ADAPTIVE;
   env->me_options.dp_loose_limit = 64;
   env->me_options.merge_threshold_16dot16_percent = 65536 / 4 /* 25% */;
+  env->me_options.drop_reclaim_budget = 1024;
+  env->me_drop_pending = true /* unknown until the first lookup */;
 
   env->me_os_psize = (unsigned)os_psize;
   setup_pagesize(env, (env->me_os_psize < MAX_PAGESIZE) ? env->me_os_psize
@@ -13222,7 +15917,7 @@ __cold static int setup_lck(MDBX_env *env, pathchar_t *lck_pathname,
     /* end of a locked section ---------------------------------------------- */
 
     env->me_lck = lckless_stub(env);
-    env->me_maxreaders = UINT_MAX;
+    env->me_maxreaders.weak = UINT_MAX;
     DEBUG("lck-setup:%s%s%s", " lck-less",
           (env->me_flags & MDBX_RDONLY) ? " readonly" : "",
           (rc == MDBX_RESULT_TRUE) ? " exclusive" : " cooperative");
@@ -13268,7 +15963,7 @@ __cold static int setup_lck(MDBX_env *env, pathchar_t *lck_pathname,
     goto bailout;
 
   if (lck_seize_rc == MDBX_RESULT_TRUE) {
-    size = ceil_powerof2(env->me_maxreaders * sizeof(MDBX_reader) +
+    size = ceil_powerof2(env->me_maxreaders.weak * sizeof(MDBX_reader) +
                              sizeof(MDBX_lockinfo),
                          env->me_os_psize);
     jitter4testing(false);
@@ -13292,12 +15987,24 @@ __cold static int setup_lck(MDBX_env *env, pathchar_t *lck_pathname,
     err = MDBX_PROBLEM;
     goto bailout;
   }
-  env->me_maxreaders = (maxreaders <= MDBX_READERS_LIMIT)
-                           ? (unsigned)maxreaders
-                           : (unsigned)MDBX_READERS_LIMIT;
+  env->me_maxreaders.weak = (maxreaders <= MDBX_READERS_LIMIT)
+                                ? (unsigned)maxreaders
+                                : (unsigned)MDBX_READERS_LIMIT;
 
+#if defined(_WIN32) || defined(_WIN64)
+  const size_t limit = (size_t)size;
+#else
+  /* Reserve the address space for the whole readers table, so the table could
+   * be grown by extending the lck-file without moving of the mapping, see
+   * readers_grow(). The same limit is used by all processes. */
+  size_t limit = ceil_powerof2(MDBX_READERS_LIMIT * sizeof(MDBX_reader) +
+                                   sizeof(MDBX_lockinfo),
+                               env->me_os_psize);
+  if (limit < size)
+    limit = (size_t)size;
+#endif /* Windows */
   err = osal_mmap((env->me_flags & MDBX_EXCLUSIVE) | MDBX_WRITEMAP,
-                  &env->me_lck_mmap, (size_t)size, (size_t)size,
+                  &env->me_lck_mmap, (size_t)size, limit,
                   lck_seize_rc ? MMAP_OPTION_TRUNCATE | MMAP_OPTION_SEMAPHORE
                                : MMAP_OPTION_SEMAPHORE);
   if (unlikely(err != MDBX_SUCCESS))
@@ -13332,6 +16039,7 @@ __cold static int setup_lck(MDBX_env *env, pathchar_t *lck_pathname,
     jitter4testing(false);
     lck->mti_magic_and_version = MDBX_LOCK_MAGIC;
     lck->mti_os_and_format = MDBX_LOCK_FORMAT;
+    lck->mti_readers_capacity.weak = env->me_maxreaders.weak;
 #if MDBX_ENABLE_PGOP_STAT
     lck->mti_pgop_stat.wops.weak = 1;
 #endif /* MDBX_ENABLE_PGOP_STAT */
@@ -14145,7 +16853,7 @@ __cold int mdbx_env_openW(MDBX_env *env, const wchar_t *pathname,
 
     if ((env->me_flags & MDBX_NOTLS) == 0) {
       rc = rthc_alloc(&env->me_txkey, &lck->mti_readers[0],
-                      &lck->mti_readers[env->me_maxreaders]);
+                      &lck->mti_readers[env->me_maxreaders.weak]);
       if (unlikely(rc != MDBX_SUCCESS))
         goto bailout;
       env->me_flags |= MDBX_ENV_TXKEY;
@@ -14189,8 +16897,16 @@ __cold int mdbx_env_openW(MDBX_env *env, const wchar_t *pathname,
                               ior_flags,
 #endif /* Windows */
                               env->me_fd4data);
+#if MDBX_ENABLE_ASYNC_SPILL
+    if (rc == MDBX_SUCCESS)
+      rc = osal_ioring_create(&env->me_spill_async.ior, env->me_fd4data);
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
   }
 
+  if (rc == MDBX_SUCCESS && env->me_options.changefeed_limit &&
+      (flags & MDBX_RDONLY) == 0)
+    rc = changefeed_open(env);
+
 #if MDBX_DEBUG
   if (rc == MDBX_SUCCESS) {
     const meta_troika_t troika = meta_tap(env);
@@ -14234,6 +16950,11 @@ __cold static int env_close(MDBX_env *env) {
     return MDBX_SUCCESS;
   }
 
+  if (env->me_options.rwatch_period_16dot16) {
+    env->me_options.rwatch_period_16dot16 = 0;
+    (void)osal_rpid_watch(env, 0);
+  }
+
   env->me_flags &= ~ENV_INTERNAL_FLAGS;
   if (flags & MDBX_ENV_TXKEY) {
     rthc_remove(env->me_txkey);
@@ -14242,6 +16963,11 @@ __cold static int env_close(MDBX_env *env) {
 
   munlock_all(env);
   osal_ioring_destroy(&env->me_ioring);
+#if MDBX_ENABLE_ASYNC_SPILL
+  if (env->me_spill_async.active)
+    (void)spill_async_wait(env);
+  osal_ioring_destroy(&env->me_spill_async.ior);
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
 
   lcklist_lock();
   const int rc = lcklist_detach_locked(env);
@@ -14282,6 +17008,22 @@ __cold static int env_close(MDBX_env *env) {
     env->me_lfd = INVALID_HANDLE_VALUE;
   }
 
+  if (env->me_changefeed.tables) {
+    for (size_t i = 0; i < env->me_maxdbs; ++i) {
+      osal_free(env->me_changefeed.tables[i].begin.iov_base);
+      osal_free(env->me_changefeed.tables[i].end.iov_base);
+    }
+    osal_free(env->me_changefeed.tables);
+    env->me_changefeed.tables = nullptr;
+  }
+  if (env->me_changefeed.dropped.iov_base) {
+    osal_free(env->me_changefeed.dropped.iov_base);
+    env->me_changefeed.dropped.iov_base = nullptr;
+    env->me_changefeed.dropped_room = 0;
+  }
+  env->me_changefeed.txnid = 0;
+  env->me_changefeed.dbi = 0;
+
   if (env->me_dbxs) {
     for (size_t i = CORE_DBS; i < env->me_numdbs; ++i)
       osal_free(env->me_dbxs[i].md_name.iov_base);
@@ -14308,12 +17050,22 @@ __cold static int env_close(MDBX_env *env) {
   if (env->me_txn0) {
     dpl_free(env->me_txn0);
     txl_free(env->me_txn0->tw.lifo_reclaimed);
+#if MDBX_ENABLE_GC_GAPS
+    txl_free(env->me_txn0->tw.gap_reclaimed);
+#endif /* MDBX_ENABLE_GC_GAPS */
     pnl_free(env->me_txn0->tw.retired_pages);
     pnl_free(env->me_txn0->tw.spilled.list);
     pnl_free(env->me_txn0->tw.relist);
+    runs_free(env->me_txn0->tw.relist_runs);
     osal_free(env->me_txn0);
     env->me_txn0 = nullptr;
   }
+  gc_prefetch_drop(env);
+#if MDBX_ENABLE_GC_GAPS
+  osal_free(env->me_gc_births.items);
+  txl_free(env->me_gc_births.snapshots);
+  memset(&env->me_gc_births, 0, sizeof(env->me_gc_births));
+#endif /* MDBX_ENABLE_GC_GAPS */
   env->me_stuck_meta = -1;
   return rc;
 }
@@ -14390,6 +17142,9 @@ __cold int mdbx_env_close_ex(MDBX_env *env, bool dont_sync) {
     env->me_dp_reserve = dp->mp_next;
     osal_free(dp);
   }
+#if MDBX_ENABLE_DPARENA
+  dparena_destroy(env);
+#endif /* MDBX_ENABLE_DPARENA */
   VALGRIND_DESTROY_MEMPOOL(env);
   ENSURE(env, env->me_lcklist_next == nullptr);
   env->me_pid = 0;
@@ -14720,12 +17475,19 @@ __hot static __always_inline pgr_t page_get_inline(const uint16_t ILL,
        * back in from the map (but don't unspill it here,
        * leave that unless page_touch happens again). */
       if (unlikely(spiller->mt_flags & MDBX_TXN_SPILLS) &&
-          search_spilled(spiller, pgno))
+          search_spilled(spiller, pgno)) {
+#if MDBX_ENABLE_ASYNC_SPILL
+        r.err = spill_async_confirm(txn->mt_env);
+        if (unlikely(r.err != MDBX_SUCCESS)) {
+          r.page = nullptr;
+          goto bailout;
+        }
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
         break;
+      }
 
-      const size_t i = dpl_search(spiller, pgno);
-      tASSERT(txn, (intptr_t)i > 0);
-      if (spiller->tw.dirtylist->items[i].pgno == pgno) {
+      const size_t i = dpl_exist(spiller, pgno);
+      if (i) {
         spiller->tw.dirtylist->items[i].lru = txn->tw.dirtylru++;
         r.page = spiller->tw.dirtylist->items[i].ptr;
         break;
@@ -16317,6 +19079,14 @@ __hot int mdbx_cursor_put(MDBX_cursor *mc, const MDBX_val *key, MDBX_val *data,
     }
   }
 
+  if (unlikely(env->me_options.changefeed_limit) &&
+      (mc->mc_flags & C_SUB) == 0 && mc->mc_dbi != FREE_DBI &&
+      (flags & F_SUBDATA) == 0) {
+    rc = changefeed_track(mc, key);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+  }
+
   DEBUG("==> put db %d key [%s], size %" PRIuPTR ", data [%s] size %" PRIuPTR,
         DDBI(mc), DKEY_DEBUG(key), key->iov_len,
         DVAL_DEBUG((flags & MDBX_RESERVE) ? nullptr : data), data->iov_len);
@@ -17010,7 +19780,12 @@ __hot int mdbx_cursor_del(MDBX_cursor *mc, MDBX_put_flags_t flags) {
   if (unlikely(mc->mc_ki[mc->mc_top] >= page_numkeys(mc->mc_pg[mc->mc_top])))
     return MDBX_NOTFOUND;
 
-  if (likely((flags & MDBX_NOSPILL) == 0) &&
+  if (unlikely(mc->mc_txn->mt_env->me_options.changefeed_limit) &&
+      (mc->mc_flags & C_SUB) == 0 && mc->mc_dbi != FREE_DBI &&
+      unlikely(rc = changefeed_track_current(mc)))
+    return rc;
+
+  if (likely((flags & MDBX_NOSPILL) == 0) &&
       unlikely(rc = cursor_spill(mc, NULL, NULL)))
     return rc;
 
@@ -20527,6 +23302,18 @@ __cold static int env_compact(MDBX_env *env, MDBX_txn *read_txn,
     while ((rc = mdbx_cursor_get(&couple.outer, &key, &data, MDBX_NEXT)) ==
            MDBX_SUCCESS) {
       const MDBX_PNL pnl = data.iov_base;
+      if (pnl[0] & MDBX_GC_EXTENT) {
+        const size_t words = pnl[0] - MDBX_GC_EXTENT;
+        const size_t npages =
+            (data.iov_len % sizeof(pgno_t) == 0 &&
+             data.iov_len >= (words + 1) * sizeof(pgno_t))
+                ? gc_extents_count(pnl + 1, words)
+                : 0;
+        if (unlikely(!npages))
+          return MDBX_CORRUPTED;
+        gc += npages;
+        continue;
+      }
       if (unlikely(data.iov_len % sizeof(pgno_t) ||
                    data.iov_len < MDBX_PNL_SIZEOF(pnl) ||
                    !(pnl_check(pnl, read_txn->mt_next_pgno))))
@@ -20646,7 +23433,7 @@ __cold static int env_copy_asis(MDBX_env *env, MDBX_txn *read_txn,
   if (unlikely(rc != MDBX_SUCCESS))
     return rc;
 
-  rc = txn_renew(read_txn, MDBX_TXN_RDONLY);
+  rc = txn_renew(read_txn, MDBX_TXN_RDONLY, 0);
   if (unlikely(rc != MDBX_SUCCESS)) {
     mdbx_txn_unlock(env);
     return rc;
@@ -21212,7 +23999,7 @@ __cold static int fetch_envinfo_ex(const MDBX_env *env, const MDBX_txn *txn,
     arg->mi_geo.shrink = env->me_dbgeo.shrink;
     arg->mi_geo.grow = env->me_dbgeo.grow;
     arg->mi_geo.current = env->me_dbgeo.now;
-    arg->mi_maxreaders = env->me_maxreaders;
+    arg->mi_maxreaders = env->me_maxreaders.weak;
     arg->mi_dxb_pagesize = env->me_psize;
     arg->mi_sys_pagesize = env->me_os_psize;
     if (likely(bytes > size_before_bootid)) {
@@ -21281,7 +24068,14 @@ __cold static int fetch_envinfo_ex(const MDBX_env *env, const MDBX_txn *txn,
   arg->mi_mapsize = env->me_dxb_mmap.limit;
 
   const MDBX_lockinfo *const lck = env->me_lck;
-  arg->mi_maxreaders = env->me_maxreaders;
+  arg->mi_maxreaders = atomic_load32(&env->me_maxreaders, mo_Relaxed);
+  if (env->me_lck_mmap.lck) {
+    /* the readers table could be grown by other process */
+    const uint32_t capacity =
+        atomic_load32(&lck->mti_readers_capacity, mo_Relaxed);
+    if (arg->mi_maxreaders < capacity)
+      arg->mi_maxreaders = capacity;
+  }
   arg->mi_numreaders = env->me_lck_mmap.lck
                            ? atomic_load32(&lck->mti_numreaders, mo_Relaxed)
                            : INT32_MAX;
@@ -21678,15 +24472,31 @@ static int dbi_open(MDBX_txn *txn, const char *table_name, unsigned user_flags,
   return rc;
 }
 
+/* The hidden tables are opened by dbi_open() directly, since the users must
+ * not write to ones nor drop ones concurrently with the internal use. */
+static int dbi_open_user(MDBX_txn *txn, const char *table_name,
+                         unsigned user_flags, MDBX_dbi *dbi,
+                         MDBX_cmp_func *keycmp, MDBX_cmp_func *datacmp) {
+  if (table_name) {
+    const MDBX_val name = {(void *)table_name, strlen(table_name)};
+    if (unlikely(hidden_table(&name))) {
+      if (likely(dbi))
+        *dbi = 0;
+      return MDBX_EINVAL;
+    }
+  }
+  return dbi_open(txn, table_name, user_flags, dbi, keycmp, datacmp);
+}
+
 int mdbx_dbi_open(MDBX_txn *txn, const char *table_name,
                   MDBX_db_flags_t table_flags, MDBX_dbi *dbi) {
-  return dbi_open(txn, table_name, table_flags, dbi, nullptr, nullptr);
+  return dbi_open_user(txn, table_name, table_flags, dbi, nullptr, nullptr);
 }
 
 int mdbx_dbi_open_ex(MDBX_txn *txn, const char *table_name,
                      MDBX_db_flags_t table_flags, MDBX_dbi *dbi,
                      MDBX_cmp_func *keycmp, MDBX_cmp_func *datacmp) {
-  return dbi_open(txn, table_name, table_flags, dbi, keycmp, datacmp);
+  return dbi_open_user(txn, table_name, table_flags, dbi, keycmp, datacmp);
 }
 
 __cold int mdbx_dbi_stat(MDBX_txn *txn, MDBX_dbi dbi, MDBX_stat *dest,
@@ -21872,69 +24682,761 @@ static int drop_tree(MDBX_cursor *mc, const bool may_have_subDBs) {
         }
       }
     }
-    rc = page_retire(mc, mc->mc_pg[0]);
-  bailout:
+    rc = page_retire(mc, mc->mc_pg[0]);
+  bailout:
+    if (unlikely(rc != MDBX_SUCCESS))
+      txn->mt_flags |= MDBX_TXN_ERROR;
+  } else if (rc == MDBX_NOTFOUND) {
+    rc = MDBX_SUCCESS;
+  }
+  mc->mc_flags &= ~C_INITIALIZED;
+  return rc;
+}
+
+/* Resets or deletes the DB record after its b-tree was dropped or detached */
+static int drop_finish(MDBX_txn *txn, MDBX_dbi dbi, bool del) {
+  int rc = MDBX_SUCCESS;
+  if (unlikely(txn->mt_env->me_options.changefeed_limit)) {
+    rc = changefeed_drop(txn, dbi, del);
+    if (unlikely(rc != MDBX_SUCCESS)) {
+      txn->mt_flags |= MDBX_TXN_ERROR;
+      return rc;
+    }
+  }
+  /* Can't delete the main DB */
+  if (del && dbi >= CORE_DBS) {
+    rc = delete (txn, MAIN_DBI, &txn->mt_dbxs[dbi].md_name, NULL, F_SUBDATA);
+    if (likely(rc == MDBX_SUCCESS)) {
+      tASSERT(txn, txn->mt_dbistate[MAIN_DBI] & DBI_DIRTY);
+      tASSERT(txn, txn->mt_flags & MDBX_TXN_DIRTY);
+      txn->mt_dbistate[dbi] = DBI_STALE;
+      MDBX_env *env = txn->mt_env;
+      rc = osal_fastmutex_acquire(&env->me_dbi_lock);
+      if (unlikely(rc != MDBX_SUCCESS)) {
+        txn->mt_flags |= MDBX_TXN_ERROR;
+        return rc;
+      }
+      dbi_close_locked(env, dbi);
+      ENSURE(env, osal_fastmutex_release(&env->me_dbi_lock) == MDBX_SUCCESS);
+    } else {
+      txn->mt_flags |= MDBX_TXN_ERROR;
+    }
+  } else {
+    /* reset the DB record, mark it dirty */
+    txn->mt_dbistate[dbi] |= DBI_DIRTY;
+    txn->mt_dbs[dbi].md_depth = 0;
+    txn->mt_dbs[dbi].md_branch_pages = 0;
+    txn->mt_dbs[dbi].md_leaf_pages = 0;
+    txn->mt_dbs[dbi].md_overflow_pages = 0;
+    txn->mt_dbs[dbi].md_entries = 0;
+    txn->mt_dbs[dbi].md_root = P_INVALID;
+    txn->mt_dbs[dbi].md_seq = 0;
+    txn->mt_flags |= MDBX_TXN_DIRTY;
+  }
+  return rc;
+}
+
+int mdbx_drop(MDBX_txn *txn, MDBX_dbi dbi, bool del) {
+  int rc = check_txn_rw(txn, MDBX_TXN_BLOCKED);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  MDBX_cursor *mc;
+  rc = mdbx_cursor_open(txn, dbi, &mc);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  rc = drop_tree(mc,
+                 dbi == MAIN_DBI || (mc->mc_db->md_flags & MDBX_DUPSORT) != 0);
+  /* Invalidate the dropped DB's cursors */
+  for (MDBX_cursor *m2 = txn->mt_cursors[dbi]; m2; m2 = m2->mc_next)
+    m2->mc_flags &= ~(C_INITIALIZED | C_EOF);
+  if (likely(rc == MDBX_SUCCESS))
+    rc = drop_finish(txn, dbi, del);
+
+  mdbx_cursor_close(mc);
+  return rc;
+}
+
+/* Prefix of names for the hidden tables queued by mdbx_drop_deferred(). */
+#define DROP_DEFERRED_PREFIX MDBX_HIDDEN_TABLE_PREFIX "dropped:"
+
+static void drop_deferred_name(char *buf, size_t bufsize, txnid_t txnid,
+                               unsigned seq) {
+  snprintf(buf, bufsize, "%s%016" PRIx64 ".%u", DROP_DEFERRED_PREFIX, txnid,
+           seq);
+}
+
+int mdbx_drop_deferred(MDBX_txn *txn, MDBX_dbi dbi, bool del) {
+  int rc = check_txn_rw(txn, MDBX_TXN_BLOCKED);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  if (unlikely(!check_dbi(txn, dbi, DBI_USRVALID)))
+    return MDBX_BAD_DBI;
+
+  if (unlikely(txn->mt_dbistate[dbi] & DBI_STALE)) {
+    rc = fetch_sdb(txn, dbi);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+  }
+
+  /* The main DB can't be queued into itself,
+   * and there is nothing to defer for an empty DB. */
+  if (dbi < CORE_DBS || txn->mt_dbs[dbi].md_root == P_INVALID)
+    return mdbx_drop(txn, dbi, del);
+
+  /* Detach the b-tree by saving it as a hidden table within the main DB */
+  MDBX_db detached = txn->mt_dbs[dbi];
+  detached.md_mod_txnid = txn->mt_txnid;
+  char name[sizeof(DROP_DEFERRED_PREFIX) + 32];
+  MDBX_val key, data;
+  MDBX_cursor_couple couple;
+  rc = cursor_init(&couple.outer, txn, MAIN_DBI);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  unsigned seq = 0;
+  do {
+    drop_deferred_name(name, sizeof(name), txn->mt_txnid, seq++);
+    key.iov_base = name;
+    key.iov_len = strlen(name);
+    /* the data will be overwritten by an existing one on MDBX_KEYEXIST */
+    data.iov_base = &detached;
+    data.iov_len = sizeof(detached);
+    WITH_CURSOR_TRACKING(couple.outer,
+                         rc = mdbx_cursor_put(&couple.outer, &key, &data,
+                                              F_SUBDATA | MDBX_NOOVERWRITE));
+  } while (rc == MDBX_KEYEXIST);
+  if (unlikely(rc != MDBX_SUCCESS)) {
+    txn->mt_flags |= MDBX_TXN_ERROR;
+    return rc;
+  }
+  txn->mt_env->me_drop_pending = true;
+
+  /* Invalidate the dropped DB's cursors */
+  for (MDBX_cursor *m2 = txn->mt_cursors[dbi]; m2; m2 = m2->mc_next)
+    m2->mc_flags &= ~(C_INITIALIZED | C_EOF);
+  return drop_finish(txn, dbi, del);
+}
+
+static int drop_tail(MDBX_cursor *mc, size_t *budget);
+
+/* Releases the rightmost leaf with its large pages and nested trees, then
+ * unlinks one from the parent. Only branch pages on the path are touched. */
+static int drop_tail_leaf(MDBX_cursor *mc) {
+  MDBX_db *const db = mc->mc_db;
+  MDBX_page *const mp = mc->mc_pg[mc->mc_top];
+  int rc;
+  if (mc->mc_top) {
+    cursor_pop(mc);
+    rc = cursor_touch(mc);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+  }
+
+  const size_t nkeys = page_numkeys(mp);
+  size_t items = nkeys;
+  if (!(mc->mc_flags & C_SUB)) {
+    items = 0;
+    for (size_t i = 0; i < nkeys; i++) {
+      MDBX_node *node = page_node(mp, i);
+      switch (node_flags(node)) {
+      case F_BIGDATA:
+        rc = page_retire_ex(mc, node_largedata_pgno(node), nullptr, 0);
+        if (unlikely(rc != MDBX_SUCCESS))
+          return rc;
+        items += 1;
+        break;
+      case F_SUBDATA | F_DUPDATA:
+        rc = cursor_xinit1(mc, node, mp);
+        if (unlikely(rc != MDBX_SUCCESS))
+          return rc;
+        items += (size_t)mc->mc_xcursor->mx_db.md_entries;
+        rc = drop_tree(&mc->mc_xcursor->mx_cursor, false);
+        if (unlikely(rc != MDBX_SUCCESS))
+          return rc;
+        break;
+      case F_DUPDATA:
+        items += page_numkeys((const MDBX_page *)node_data(node));
+        break;
+      case 0:
+        items += 1;
+        break;
+      default:
+        return /* disallowing implicit subDB deletion */ MDBX_INCOMPATIBLE;
+      }
+    }
+  } else
+    outer_db(mc)->md_entries -= items;
+  db->md_entries -= items;
+
+  rc = page_retire(mc, mp);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  if (mc->mc_snum == 1 && mc->mc_pg[0] == mp) {
+    /* the root leaf, i.e. the last page of the tree */
+    cASSERT(mc, db->md_entries == 0 && db->md_branch_pages == 0 &&
+                    db->md_leaf_pages == 0 && db->md_overflow_pages == 0);
+    db->md_root = P_INVALID;
+    db->md_depth = 0;
+    mc->mc_snum = 0;
+    mc->mc_top = 0;
+    mc->mc_flags &= ~C_INITIALIZED;
+    return MDBX_SUCCESS;
+  }
+  node_del(mc, 0);
+  return rebalance(mc);
+}
+
+/* Shrinks the nested tree of the i-th node of the rightmost leaf, which
+ * makes the leaf dirty. This is used only when the nested trees of the leaf
+ * don't fit into the budget, otherwise the leaf is released as a whole. */
+static int drop_tail_nested(MDBX_cursor *mc, size_t i, size_t *budget) {
+  int rc = cursor_touch(mc);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  MDBX_page *const mp = mc->mc_pg[mc->mc_top];
+  MDBX_node *const node = page_node(mp, i);
+  rc = cursor_xinit1(mc, node, mp);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  MDBX_xcursor *const mx = mc->mc_xcursor;
+  const size_t pages = mx->mx_db.md_branch_pages + mx->mx_db.md_leaf_pages;
+  if (i > 0 && pages <= *budget) {
+    /* the last node can't be deleted, since the leaf would become empty */
+    const size_t items = (size_t)mx->mx_db.md_entries;
+    rc = drop_tree(&mx->mx_cursor, false);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+    mc->mc_db->md_entries -= items;
+    mc->mc_ki[mc->mc_top] = (indx_t)i;
+    node_del(mc, 0);
+    return MDBX_SUCCESS;
+  }
+
+  rc = drop_tail(&mx->mx_cursor, budget);
+  if (likely(rc == MDBX_SUCCESS)) {
+    mx->mx_db.md_mod_txnid = mc->mc_txn->mt_txnid;
+    memcpy(node_data(node), &mx->mx_db, sizeof(MDBX_db));
+  }
+  return rc;
+}
+
+/* Releases the pages from the tail of a detached b-tree until the budget is
+ * exhausted. The leaves are retired as a whole, so the budget could be
+ * exceeded by large pages of the last one and by emptied branch pages. */
+static int drop_tail(MDBX_cursor *mc, size_t *budget) {
+  MDBX_db *const db = mc->mc_db;
+  while (*budget && db->md_root != P_INVALID) {
+    /* the nested tree is released along with its node by the caller */
+    if ((mc->mc_flags & C_SUB) && db->md_depth < 2)
+      break;
+    /* the room was reserved by drop_reclaim_tree(), just stop if exhausted */
+    if (mc->mc_txn->tw.dirtylist && mc->mc_txn->tw.dirtyroom < CURSOR_STACK * 2)
+      break;
+
+    int rc = page_search(mc, NULL, MDBX_PS_LAST);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+
+    const MDBX_page *const mp = mc->mc_pg[mc->mc_top];
+    size_t nested = 0, last = 0;
+    if (!IS_LEAF2(mp)) {
+      const size_t nkeys = page_numkeys(mp);
+      for (size_t i = 0; i < nkeys; i++) {
+        const MDBX_node *node = page_node(mp, i);
+        if (node_flags(node) & F_SUBDATA) {
+          MDBX_db sub;
+          if (unlikely(node_ds(node) != sizeof(MDBX_db)))
+            return MDBX_CORRUPTED;
+          memcpy(&sub, node_data(node), sizeof(sub));
+          nested += sub.md_branch_pages + sub.md_leaf_pages;
+          last = i;
+        }
+      }
+    }
+
+    const size_t before =
+        db->md_branch_pages + db->md_leaf_pages + db->md_overflow_pages;
+    rc = (nested <= *budget) ? drop_tail_leaf(mc)
+                             : drop_tail_nested(mc, last, budget);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+    const size_t released = before - (db->md_branch_pages + db->md_leaf_pages +
+                                      db->md_overflow_pages);
+    *budget = (released < *budget) ? *budget - released : 0;
+  }
+  return MDBX_SUCCESS;
+}
+
+/* Releases up to the budget pages of the b-tree queued by
+ * mdbx_drop_deferred(), i.e. of the stored record without a DBI-handle. */
+static int drop_reclaim_tree(MDBX_txn *txn, MDBX_db *db, size_t *budget) {
+  MDBX_dbx dbx;
+  memset(&dbx, 0, sizeof(dbx));
+  uint8_t dbistate = DBI_VALID | DBI_DIRTY;
+  MDBX_cursor_couple couple;
+  int rc = couple_init(&couple, MAIN_DBI, txn, db, &dbx, &dbistate);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  /* Spilling keeps the pages of tracked cursors, so reserve the room
+   * before the cursors of the main DB are detached below. */
+  if (txn->tw.dirtylist) {
+    rc = txn_spill(txn, &couple.outer, CURSOR_STACK * 4);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+  }
+
+  /* The pages of the tree are not reachable by any other cursor,
+   * so track the only one during the rebalancing. */
+  txn->mt_flags |= MDBX_TXN_DIRTY;
+  MDBX_cursor *const tracked = txn->mt_cursors[MAIN_DBI];
+  txn->mt_cursors[MAIN_DBI] = &couple.outer;
+  const MDBX_db origin = *db;
+  const size_t retired = MDBX_PNL_GETSIZE(txn->tw.retired_pages);
+  rc = drop_tail(&couple.outer, budget);
+  txn->mt_cursors[MAIN_DBI] = tracked;
+
+  if (memcmp(&origin, db, sizeof(MDBX_db)) != 0 ||
+      retired != MDBX_PNL_GETSIZE(txn->tw.retired_pages)) {
+    db->md_mod_txnid = txn->mt_txnid;
+    /* the tree could be left inconsistent */
+    if (unlikely(rc != MDBX_SUCCESS))
+      txn->mt_flags |= MDBX_TXN_ERROR;
+  }
+  return rc;
+}
+
+static bool drop_deferred_key(const MDBX_val *key) {
+  return key->iov_len > sizeof(DROP_DEFERRED_PREFIX) - 1 &&
+         memcmp(key->iov_base, DROP_DEFERRED_PREFIX,
+                sizeof(DROP_DEFERRED_PREFIX) - 1) == 0;
+}
+
+static int drop_reclaim(MDBX_txn *txn, size_t budget, size_t *left) {
+  MDBX_cursor_couple couple;
+  MDBX_val key, data;
+  int rc;
+  while (true) {
+    rc = cursor_init(&couple.outer, txn, MAIN_DBI);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+    key.iov_base = DROP_DEFERRED_PREFIX;
+    key.iov_len = sizeof(DROP_DEFERRED_PREFIX) - 1;
+    rc = cursor_set(&couple.outer, &key, &data, MDBX_SET_RANGE).err;
+    if (!budget || rc != MDBX_SUCCESS || !drop_deferred_key(&key))
+      break;
+
+    char name[sizeof(DROP_DEFERRED_PREFIX) + 32];
+    MDBX_db db;
+    if (unlikely(key.iov_len >= sizeof(name) ||
+                 data.iov_len != sizeof(MDBX_db)))
+      return MDBX_CORRUPTED;
+    memcpy(name, key.iov_base, key.iov_len);
+    key.iov_base = name;
+    memcpy(&db, data.iov_base, sizeof(db));
+    rc = drop_reclaim_tree(txn, &db, &budget);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+
+    if (db.md_root == P_INVALID)
+      rc = delete (txn, MAIN_DBI, &key, NULL, F_SUBDATA);
+    else {
+      data.iov_base = &db;
+      data.iov_len = sizeof(db);
+      rc = cursor_init(&couple.outer, txn, MAIN_DBI);
+      if (likely(rc == MDBX_SUCCESS))
+        WITH_CURSOR_TRACKING(couple.outer,
+                             rc = mdbx_cursor_put(&couple.outer, &key, &data,
+                                                  F_SUBDATA));
+    }
+    if (unlikely(rc != MDBX_SUCCESS)) {
+      txn->mt_flags |= MDBX_TXN_ERROR;
+      return rc;
+    }
+  }
+
+  size_t pending = 0;
+  while (rc == MDBX_SUCCESS && drop_deferred_key(&key)) {
+    if (unlikely(data.iov_len != sizeof(MDBX_db)))
+      return MDBX_CORRUPTED;
+    MDBX_db db;
+    memcpy(&db, data.iov_base, sizeof(db));
+    pending += db.md_branch_pages + db.md_leaf_pages + db.md_overflow_pages;
+    rc = cursor_next(&couple.outer, &key, &data, MDBX_NEXT);
+  }
+  if (unlikely(rc != MDBX_SUCCESS && rc != MDBX_NOTFOUND))
+    return rc;
+
+  if (!pending)
+    txn->mt_env->me_drop_pending = false;
+  if (left)
+    *left = pending;
+  return MDBX_SUCCESS;
+}
+
+int mdbx_drop_reclaim(MDBX_txn *txn, size_t budget_pages, size_t *left_pages) {
+  int rc = check_txn_rw(txn, MDBX_TXN_BLOCKED);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  return drop_reclaim(txn, budget_pages, left_pages);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Change feed */
+
+/* Name of the hidden table with the change feed. The records are keyed by
+ * txnid, and consist of the entries for the changed tables, each is the
+ * changefeed_entry_t header followed by the name and the begin/end keys. */
+#define CHANGEFEED_NAME MDBX_HIDDEN_TABLE_PREFIX "changes"
+
+typedef struct changefeed_entry {
+  uint32_t name_len;
+  uint32_t begin_len, end_len /* CHANGEFEED_WHOLE for the whole table */;
+} changefeed_entry_t;
+
+#define CHANGEFEED_WHOLE UINT32_MAX
+
+/* Returns the tracking record of a table, resetting all ones at the first
+ * change made by a write txn. */
+static MDBX_changed *changefeed_table(MDBX_txn *txn, size_t dbi) {
+  MDBX_env *const env = txn->mt_env;
+  if (env->me_changefeed.txnid != txn->mt_txnid) {
+    if (!env->me_changefeed.tables) {
+      env->me_changefeed.tables =
+          osal_calloc(env->me_maxdbs, sizeof(MDBX_changed));
+      if (unlikely(!env->me_changefeed.tables))
+        return nullptr;
+    } else {
+      for (size_t i = 0; i < env->me_maxdbs; ++i)
+        env->me_changefeed.tables[i].state = CHANGED_NONE;
+    }
+    env->me_changefeed.dropped.iov_len = 0;
+    env->me_changefeed.txnid = txn->mt_txnid;
+  }
+  return &env->me_changefeed.tables[dbi];
+}
+
+static bool changefeed_keep(MDBX_val *dst, size_t *room, const MDBX_val *key) {
+  if (key->iov_len > *room) {
+    const size_t bytes = ceil_powerof2(key->iov_len, 64);
+    void *const ptr = osal_realloc(dst->iov_base, bytes);
+    if (unlikely(!ptr))
+      return false;
+    dst->iov_base = ptr;
+    *room = bytes;
+  }
+  if (key->iov_len)
+    memcpy(dst->iov_base, key->iov_base, key->iov_len);
+  dst->iov_len = key->iov_len;
+  return true;
+}
+
+/* Extends the range of keys modified within the cursor's table. On a lack of
+ * memory for a copy of the key the whole table is considered as changed. */
+static int changefeed_track(MDBX_cursor *mc, const MDBX_val *key) {
+  MDBX_changed *const ch = changefeed_table(mc->mc_txn, mc->mc_dbi);
+  if (unlikely(!ch))
+    return MDBX_ENOMEM;
+  if (ch->state == CHANGED_WHOLE)
+    return MDBX_SUCCESS;
+
+  if (!mc->mc_txn->mt_env->me_options.changefeed_ranges)
+    ch->state = CHANGED_WHOLE;
+  else if (ch->state == CHANGED_NONE)
+    ch->state = (changefeed_keep(&ch->begin, &ch->begin_room, key) &&
+                 changefeed_keep(&ch->end, &ch->end_room, key))
+                    ? CHANGED_KEYS
+                    : CHANGED_WHOLE;
+  else if (mc->mc_dbx->md_cmp(key, &ch->begin) < 0) {
+    if (unlikely(!changefeed_keep(&ch->begin, &ch->begin_room, key)))
+      ch->state = CHANGED_WHOLE;
+  } else if (mc->mc_dbx->md_cmp(key, &ch->end) > 0) {
+    if (unlikely(!changefeed_keep(&ch->end, &ch->end_room, key)))
+      ch->state = CHANGED_WHOLE;
+  }
+  return MDBX_SUCCESS;
+}
+
+/* Tracks the key at the cursor's position, which is going to be deleted. */
+static int changefeed_track_current(MDBX_cursor *mc) {
+  const MDBX_page *const mp = mc->mc_pg[mc->mc_top];
+  const size_t ki = mc->mc_ki[mc->mc_top];
+  MDBX_val key;
+  if (IS_LEAF2(mp)) {
+    key.iov_len = mc->mc_db->md_xsize;
+    key.iov_base = page_leaf2key(mp, ki, key.iov_len);
+  } else {
+    const MDBX_node *const node = page_node(mp, ki);
+    /* the records of named tables are tracked by changefeed_drop() */
+    if (mc->mc_dbi == MAIN_DBI &&
+        (node_flags(node) & (F_SUBDATA | F_DUPDATA)) == F_SUBDATA)
+      return MDBX_SUCCESS;
+    get_key(node, &key);
+  }
+  return changefeed_track(mc, &key);
+}
+
+/* Notes a table which is emptied or deleted, by mdbx_drop() and so on. */
+static int changefeed_drop(MDBX_txn *txn, size_t dbi, bool del) {
+  MDBX_changed *const ch = changefeed_table(txn, dbi);
+  if (unlikely(!ch))
+    return MDBX_ENOMEM;
+  if (!del || dbi < CORE_DBS) {
+    ch->state = CHANGED_WHOLE;
+    return MDBX_SUCCESS;
+  }
+
+  /* The handle will be closed, so save the name of the deleted table
+   * as a ready entry of the record. */
+  ch->state = CHANGED_NONE;
+  const MDBX_val *const name = &txn->mt_dbxs[dbi].md_name;
+  if (hidden_table(name))
+    return MDBX_SUCCESS;
+  MDBX_val *const dropped = &txn->mt_env->me_changefeed.dropped;
+  const size_t bytes =
+      dropped->iov_len + sizeof(changefeed_entry_t) + name->iov_len;
+  if (bytes > txn->mt_env->me_changefeed.dropped_room) {
+    const size_t room = ceil_powerof2(bytes * 2, 256);
+    void *const ptr = osal_realloc(dropped->iov_base, room);
+    if (unlikely(!ptr))
+      return MDBX_ENOMEM;
+    dropped->iov_base = ptr;
+    txn->mt_env->me_changefeed.dropped_room = room;
+  }
+  changefeed_entry_t entry;
+  entry.name_len = (uint32_t)name->iov_len;
+  entry.begin_len = entry.end_len = CHANGEFEED_WHOLE;
+  char *ptr = (char *)dropped->iov_base + dropped->iov_len;
+  memcpy(ptr, &entry, sizeof(entry));
+  memcpy(ptr + sizeof(entry), name->iov_base, name->iov_len);
+  dropped->iov_len = bytes;
+  return MDBX_SUCCESS;
+}
+
+/* Returns the tracked range of keys if the table should be reported. */
+static const MDBX_changed *changefeed_changed(const MDBX_txn *txn, size_t dbi,
+                                              bool tracked) {
+  static const MDBX_changed whole = {CHANGED_WHOLE, {nullptr, 0},
+                                     {nullptr, 0}, 0, 0};
+  const MDBX_changed *const ch =
+      tracked ? &txn->mt_env->me_changefeed.tables[dbi] : nullptr;
+  if (dbi < CORE_DBS)
+    return (ch && ch->state != CHANGED_NONE) ? ch : nullptr;
+  if (!(txn->mt_dbistate[dbi] & DBI_VALID) ||
+      !txn->mt_dbxs[dbi].md_name.iov_base ||
+      hidden_table(&txn->mt_dbxs[dbi].md_name))
+    return nullptr;
+  if (ch && ch->state != CHANGED_NONE)
+    return ch;
+  /* e.g. the table was created or its sequence was changed */
+  return (txn->mt_dbistate[dbi] & DBI_DIRTY) ? &whole : nullptr;
+}
+
+/* Appends the record of the tables changed by the committing txn to the
+ * change feed, and deletes a few outdated records. */
+static int changefeed_commit(MDBX_txn *txn) {
+  MDBX_env *const env = txn->mt_env;
+  const bool tracked =
+      env->me_changefeed.txnid == txn->mt_txnid && env->me_changefeed.tables;
+  size_t bytes = tracked ? env->me_changefeed.dropped.iov_len : 0;
+  for (size_t dbi = MAIN_DBI; dbi < txn->mt_numdbs; ++dbi) {
+    const MDBX_changed *const ch = changefeed_changed(txn, dbi, tracked);
+    if (ch)
+      bytes += sizeof(changefeed_entry_t) +
+               ((dbi < CORE_DBS) ? 0 : txn->mt_dbxs[dbi].md_name.iov_len) +
+               ((ch->state == CHANGED_KEYS)
+                    ? ch->begin.iov_len + ch->end.iov_len
+                    : 0);
+  }
+
+  const MDBX_dbi feed = env->me_changefeed.dbi;
+  if (unlikely(!check_dbi(txn, feed, DBI_VALID)))
+    return MDBX_BAD_DBI;
+  MDBX_cursor *mc;
+  int rc = mdbx_cursor_open(txn, feed, &mc);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  uint64_t txnid = txn->mt_txnid;
+  MDBX_val key, data;
+  key.iov_base = &txnid;
+  key.iov_len = sizeof(txnid);
+  data.iov_len = bytes;
+  rc = mdbx_cursor_put(mc, &key, &data, MDBX_RESERVE);
+  if (unlikely(rc != MDBX_SUCCESS))
+    goto bailout;
+
+  char *ptr = data.iov_base;
+  for (size_t dbi = MAIN_DBI; dbi < txn->mt_numdbs; ++dbi) {
+    const MDBX_changed *const ch = changefeed_changed(txn, dbi, tracked);
+    if (!ch)
+      continue;
+    const MDBX_val *const name = &txn->mt_dbxs[dbi].md_name;
+    changefeed_entry_t entry;
+    entry.name_len = (dbi < CORE_DBS) ? 0 : (uint32_t)name->iov_len;
+    entry.begin_len = entry.end_len = CHANGEFEED_WHOLE;
+    if (ch->state == CHANGED_KEYS) {
+      entry.begin_len = (uint32_t)ch->begin.iov_len;
+      entry.end_len = (uint32_t)ch->end.iov_len;
+    }
+    memcpy(ptr, &entry, sizeof(entry));
+    ptr += sizeof(entry);
+    if (entry.name_len)
+      ptr = (char *)memcpy(ptr, name->iov_base, entry.name_len) +
+            entry.name_len;
+    if (ch->state == CHANGED_KEYS) {
+      if (entry.begin_len)
+        ptr = (char *)memcpy(ptr, ch->begin.iov_base, entry.begin_len) +
+              entry.begin_len;
+      if (entry.end_len)
+        ptr = (char *)memcpy(ptr, ch->end.iov_base, entry.end_len) +
+              entry.end_len;
+    }
+  }
+  if (tracked && env->me_changefeed.dropped.iov_len)
+    ptr = (char *)memcpy(ptr, env->me_changefeed.dropped.iov_base,
+                         env->me_changefeed.dropped.iov_len) +
+          env->me_changefeed.dropped.iov_len;
+  tASSERT(txn, ptr == (char *)data.iov_base + bytes);
+
+  /* Delete the records beyond the limit, but only a few at once to avoid
+   * a stall after the limit was reduced */
+  const uint64_t span =
+      (uint64_t)env->me_options.changefeed_limit * xMDBX_TXNID_STEP;
+  for (size_t n = 0; n < 16 && txn->mt_txnid > span; ++n) {
+    rc = mdbx_cursor_get(mc, &key, &data, MDBX_FIRST);
+    if (unlikely(rc != MDBX_SUCCESS))
+      break;
+    if (unlikely(key.iov_len != sizeof(uint64_t))) {
+      rc = MDBX_CORRUPTED;
+      break;
+    }
+    if (unaligned_peek_u64(1, key.iov_base) > txn->mt_txnid - span)
+      break;
+    rc = mdbx_cursor_del(mc, 0);
     if (unlikely(rc != MDBX_SUCCESS))
-      txn->mt_flags |= MDBX_TXN_ERROR;
-  } else if (rc == MDBX_NOTFOUND) {
-    rc = MDBX_SUCCESS;
+      break;
   }
-  mc->mc_flags &= ~C_INITIALIZED;
+
+bailout:
+  mdbx_cursor_close(mc);
   return rc;
 }
 
-int mdbx_drop(MDBX_txn *txn, MDBX_dbi dbi, bool del) {
-  int rc = check_txn_rw(txn, MDBX_TXN_BLOCKED);
+/* Opens the change feed table once the recording is enabled, so the commits
+ * use the handle kept in the env instead of looking for the table. */
+static int changefeed_open(MDBX_env *env) {
+  MDBX_txn *txn;
+  int rc = mdbx_txn_begin(env, nullptr, MDBX_TXN_READWRITE, &txn);
   if (unlikely(rc != MDBX_SUCCESS))
     return rc;
+  MDBX_dbi feed;
+  rc = dbi_open(txn, CHANGEFEED_NAME, MDBX_CREATE | MDBX_INTEGERKEY, &feed,
+                nullptr, nullptr);
+  if (unlikely(rc != MDBX_SUCCESS)) {
+    mdbx_txn_abort(txn);
+    return rc;
+  }
+  /* the creation of the table is recorded by the feed as well */
+  env->me_changefeed.dbi = feed;
+  rc = mdbx_txn_commit(txn);
+  if (unlikely(rc != MDBX_SUCCESS))
+    env->me_changefeed.dbi = 0;
+  return rc;
+}
 
-  MDBX_cursor *mc;
-  rc = mdbx_cursor_open(txn, dbi, &mc);
+/* Passes the entries of a change feed record to the callback. */
+static int changefeed_parse(const MDBX_val *record, uint64_t txnid,
+                            MDBX_changes_func *func, void *ctx) {
+  const char *ptr = record->iov_base;
+  const char *const end = ptr + record->iov_len;
+  while (ptr < end) {
+    changefeed_entry_t entry;
+    if (unlikely((size_t)(end - ptr) < sizeof(entry)))
+      return MDBX_CORRUPTED;
+    memcpy(&entry, ptr, sizeof(entry));
+    ptr += sizeof(entry);
+    const bool whole = entry.begin_len == CHANGEFEED_WHOLE;
+    const size_t bytes =
+        (size_t)entry.name_len +
+        (whole ? 0 : (size_t)entry.begin_len + (size_t)entry.end_len);
+    if (unlikely(whole != (entry.end_len == CHANGEFEED_WHOLE) ||
+                 (size_t)(end - ptr) < bytes))
+      return MDBX_CORRUPTED;
+
+    MDBX_val table, begin = {nullptr, 0}, last = {nullptr, 0};
+    table.iov_base = (void *)ptr;
+    table.iov_len = entry.name_len;
+    ptr += entry.name_len;
+    if (!whole) {
+      begin.iov_base = (void *)ptr;
+      begin.iov_len = entry.begin_len;
+      ptr += entry.begin_len;
+      last.iov_base = (void *)ptr;
+      last.iov_len = entry.end_len;
+      ptr += entry.end_len;
+    }
+    const int rc = func(ctx, txnid, &table, whole ? nullptr : &begin,
+                        whole ? nullptr : &last);
+    if (rc != MDBX_SUCCESS)
+      return rc;
+  }
+  return MDBX_SUCCESS;
+}
+
+int mdbx_changes_enum(MDBX_txn *txn, uint64_t since, MDBX_changes_func *func,
+                      void *ctx) {
+  int rc = check_txn(txn, MDBX_TXN_BLOCKED);
   if (unlikely(rc != MDBX_SUCCESS))
     return rc;
+  if (unlikely(!func))
+    return MDBX_EINVAL;
 
-  rc = drop_tree(mc,
-                 dbi == MAIN_DBI || (mc->mc_db->md_flags & MDBX_DUPSORT) != 0);
-  /* Invalidate the dropped DB's cursors */
-  for (MDBX_cursor *m2 = txn->mt_cursors[dbi]; m2; m2 = m2->mc_next)
-    m2->mc_flags &= ~(C_INITIALIZED | C_EOF);
-  if (unlikely(rc))
-    goto bailout;
+  /* the last transaction which is visible to the given one */
+  const txnid_t upto = (txn->mt_flags & MDBX_TXN_RDONLY)
+                           ? txn->mt_txnid
+                           : txn->mt_txnid - xMDBX_TXNID_STEP;
+  if (since >= upto)
+    return MDBX_SUCCESS;
 
-  /* Can't delete the main DB */
-  if (del && dbi >= CORE_DBS) {
-    rc = delete (txn, MAIN_DBI, &mc->mc_dbx->md_name, NULL, F_SUBDATA);
-    if (likely(rc == MDBX_SUCCESS)) {
-      tASSERT(txn, txn->mt_dbistate[MAIN_DBI] & DBI_DIRTY);
-      tASSERT(txn, txn->mt_flags & MDBX_TXN_DIRTY);
-      txn->mt_dbistate[dbi] = DBI_STALE;
-      MDBX_env *env = txn->mt_env;
-      rc = osal_fastmutex_acquire(&env->me_dbi_lock);
-      if (unlikely(rc != MDBX_SUCCESS)) {
-        txn->mt_flags |= MDBX_TXN_ERROR;
-        goto bailout;
-      }
-      dbi_close_locked(env, dbi);
-      ENSURE(env, osal_fastmutex_release(&env->me_dbi_lock) == MDBX_SUCCESS);
-    } else {
-      txn->mt_flags |= MDBX_TXN_ERROR;
-    }
-  } else {
-    /* reset the DB record, mark it dirty */
-    txn->mt_dbistate[dbi] |= DBI_DIRTY;
-    txn->mt_dbs[dbi].md_depth = 0;
-    txn->mt_dbs[dbi].md_branch_pages = 0;
-    txn->mt_dbs[dbi].md_leaf_pages = 0;
-    txn->mt_dbs[dbi].md_overflow_pages = 0;
-    txn->mt_dbs[dbi].md_entries = 0;
-    txn->mt_dbs[dbi].md_root = P_INVALID;
-    txn->mt_dbs[dbi].md_seq = 0;
-    txn->mt_flags |= MDBX_TXN_DIRTY;
-  }
+  MDBX_dbi feed;
+  rc = dbi_open(txn, CHANGEFEED_NAME, MDBX_DB_ACCEDE, &feed, nullptr, nullptr);
+  if (rc == MDBX_NOTFOUND)
+    return MDBX_RESULT_TRUE /* the change feed was never recorded */;
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  MDBX_cursor_couple couple;
+  rc = cursor_init(&couple.outer, txn, feed);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
 
-bailout:
-  mdbx_cursor_close(mc);
-  return rc;
+  uint64_t from = since + 1;
+  MDBX_val key, data;
+  key.iov_base = &from;
+  key.iov_len = sizeof(from);
+  txnid_t expected = since + xMDBX_TXNID_STEP;
+  bool gap = false;
+  rc = cursor_set(&couple.outer, &key, &data, MDBX_SET_RANGE).err;
+  while (rc == MDBX_SUCCESS) {
+    if (unlikely(key.iov_len != sizeof(uint64_t)))
+      return MDBX_CORRUPTED;
+    const txnid_t txnid = unaligned_peek_u64(1, key.iov_base);
+    if (txnid > upto)
+      break;
+    gap |= txnid != expected;
+    expected = txnid + xMDBX_TXNID_STEP;
+    rc = changefeed_parse(&data, txnid, func, ctx);
+    if (rc != MDBX_SUCCESS)
+      return rc;
+    rc = cursor_next(&couple.outer, &key, &data, MDBX_NEXT);
+  }
+  if (unlikely(rc != MDBX_SUCCESS && rc != MDBX_NOTFOUND))
+    return rc;
+  return (gap || expected <= upto) ? MDBX_RESULT_TRUE : MDBX_SUCCESS;
 }
 
 int mdbx_set_compare(MDBX_txn *txn, MDBX_dbi dbi, MDBX_cmp_func *cmp) {
@@ -22160,6 +25662,7 @@ __cold MDBX_INTERNAL_FUNC int cleanup_dead_readers(MDBX_env *env,
         DEBUG("clear stale reader pid %" PRIuPTR " txn %" PRIaTXN, (size_t)pid,
               lck->mti_readers[j].mr_txnid.weak);
         atomic_store32(&lck->mti_readers[j].mr_pid, 0, mo_Relaxed);
+        rgroup_leave(lck, &lck->mti_readers[j]);
         atomic_store32(&lck->mti_readers_refresh_flag, true, mo_AcquireRelease);
         count++;
       }
@@ -22276,9 +25779,11 @@ __cold static txnid_t kick_longlived_readers(MDBX_env *env,
         atomic_store64(&stucked->mr_tid, 0, mo_Relaxed);
         atomic_store32(&stucked->mr_pid, 0, mo_AcquireRelease);
       }
+      rgroup_leave(env->me_lck, stucked);
     } else if (!notify_eof_of_loop) {
 #if MDBX_ENABLE_PROFGC
-      env->me_lck->mti_pgop_stat.gc_prof.kicks += 1;
+      if (unlikely(env->me_options.gc_profiling))
+        env->me_lck->mti_pgop_stat.gc_prof.kicks += 1;
 #endif /* MDBX_ENABLE_PROFGC */
       notify_eof_of_loop = true;
     }
@@ -23751,7 +27256,7 @@ __cold int mdbx_env_set_option(MDBX_env *env, const MDBX_option_t option,
       return MDBX_EINVAL;
     if (unlikely(env->me_map))
       return MDBX_EPERM;
-    env->me_maxreaders = (unsigned)value;
+    env->me_maxreaders.weak = (unsigned)value;
     break;
 
   case MDBX_opt_dp_reserve_limit:
@@ -23841,6 +27346,11 @@ __cold int mdbx_env_set_option(MDBX_env *env, const MDBX_option_t option,
       return MDBX_EINVAL;
     env->me_options.spill_parent4child_denominator = (uint8_t)value;
     break;
+  case MDBX_opt_spill_policy:
+    if (unlikely(value > MDBX_SPILL_ADAPTIVE))
+      return MDBX_EINVAL;
+    env->me_options.spill_policy = (uint8_t)value;
+    break;
 
   case MDBX_opt_loose_limit:
     if (value == UINT64_MAX)
@@ -23859,6 +27369,89 @@ __cold int mdbx_env_set_option(MDBX_env *env, const MDBX_option_t option,
     recalculate_merge_threshold(env);
     break;
 
+  case MDBX_opt_drop_reclaim_budget:
+    if (value == UINT64_MAX)
+      value = MAX_PAGENO;
+    if (unlikely(value > MAX_PAGENO))
+      return MDBX_EINVAL;
+    env->me_options.drop_reclaim_budget = (unsigned)value;
+    break;
+
+  case MDBX_opt_gc_profiling:
+    if (unlikely(value > 1))
+      return MDBX_EINVAL;
+    if (unlikely(!MDBX_ENABLE_PROFGC) && value)
+      return MDBX_ENOSYS;
+    env->me_options.gc_profiling = (uint8_t)value;
+    break;
+
+  case MDBX_opt_writer_fairness:
+    if (unlikely(value > 1))
+      return MDBX_EINVAL;
+#if defined(_WIN32) || defined(_WIN64)
+    if (value)
+      return MDBX_ENOSYS;
+#endif /* Windows */
+    env->me_options.writer_fairness = (uint8_t)value;
+    break;
+
+  case MDBX_opt_readers_growth_limit:
+    if (value == UINT64_MAX)
+      value = MDBX_READERS_LIMIT;
+    if (unlikely(value > MDBX_READERS_LIMIT))
+      return MDBX_EINVAL;
+#if defined(_WIN32) || defined(_WIN64)
+    if (value)
+      return MDBX_ENOSYS;
+#endif /* Windows */
+    env->me_options.readers_growth_limit = (unsigned)value;
+    break;
+
+  case MDBX_opt_dead_readers_watch:
+    if (value == UINT64_MAX)
+      value = UINT32_MAX;
+    if (unlikely(value > UINT32_MAX))
+      return MDBX_TOO_LARGE;
+    if (unlikely(!(env->me_flags & MDBX_ENV_ACTIVE)))
+      return MDBX_EPERM;
+    if (value != env->me_options.rwatch_period_16dot16) {
+      err = osal_rpid_watch(env, (unsigned)value);
+      /* a running watcher is stopped even on failure */
+      env->me_options.rwatch_period_16dot16 =
+          (err == MDBX_SUCCESS) ? (unsigned)value : 0;
+    }
+    break;
+
+  case MDBX_opt_changefeed_limit:
+  case MDBX_opt_changefeed_ranges:
+    if (value == UINT64_MAX)
+      value = (option == MDBX_opt_changefeed_ranges) ? 1 : UINT32_MAX;
+    if (unlikely(value >
+                 ((option == MDBX_opt_changefeed_ranges) ? 1 : UINT32_MAX)))
+      return MDBX_EINVAL;
+    if (unlikely(env->me_flags & MDBX_RDONLY))
+      return MDBX_EACCESS;
+    if (option == MDBX_opt_changefeed_limit && value && lock_needed &&
+        !env->me_changefeed.dbi) {
+      /* otherwise the table will be opened by mdbx_env_open() */
+      err = changefeed_open(env);
+      if (unlikely(err != MDBX_SUCCESS))
+        return err;
+    }
+    if (lock_needed) {
+      err = mdbx_txn_lock(env, false);
+      if (unlikely(err != MDBX_SUCCESS))
+        return err;
+      should_unlock = true;
+    }
+    if (env->me_txn)
+      err = MDBX_EPERM /* the changes of the running txn would be incomplete */;
+    else if (option == MDBX_opt_changefeed_ranges)
+      env->me_options.changefeed_ranges = (uint8_t)value;
+    else
+      env->me_options.changefeed_limit = (unsigned)value;
+    break;
+
   default:
     return MDBX_EINVAL;
   }
@@ -23896,7 +27489,14 @@ __cold int mdbx_env_get_option(const MDBX_env *env, const MDBX_option_t option,
     break;
 
   case MDBX_opt_max_readers:
-    *pvalue = env->me_maxreaders;
+    *pvalue = atomic_load32(&env->me_maxreaders, mo_Relaxed);
+    if (env->me_lck_mmap.lck) {
+      /* the readers table could be grown by other process */
+      const uint32_t capacity =
+          atomic_load32(&env->me_lck->mti_readers_capacity, mo_Relaxed);
+      if (*pvalue < capacity)
+        *pvalue = capacity;
+    }
     break;
 
   case MDBX_opt_dp_reserve_limit:
@@ -23923,6 +27523,9 @@ __cold int mdbx_env_get_option(const MDBX_env *env, const MDBX_option_t option,
   case MDBX_opt_spill_parent4child_denominator:
     *pvalue = env->me_options.spill_parent4child_denominator;
     break;
+  case MDBX_opt_spill_policy:
+    *pvalue = env->me_options.spill_policy;
+    break;
 
   case MDBX_opt_loose_limit:
     *pvalue = env->me_options.dp_loose_limit;
@@ -23932,6 +27535,34 @@ __cold int mdbx_env_get_option(const MDBX_env *env, const MDBX_option_t option,
     *pvalue = env->me_options.merge_threshold_16dot16_percent;
     break;
 
+  case MDBX_opt_drop_reclaim_budget:
+    *pvalue = env->me_options.drop_reclaim_budget;
+    break;
+
+  case MDBX_opt_gc_profiling:
+    *pvalue = env->me_options.gc_profiling;
+    break;
+
+  case MDBX_opt_changefeed_limit:
+    *pvalue = env->me_options.changefeed_limit;
+    break;
+
+  case MDBX_opt_changefeed_ranges:
+    *pvalue = env->me_options.changefeed_ranges;
+    break;
+
+  case MDBX_opt_writer_fairness:
+    *pvalue = env->me_options.writer_fairness;
+    break;
+
+  case MDBX_opt_dead_readers_watch:
+    *pvalue = env->me_options.rwatch_period_16dot16;
+    break;
+
+  case MDBX_opt_readers_growth_limit:
+    *pvalue = env->me_options.readers_growth_limit;
+    break;
+
   default:
     return MDBX_EINVAL;
   }
@@ -23939,6 +27570,263 @@ __cold int mdbx_env_get_option(const MDBX_env *env, const MDBX_option_t option,
   return MDBX_SUCCESS;
 }
 
+typedef struct defrag_ctx {
+  MDBX_txn *txn;
+  uint64_t deadline;
+  size_t budget, moved;
+  pgno_t boundary;
+} defrag_ctx_t;
+
+static int defrag_tree(defrag_ctx_t *ctx, MDBX_cursor *mc);
+
+/* Relocates the frozen pages of the cursor's stack into the lowest free ones.
+ * Returns MDBX_RESULT_TRUE if the budget, the free pages below the top one,
+ * or the dirty room is exhausted. */
+static int defrag_touch(defrag_ctx_t *ctx, MDBX_cursor *mc) {
+  MDBX_txn *const txn = ctx->txn;
+  const size_t len = MDBX_PNL_GETSIZE(txn->tw.relist);
+  if ((ctx->moved && ctx->moved + mc->mc_snum > ctx->budget) ||
+      len < mc->mc_snum ||
+      txn->tw.relist[len - mc->mc_snum + 1] >= mc->mc_pg[mc->mc_top]->mp_pgno ||
+      (txn->tw.dirtylist &&
+       /* reserve for updating the records of nested trees */
+       txn->tw.dirtyroom < mc->mc_snum + CURSOR_STACK * 2u))
+    return MDBX_RESULT_TRUE;
+
+  /* the named tables are walked without DBI-handles, see defrag_leaf() */
+  txn->mt_flags |= MDBX_TXN_DIRTY;
+  const size_t before = MDBX_PNL_GETSIZE(txn->tw.retired_pages);
+  int rc = cursor_touch(mc);
+  ctx->moved += MDBX_PNL_GETSIZE(txn->tw.retired_pages) - before;
+  return rc;
+}
+
+/* Relocates the nested trees of the leaf page, i.e. the named tables and
+ * the nested dupsort trees, then updates the records of ones. */
+static int defrag_leaf(defrag_ctx_t *ctx, MDBX_cursor *mc) {
+  MDBX_txn *const txn = ctx->txn;
+  int rc = MDBX_SUCCESS;
+  for (size_t i = 0;
+       rc == MDBX_SUCCESS && i < page_numkeys(mc->mc_pg[mc->mc_top]); ++i) {
+    MDBX_page *const mp = mc->mc_pg[mc->mc_top];
+    MDBX_node *const node = page_node(mp, i);
+    const unsigned flags = node_flags(node);
+    if ((flags & F_SUBDATA) == 0)
+      continue;
+    if (unlikely(node_ds(node) != sizeof(MDBX_db)))
+      return MDBX_CORRUPTED;
+
+    MDBX_db db;
+    memcpy(&db, node_data(node), sizeof(MDBX_db));
+    const pgno_t root = db.md_root;
+    if (flags & F_DUPDATA) {
+      if (unlikely(!mc->mc_xcursor))
+        return MDBX_CORRUPTED;
+      mc->mc_ki[mc->mc_top] = (indx_t)i;
+      rc = cursor_xinit1(mc, node, mp);
+      if (unlikely(rc != MDBX_SUCCESS))
+        return rc;
+      mc->mc_xcursor->mx_cursor.mc_checking |= CC_SKIPORD;
+      rc = defrag_tree(ctx, &mc->mc_xcursor->mx_cursor);
+      db = mc->mc_xcursor->mx_db;
+    } else {
+      if (unlikely(mc->mc_db != &txn->mt_dbs[MAIN_DBI]))
+        return MDBX_CORRUPTED;
+      /* The named table is walked without a DBI-handle, since the custom
+       * comparators are unknown, but ones are not needed to move pages. */
+      MDBX_cursor_couple couple;
+      MDBX_dbx dbx = {.md_klen_min = INT_MAX};
+      uint8_t dbistate = DBI_VALID | DBI_DIRTY;
+      rc = couple_init(&couple, MAIN_DBI, txn, &db, &dbx, &dbistate);
+      if (likely(rc == MDBX_SUCCESS)) {
+        couple.outer.mc_checking |= CC_SKIPORD;
+        rc = defrag_tree(ctx, &couple.outer);
+      }
+    }
+    if (unlikely(MDBX_IS_ERROR(rc)))
+      return rc;
+
+    if (db.md_root != root) {
+      db.md_mod_txnid = txn->mt_txnid;
+      int err = cursor_touch(mc);
+      if (unlikely(err != MDBX_SUCCESS))
+        return err;
+      memcpy(node_data(page_node(mc->mc_pg[mc->mc_top], i)), &db,
+             sizeof(MDBX_db));
+    }
+  }
+  return rc;
+}
+
+/* Walks the subtree of the cursor's top page and relocates the frozen pages
+ * which are at or above the boundary. The leaf pages below the boundary are
+ * not read, unless ones may contain nested trees. */
+static int defrag_page(defrag_ctx_t *ctx, MDBX_cursor *mc) {
+  MDBX_txn *const txn = ctx->txn;
+  if (ctx->deadline && osal_monotime() > ctx->deadline)
+    return MDBX_RESULT_TRUE;
+
+  int rc = MDBX_SUCCESS;
+  if (mc->mc_pg[mc->mc_top]->mp_pgno >= ctx->boundary &&
+      !IS_MODIFIABLE(txn, mc->mc_pg[mc->mc_top])) {
+    rc = defrag_touch(ctx, mc);
+    if (rc != MDBX_SUCCESS)
+      return rc;
+  }
+
+  const bool nested = mc->mc_xcursor || mc->mc_db == &txn->mt_dbs[MAIN_DBI];
+  if (IS_LEAF(mc->mc_pg[mc->mc_top]))
+    return nested ? defrag_leaf(ctx, mc) : MDBX_SUCCESS;
+
+  const bool to_leaves = mc->mc_snum + 1u >= mc->mc_db->md_depth;
+  for (size_t i = 0; i < page_numkeys(mc->mc_pg[mc->mc_top]); ++i) {
+    const MDBX_page *const mp = mc->mc_pg[mc->mc_top];
+    const pgno_t pgno = node_pgno(page_node(mp, i));
+    if (to_leaves && !nested && pgno < ctx->boundary)
+      continue;
+    MDBX_page *child;
+    rc = page_get(mc, pgno, &child, mp->mp_txnid);
+    if (unlikely(rc != MDBX_SUCCESS))
+      break;
+    mc->mc_ki[mc->mc_top] = (indx_t)i;
+    rc = cursor_push(mc, child);
+    if (unlikely(rc != MDBX_SUCCESS))
+      break;
+    rc = defrag_page(ctx, mc);
+    cursor_pop(mc);
+    if (rc != MDBX_SUCCESS)
+      break;
+  }
+  return rc;
+}
+
+static int defrag_tree(defrag_ctx_t *ctx, MDBX_cursor *mc) {
+  int rc = page_search(mc, nullptr, MDBX_PS_ROOTONLY);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return (rc == MDBX_NOTFOUND) ? MDBX_SUCCESS : rc;
+  mc->mc_flags |= C_DEFRAG;
+  return defrag_page(ctx, mc);
+}
+
+int mdbx_env_defrag(MDBX_env *env, size_t budget_pages,
+                    unsigned timeout_seconds_16dot16) {
+  int rc = check_env(env, true);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  if (unlikely(env->me_flags & MDBX_RDONLY))
+    return MDBX_EACCESS;
+  if (unlikely(budget_pages == 0))
+    return MDBX_EINVAL;
+  if (unlikely(env->me_txn0->mt_owner == osal_thread_self()))
+    return MDBX_BUSY;
+
+  defrag_ctx_t ctx;
+  ctx.deadline =
+      timeout_seconds_16dot16
+          ? osal_monotime() + osal_16dot16_to_monotime(timeout_seconds_16dot16)
+          : 0;
+  ctx.budget = budget_pages;
+  ctx.moved = 0;
+  rc = mdbx_txn_begin(env, nullptr, MDBX_TXN_READWRITE, &ctx.txn);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  MDBX_txn *txn = ctx.txn;
+  const pgno_t next_before = txn->mt_next_pgno;
+  MDBX_cursor_couple cx;
+  rc = cursor_init(&cx.outer, txn, MAIN_DBI);
+  if (unlikely(rc != MDBX_SUCCESS))
+    goto bailout;
+
+  /* Reclaim the GC to get the free holes */
+  while (MDBX_PNL_GETSIZE(txn->tw.relist) < env->me_options.rp_augment_limit) {
+    const pgr_t pr = page_alloc_slowpath(
+        &cx.outer, 0, MDBX_ALLOC_RESERVE | MDBX_ALLOC_UNIMPORTANT);
+    if (pr.err == MDBX_NOTFOUND)
+      break;
+    rc = pr.err;
+    if (unlikely(rc != MDBX_SUCCESS))
+      goto bailout;
+  }
+
+  /* The pages at or above the boundary could be fit into the free holes
+   * below ones, since the number of the free pages is the same. */
+  const size_t holes = MDBX_PNL_GETSIZE(txn->tw.relist);
+  tASSERT(txn, holes < txn->mt_next_pgno);
+  ctx.boundary = txn->mt_next_pgno - (pgno_t)holes;
+  if (txn->tw.dirtylist && ctx.budget > txn->tw.dirtyroom / 2)
+    ctx.budget = txn->tw.dirtyroom / 2;
+  VERBOSE("defrag: next %" PRIaPGNO ", holes %zu, boundary %" PRIaPGNO
+          ", budget %zu",
+          txn->mt_next_pgno, holes, ctx.boundary, ctx.budget);
+
+  /* Avoid the relocation of a few pages, which doesn't allow to shrink the
+   * datafile, e.g. when ones are freed by the concurrent write transactions */
+  const size_t threshold =
+      txn->mt_geo.shrink_pv ? pv2pages(txn->mt_geo.shrink_pv) : 0;
+  rc = (holes > threshold) ? defrag_tree(&ctx, &cx.outer) : MDBX_SUCCESS;
+  if (rc == MDBX_RESULT_TRUE)
+    rc = MDBX_SUCCESS;
+  /* Commit even if nothing was relocated, but the pages which were freed
+   * by the previous call have been refunded, or the datafile could be shrunk
+   * (see the conditions in sync_locked()) */
+  const pgno_t backlog_gap = 3 + txn->mt_dbs[FREE_DBI].md_depth * 3;
+  pgno_t txn_next = next_before;
+  if (rc == MDBX_SUCCESS &&
+      (ctx.moved || txn->mt_next_pgno < next_before ||
+       (threshold &&
+        txn->mt_geo.now - txn->mt_next_pgno > threshold + backlog_gap))) {
+    NOTICE("defrag: relocated %zu pages at or above %" PRIaPGNO
+           ", next %" PRIaPGNO " -> %" PRIaPGNO,
+           ctx.moved, ctx.boundary, next_before, txn->mt_next_pgno);
+    txn->mt_flags |= MDBX_TXN_DIRTY;
+    txn_next = txn->mt_next_pgno;
+    rc = mdbx_txn_commit(txn);
+    txn = nullptr;
+  }
+  if (rc == MDBX_SUCCESS && !ctx.moved && txn_next == next_before)
+    rc = MDBX_RESULT_TRUE;
+
+bailout:
+  if (txn) {
+    int err = mdbx_txn_abort(txn);
+    if (unlikely(err != MDBX_SUCCESS) && !MDBX_IS_ERROR(rc))
+      rc = err;
+  }
+  return rc;
+}
+
+int mdbx_env_wait_txnid(MDBX_env *env, uint64_t txnid,
+                        unsigned timeout_seconds_16dot16) {
+  int rc = check_env(env, true);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  if (unlikely(txnid > MAX_TXNID))
+    return MDBX_EINVAL;
+  MDBX_lockinfo *const lck = env->me_lck_mmap.lck;
+  if (unlikely(!lck))
+    return MDBX_EPERM;
+  if (unlikely(env->me_txn0 && env->me_txn0->mt_owner == osal_thread_self()))
+    return MDBX_BUSY;
+
+  const uint64_t deadline =
+      timeout_seconds_16dot16
+          ? osal_monotime() + osal_16dot16_to_monotime(timeout_seconds_16dot16)
+          : 0;
+  /* the increment is a full barrier, which is paired with the barrier after
+   * updating of mti_commit_txnid in sync_locked() */
+  atomic_add32(&lck->mti_commit_waiters, 1);
+  do {
+    const uint32_t seen =
+        atomic_load32(&lck->mti_commit_txnid, mo_AcquireRelease);
+    if (recent_committed_txnid(env) >= txnid)
+      break;
+    rc = osal_futex_wait(&lck->mti_commit_txnid.weak, seen, deadline);
+  } while (rc == MDBX_SUCCESS);
+  atomic_sub32(&lck->mti_commit_waiters, 1);
+  return rc;
+}
+
 static size_t estimate_rss(size_t database_bytes) {
   return database_bytes + database_bytes / 64 +
          (512 + MDBX_WORDBITS * 16) * MEGABYTE;
@@ -24410,6 +28298,9 @@ __dll_export
     #error "FIXME: Unsupported byte order"
 #endif /* __BYTE_ORDER__ */
     " MDBX_ENABLE_BIGFOOT=" MDBX_STRINGIFY(MDBX_ENABLE_BIGFOOT)
+    " MDBX_ENABLE_GC_EXTENTS=" MDBX_STRINGIFY(MDBX_ENABLE_GC_EXTENTS)
+    " MDBX_ENABLE_GC_GAPS=" MDBX_STRINGIFY(MDBX_ENABLE_GC_GAPS)
+    " MDBX_ENABLE_ALLOC_LOCALITY=" MDBX_STRINGIFY(MDBX_ENABLE_ALLOC_LOCALITY)
     " MDBX_ENV_CHECKPID=" MDBX_ENV_CHECKPID_CONFIG
     " MDBX_TXN_CHECKOWNER=" MDBX_TXN_CHECKOWNER_CONFIG
     " MDBX_64BIT_ATOMIC=" MDBX_64BIT_ATOMIC_CONFIG
@@ -24420,6 +28311,9 @@ __dll_export
     " MDBX_ENABLE_MADVISE=" MDBX_STRINGIFY(MDBX_ENABLE_MADVISE)
     " MDBX_ENABLE_PGOP_STAT=" MDBX_STRINGIFY(MDBX_ENABLE_PGOP_STAT)
     " MDBX_ENABLE_PROFGC=" MDBX_STRINGIFY(MDBX_ENABLE_PROFGC)
+    " MDBX_ENABLE_DPARENA=" MDBX_STRINGIFY(MDBX_ENABLE_DPARENA)
+    " MDBX_ENABLE_ASYNC_SPILL=" MDBX_STRINGIFY(MDBX_ENABLE_ASYNC_SPILL)
+    " MDBX_ENABLE_READERS_SHARDING=" MDBX_STRINGIFY(MDBX_ENABLE_READERS_SHARDING)
 #if MDBX_DISABLE_VALIDATION
     " MDBX_DISABLE_VALIDATION=YES"
 #endif /* MDBX_DISABLE_VALIDATION */
@@ -357,6 +357,45 @@ MDBX_MAYBE_UNUSED static __always_inline uint32_t atomic_load32(
 }
 #endif /* atomic_load32 */
 
+MDBX_MAYBE_UNUSED static __always_inline bool
+atomic_cas32(MDBX_atomic_uint32_t *p, uint32_t c, uint32_t v) {
+#ifdef MDBX_HAVE_C11ATOMICS
+  STATIC_ASSERT(sizeof(int) >= sizeof(uint32_t));
+  assert(atomic_is_lock_free(MDBX_c11a_rw(uint32_t, p)));
+  return atomic_compare_exchange_strong(MDBX_c11a_rw(uint32_t, p), &c, v);
+#elif defined(__GNUC__) || defined(__clang__)
+  return __sync_bool_compare_and_swap(&p->weak, c, v);
+#elif defined(_MSC_VER)
+  STATIC_ASSERT(sizeof(volatile long) == sizeof(volatile uint32_t));
+  return c ==
+         (uint32_t)_InterlockedCompareExchange((volatile long *)&p->weak, v, c);
+#elif defined(__APPLE__)
+  return OSAtomicCompareAndSwap32Barrier(c, v, &p->weak);
+#else
+#error FIXME: Unsupported compiler
+#endif
+}
+
+MDBX_MAYBE_UNUSED static __always_inline uint32_t
+atomic_add32(MDBX_atomic_uint32_t *p, uint32_t v) {
+#ifdef MDBX_HAVE_C11ATOMICS
+  STATIC_ASSERT(sizeof(int) >= sizeof(uint32_t));
+  assert(atomic_is_lock_free(MDBX_c11a_rw(uint32_t, p)));
+  return atomic_fetch_add(MDBX_c11a_rw(uint32_t, p), v);
+#elif defined(__GNUC__) || defined(__clang__)
+  return __sync_fetch_and_add(&p->weak, v);
+#elif defined(_MSC_VER)
+  STATIC_ASSERT(sizeof(volatile long) == sizeof(volatile uint32_t));
+  return (uint32_t)_InterlockedExchangeAdd((volatile long *)&p->weak, v);
+#elif defined(__APPLE__)
+  return OSAtomicAdd32Barrier(v, &p->weak);
+#else
+#error FIXME: Unsupported compiler
+#endif
+}
+
+#define atomic_sub32(p, v) atomic_add32(p, 0 - (v))
+
 #endif /* !__cplusplus */
 
 /*----------------------------------------------------------------------------*/
@@ -736,8 +775,42 @@ typedef struct MDBX_reader {
    * at any time the difference mm_pages_retired - mr_snapshot_pages_retired
    * will give the number of pages which this reader restraining from reuse. */
   MDBX_atomic_uint64_t mr_snapshot_pages_retired;
+
+#if MDBX_ENABLE_READERS_SHARDING
+  /* Padding to avoid false sharing between readers on different CPUs. */
+  uint8_t mr_padding[MDBX_CACHELINE_SIZE - 32];
+#endif /* MDBX_ENABLE_READERS_SHARDING */
 } MDBX_reader;
 
+#define MDBX_READERS_LIMIT 32767
+
+/* The reader slots are grouped by MDBX_RGROUP_SIZE to track a lower bound of
+ * txnids used by readers of each group, so find_oldest_reader() rescans only
+ * groups which were changed or could raise the oldest txnid. Also, with the
+ * MDBX_ENABLE_READERS_SHARDING readers prefer the group local for a CPU. */
+#define MDBX_RGROUP_SIZE 64
+#define MDBX_RGROUP_LIMIT                                                      \
+  ((MDBX_READERS_LIMIT + MDBX_RGROUP_SIZE - 1) / MDBX_RGROUP_SIZE)
+
+#if MDBX_64BIT_CAS
+
+typedef struct MDBX_rgroup {
+  /* Lower bound of txnids of readers in the group. Readers only lower it at
+   * the start of transaction, and only the writer raises it after rescan. */
+  MDBX_atomic_uint64_t /* txnid_t */ rg_bound;
+  /* Non-zero if a reader in the group has started or finished a transaction
+   * since the last rescan, i.e. the rg_bound may be inexact. */
+  MDBX_atomic_uint32_t rg_changed;
+  uint32_t rg_reserved;
+#if MDBX_ENABLE_READERS_SHARDING
+  uint8_t rg_padding[MDBX_CACHELINE_SIZE - 16];
+#endif /* MDBX_ENABLE_READERS_SHARDING */
+} MDBX_rgroup;
+#endif /* MDBX_64BIT_CAS */
+
+/* Number of slots for abandoned tickets of the fair write lock. */
+#define MDBX_WLOCK_ABANDONED 30
+
 /* The header for the reader table (a memory-mapped lock file). */
 typedef struct MDBX_lockinfo {
   /* Stamp identifying this as an MDBX file.
@@ -805,6 +878,25 @@ typedef struct MDBX_lockinfo {
   /* Shared anchor for tracking readahead edge and enabled/disabled status. */
   pgno_t mti_readahead_anchor;
 
+  /* Low 32-bit of txnid of the last committed transaction, which is used as
+   * a futex-word for mdbx_env_wait_txnid(). */
+  MDBX_atomic_uint32_t mti_commit_txnid;
+
+  /* Number of threads waiting for a commit within mdbx_env_wait_txnid().
+   * Could be overestimated after a crash of waiting process, which only leads
+   * to the extra wakeup calls. */
+  MDBX_atomic_uint32_t mti_commit_waiters;
+
+  MDBX_ALIGNAS(MDBX_CACHELINE_SIZE) /* cacheline ----------------------------*/
+
+  /* Tickets of the fair write lock, see MDBX_opt_writer_fairness: the next
+   * ticket to be taken and the ticket which is being served, the last one
+   * is also used as a futex-word for waiting. */
+  MDBX_atomic_uint32_t mti_wlock_ticket, mti_wlock_serving;
+
+  /* Tickets abandoned by timed out waiters, which should be skipped. */
+  MDBX_atomic_uint32_t mti_wlock_abandoned[MDBX_WLOCK_ABANDONED];
+
   MDBX_ALIGNAS(MDBX_CACHELINE_SIZE) /* cacheline ----------------------------*/
 
   /* Readeaders registration lock. */
@@ -818,6 +910,15 @@ typedef struct MDBX_lockinfo {
   MDBX_atomic_uint32_t mti_numreaders;
   MDBX_atomic_uint32_t mti_readers_refresh_flag;
 
+  /* The number of slots within the lck-file, which only grows online, see
+   * readers_grow(). Thus it is also the generation of the readers table. */
+  MDBX_atomic_uint32_t mti_readers_capacity;
+
+#if MDBX_64BIT_CAS
+  MDBX_ALIGNAS(MDBX_CACHELINE_SIZE) /* cacheline ----------------------------*/
+  MDBX_rgroup mti_rgroups[MDBX_RGROUP_LIMIT];
+#endif /* MDBX_64BIT_CAS */
+
 #if (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L) ||              \
     (!defined(__cplusplus) && defined(_MSC_VER))
   MDBX_ALIGNAS(MDBX_CACHELINE_SIZE) /* cacheline ----------------------------*/
@@ -831,6 +932,9 @@ typedef struct MDBX_lockinfo {
    (unsigned)offsetof(MDBX_reader, mr_snapshot_pages_used) * 251 +             \
    (unsigned)offsetof(MDBX_lockinfo, mti_oldest_reader) * 83 +                 \
    (unsigned)offsetof(MDBX_lockinfo, mti_numreaders) * 37 +                    \
+   (unsigned)offsetof(MDBX_lockinfo, mti_readers_capacity) * 43 +              \
+   (unsigned)offsetof(MDBX_lockinfo, mti_commit_waiters) * 53 +                \
+   (unsigned)offsetof(MDBX_lockinfo, mti_wlock_abandoned) * 71 +               \
    (unsigned)offsetof(MDBX_lockinfo, mti_readers) * 29)
 
 #define MDBX_DATA_MAGIC                                                        \
@@ -876,7 +980,6 @@ typedef struct MDBX_lockinfo {
 #define MDBX_PGL_LIMIT (MAX_MAPSIZE32 / MIN_PAGESIZE)
 #endif /* MDBX_WORDBITS */
 
-#define MDBX_READERS_LIMIT 32767
 #define MDBX_RADIXSORT_THRESHOLD 333
 
 /*----------------------------------------------------------------------------*/
@@ -899,6 +1002,15 @@ typedef pgno_t *MDBX_PNL;
 /* List of txnid, only for MDBX_txn.tw.lifo_reclaimed */
 typedef txnid_t *MDBX_TXL;
 
+#if MDBX_ENABLE_GC_GAPS
+/* The least txnid of pages inside a GC record which was put by this process,
+ * i.e. the record is not visible by snapshots older than the birth. */
+typedef struct MDBX_gc_birth {
+  txnid_t id;    /* the key of GC record */
+  txnid_t birth; /* the least mp_txnid of retired pages, zero if unknown */
+} MDBX_gc_birth;
+#endif /* MDBX_ENABLE_GC_GAPS */
+
 /* An Dirty-Page list item is an pgno/pointer pair. */
 typedef struct MDBX_dp {
   MDBX_page *ptr;
@@ -907,23 +1019,60 @@ typedef struct MDBX_dp {
     uint32_t extra;
     __anonymous_struct_extension__ struct {
       unsigned multi : 1;
-      unsigned lru : 31;
+      unsigned heat : 2 /* see MDBX_SPILL_ADAPTIVE */;
+      unsigned lru : 29;
     };
   };
 } MDBX_dp;
 
+/* An DPH is an open-addressing hash index of a huge dirty-page list,
+ * which maps pgno to the position of an item within the list. */
+typedef struct MDBX_dph {
+  size_t bits;   /* log2 of the number of slots */
+  size_t used;   /* number of occupied slots, including the stale ones */
+  size_t hashed; /* number of leading items of the list which are indexed */
+  size_t debt;   /* lookups done without the index since it was invalidated */
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L) ||              \
+    (!defined(__cplusplus) && defined(_MSC_VER))
+  struct {
+    pgno_t pgno;
+    uint32_t idx;
+  } slots[];
+#endif
+} MDBX_dph;
+
 /* An DPL (dirty-page list) is a sorted array of MDBX_DPs. */
 typedef struct MDBX_dpl {
   size_t sorted;
   size_t length;
   size_t pages_including_loose; /* number of pages, but not an entries. */
   size_t detent; /* allocated size excluding the MDBX_DPL_RESERVE_GAP */
+  MDBX_dph *hash; /* the index for huge lists, see MDBX_DPL_HASH_THRESHOLD */
+  /* The reference bits of dirty pages addressed by the low bits of pgno,
+   * i.e. the CLOCK-like approximation of LRU, see MDBX_SPILL_ADAPTIVE */
+  uint64_t *refs;
+  size_t refs_mask;
 #if (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L) ||              \
     (!defined(__cplusplus) && defined(_MSC_VER))
   MDBX_dp items[] /* dynamic size with holes at zero and after the last */;
 #endif
 } MDBX_dpl;
 
+/* An index of contiguous runs of pages within the tw.relist, bucketed by the
+ * length in the TLSF-manner, i.e. four buckets per each power of two. The runs
+ * are ordered by the length within a bucket, so the best-fit is bsearch'ed. */
+#define MDBX_RUNS_BUCKETS 124
+typedef struct MDBX_runs {
+  size_t coherent; /* length of tw.relist the index is coherent with */
+  size_t count;    /* total number of entries, including the stale ones */
+  struct {
+    struct {
+      pgno_t pgno, npages;
+    } *items;
+    uint32_t length, allocated;
+  } buckets[MDBX_RUNS_BUCKETS];
+} MDBX_runs;
+
 /* PNL sizes */
 #define MDBX_PNL_GRANULATE 1024
 #define MDBX_PNL_INITIAL                                                       \
@@ -959,6 +1108,42 @@ typedef struct MDBX_dpl {
 #define MDBX_PNL_SIZEOF(pl) ((MDBX_PNL_GETSIZE(pl) + 1) * sizeof(pgno_t))
 #define MDBX_PNL_IS_EMPTY(pl) (MDBX_PNL_GETSIZE(pl) == 0)
 
+/* A GC record could be stored in the extent-encoded form, see the
+ * MDBX_ENABLE_GC_EXTENTS build option. Then the leading counter holds the
+ * number of following words marked by the MDBX_GC_EXTENT flag, and each run
+ * of pages is encoded in the PNL order by a pair of words: the lowest pgno
+ * marked by the same flag and the number of pages. */
+#define MDBX_GC_EXTENT UINT32_C(0x80000000)
+
+/* Returns the number of pages within the extent-encoded words,
+ * or zero if ones are malformed. */
+MDBX_MAYBE_UNUSED static size_t gc_extents_count(const pgno_t *words,
+                                                 size_t n) {
+  size_t count = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (words[i] & MDBX_GC_EXTENT) {
+      if (unlikely(++i == n || words[i] < 2 || words[i] > MAX_PAGENO))
+        return 0;
+      count += words[i];
+    } else
+      count += 1;
+  }
+  return (count <= MDBX_PGL_LIMIT) ? count : 0;
+}
+
+/* Expands the extent-encoded words into the items in the PNL order. */
+MDBX_MAYBE_UNUSED static void gc_extents_expand(const pgno_t *words, size_t n,
+                                                pgno_t *items) {
+  for (size_t i = 0; i < n; ++i) {
+    if (words[i] & MDBX_GC_EXTENT) {
+      const pgno_t pgno = words[i] - MDBX_GC_EXTENT, npages = words[++i];
+      for (pgno_t j = 0; j < npages; ++j)
+        *items++ = MDBX_PNL_ASCENDING ? pgno + j : pgno + npages - 1 - j;
+    } else
+      *items++ = words[i];
+  }
+}
+
 /*----------------------------------------------------------------------------*/
 /* Internal structures */
 
@@ -1057,6 +1242,9 @@ struct MDBX_txn {
     struct {
       /* For read txns: This thread/txn's reader table slot, or NULL. */
       MDBX_reader *reader;
+      /* The shared snapshot if txn was created from, see
+       * mdbx_txn_begin_snapshot(). Such txn has no own reader slot. */
+      MDBX_snapshot *snapshot;
     } to;
     struct {
       meta_troika_t troika;
@@ -1068,6 +1256,11 @@ struct MDBX_txn {
 #endif /* MDBX_ENABLE_REFUND */
       /* a sequence to spilling dirty page with LRU policy */
       unsigned dirtylru;
+      /* Number of pages spilled and unspilled by this txn,
+       * including ones by the committed nested txns */
+      size_t spill_npages, unspill_npages;
+      /* Duration of waiting for the write lock at start of the txn */
+      uint64_t lock_wait;
       /* dirtylist room: Dirty array size - dirty pages visible to this txn.
        * Includes ancestor txns' dirty pages not hidden by other txns'
        * dirty/spilled pages. Thus commit(nested txn) has room to merge
@@ -1075,8 +1268,16 @@ struct MDBX_txn {
       size_t dirtyroom;
       /* For write txns: Modified pages. Sorted when not MDBX_WRITEMAP. */
       MDBX_dpl *dirtylist;
+      /* The index of runs in the relist for multi-page allocations */
+      MDBX_runs *relist_runs;
       /* The list of reclaimed txns from GC */
       MDBX_TXL lifo_reclaimed;
+#if MDBX_ENABLE_GC_GAPS
+      /* The list of GC records reclaimed between snapshots of readers */
+      MDBX_TXL gap_reclaimed;
+      /* The least mp_txnid of pages in the retired_pages */
+      txnid_t retired_birth;
+#endif /* MDBX_ENABLE_GC_GAPS */
       /* The list of pages that became unused during this transaction. */
       MDBX_PNL retired_pages;
       /* The list of loose pages that became unused and may be reused
@@ -1084,6 +1285,9 @@ struct MDBX_txn {
       MDBX_page *loose_pages;
       /* Number of loose pages (tw.loose_pages) */
       size_t loose_count;
+      /* For nested txns: the reclaimed pages which were dirty in ancestors,
+       * unsorted and may contain duplicates, see txn_merge_incremental() */
+      MDBX_PNL shadowed_reclaimed;
       union {
         struct {
           size_t least_removed;
@@ -1098,6 +1302,17 @@ struct MDBX_txn {
   };
 };
 
+/* A read-only snapshot shared by transactions of many threads. */
+struct MDBX_snapshot {
+#define MDBX_MS_SIGNATURE UINT32_C(0x5A4F7E2B)
+  uint32_t ms_signature;
+  /* One reference by the handle itself and one for each txn created from */
+  MDBX_atomic_uint32_t ms_refs;
+  /* The read txn which holds the reader slot, with MDBX_NOTLS in mt_flags
+   * since the slot isn't bound to any thread. */
+  MDBX_txn *ms_txn;
+};
+
 #if MDBX_WORDBITS >= 64
 #define CURSOR_STACK 32
 #else
@@ -1146,6 +1361,7 @@ struct MDBX_cursor {
 #define C_GCU                                                                                  \
   0x20 /* Происходит подготовка к обновлению GC, поэтому \
         * можно брать страницы из GC даже для FREE_DBI */
+#define C_DEFRAG 0x40 /* relocating pages into the lowest free ones */
   uint8_t mc_flags;
 
   /* Cursor checking flags. */
@@ -1186,6 +1402,17 @@ typedef struct MDBX_cursor_couple {
   MDBX_xcursor inner;
 } MDBX_cursor_couple;
 
+/* Keys of a table modified by a write transaction, which are tracked for
+ * the change feed. The begin and end point into the owned buffers. */
+typedef struct MDBX_changed {
+#define CHANGED_NONE 0
+#define CHANGED_KEYS 1
+#define CHANGED_WHOLE 2
+  uint8_t state;
+  MDBX_val begin, end;
+  size_t begin_room, end_room;
+} MDBX_changed;
+
 /* The database environment. */
 struct MDBX_env {
   /* ----------------------------------------------------- mostly static part */
@@ -1225,7 +1452,7 @@ struct MDBX_env {
       me_merge_threshold_gc;  /* pages emptier than this are candidates for
                                  merging */
   unsigned me_os_psize;       /* OS page size, from osal_syspagesize() */
-  unsigned me_maxreaders;     /* size of the reader table */
+  MDBX_atomic_uint32_t me_maxreaders; /* size of the reader table */
   MDBX_dbi me_maxdbs;         /* size of the DB table */
   uint32_t me_pid;            /* process ID of this env */
   osal_thread_key_t me_txkey; /* thread-key for readers */
@@ -1239,6 +1466,18 @@ struct MDBX_env {
   unsigned
       me_maxgc_ov1page;    /* Number of pgno_t fit in a single overflow page */
   uint32_t me_live_reader; /* have liveness lock in reader table */
+  MDBX_atomic_uint32_t me_rslot_hint; /* where to look for a free reader slot */
+#if !(defined(_WIN32) || defined(_WIN64))
+  MDBX_atomic_uint32_t me_rslot_remap; /* readers table is locked for remap */
+  uint32_t me_wlock_ticket; /* the served ticket of the fair write lock */
+  bool me_wlock_ticketed;   /* the write lock was acquired by a ticket */
+  struct {
+    osal_thread_t thread;
+    int stop_fd; /* eventfd to stop the watcher */
+    int period_ms;
+    bool active;
+  } me_rwatch; /* the watcher of dead readers */
+#endif /* !Windows */
   void *me_userctx;        /* User-settable context */
   MDBX_hsr_func *me_hsr_callback; /* Callback for kicking laggard readers */
 
@@ -1251,7 +1490,15 @@ struct MDBX_env {
     uint8_t spill_max_denominator;
     uint8_t spill_min_denominator;
     uint8_t spill_parent4child_denominator;
+    uint8_t spill_policy;
     unsigned merge_threshold_16dot16_percent;
+    unsigned drop_reclaim_budget;
+    unsigned changefeed_limit;
+    uint8_t changefeed_ranges;
+    uint8_t gc_profiling;
+    uint8_t writer_fairness;
+    unsigned rwatch_period_16dot16;
+    unsigned readers_growth_limit;
     union {
       unsigned all;
       /* tracks options with non-auto values but tuned by user */
@@ -1286,12 +1533,56 @@ struct MDBX_env {
   MDBX_txn *me_txn; /* current write transaction */
   osal_fastmutex_t me_dbi_lock;
   MDBX_dbi me_numdbs; /* number of DBs opened */
+  bool me_drop_pending; /* there may be tables queued by mdbx_drop_deferred() */
+  /* Tables and keys modified by the current write txn for the change feed,
+   * see MDBX_opt_changefeed_limit */
+  struct {
+    txnid_t txnid;         /* write txn which the tracked changes belong to */
+    MDBX_dbi dbi;          /* handle of the feed table, opened once enabled */
+    MDBX_changed *tables;  /* per-dbi, allocated on demand */
+    MDBX_val dropped;      /* length-prefixed names of deleted tables */
+    size_t dropped_room;   /* allocated size of the dropped buffer */
+  } me_changefeed;
 
   MDBX_page *me_dp_reserve; /* list of malloc'ed blocks for re-use */
   unsigned me_dp_reserve_len;
+#if MDBX_ENABLE_DPARENA
+  struct {
+    void **chunks;     /* mapped chunks in the order of allocation */
+    size_t count;      /* number of mapped chunks */
+    size_t current;    /* index of the chunk being carved */
+    char *ptr, *end;   /* unused part of the current chunk */
+    MDBX_page *freed;  /* single-page slots released within a txn */
+    size_t foreign;    /* number of in-use blocks allocated by malloc() */
+    bool no_hugetlb;   /* huge pages are not available */
+  } me_dparena;
+#endif /* MDBX_ENABLE_DPARENA */
   /* PNL of pages that became unused in a write txn */
   MDBX_PNL me_retired_pages;
+  /* GC records prefetched by mdbx_env_gc_prefetch() for the next write txn */
+  struct {
+    MDBX_PNL relist; /* merged pages of the records */
+    MDBX_TXL ids;    /* keys of the records in the order of reclaiming */
+    txnid_t txnid;   /* the snapshot which the records were read from */
+    bool lifo;       /* the records were read in MDBX_LIFORECLAIM order */
+  } me_gc_prefetch;
+#if MDBX_ENABLE_GC_GAPS
+  struct {
+    MDBX_gc_birth *items; /* sorted by id, only above the oldest reader */
+    size_t length, allocated;
+    MDBX_TXL snapshots; /* the scratch for txnids of live readers */
+  } me_gc_births;
+#endif /* MDBX_ENABLE_GC_GAPS */
   osal_ioring_t me_ioring;
+#if MDBX_ENABLE_ASYNC_SPILL
+  struct {
+    osal_ioring_t ior; /* the spilled pages which are being written */
+    osal_thread_t thread;
+    int err;
+    unsigned wops;
+    bool active;
+  } me_spill_async;
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
 
 #if defined(_WIN32) || defined(_WIN64)
   osal_srwlock_t me_remap_guard;
@@ -1631,6 +1922,14 @@ typedef struct MDBX_node {
 #error "Oops, some flags overlapped or wrong"
 #endif
 
+/* The hidden tables are used internally and can't be opened by users,
+ * see MDBX_HIDDEN_TABLE_PREFIX. */
+MDBX_MAYBE_UNUSED static __inline bool hidden_table(const MDBX_val *name) {
+  return name->iov_len >= sizeof(MDBX_HIDDEN_TABLE_PREFIX) - 1 &&
+         memcmp(name->iov_base, MDBX_HIDDEN_TABLE_PREFIX,
+                sizeof(MDBX_HIDDEN_TABLE_PREFIX) - 1) == 0;
+}
+
 /* Max length of iov-vector passed to writev() call, used for auxilary writes */
 #define MDBX_AUXILARY_IOV_MAX 64
 #if defined(IOV_MAX) && IOV_MAX < MDBX_AUXILARY_IOV_MAX
@@ -291,6 +291,221 @@ MDBX_INTERNAL_FUNC int osal_rpid_check(MDBX_env *env, uint32_t pid) {
   return lck_op(env->me_lfd, op_getlk, F_WRLCK, pid, 1);
 }
 
+#if (defined(__linux__) || defined(__gnu_linux__)) && defined(SYS_pidfd_open)
+/* The watcher of dead readers.
+ *
+ * An auxiliary thread holds a pidfd for each process which owns slot(s)
+ * within the readers table, and calls cleanup_dead_readers() as soon as any
+ * of these processes exits, i.e. when its pidfd becomes readable. The processes
+ * which have registered after the last rescan of the table are picked up by
+ * the next one. A pidfd refers to a certain process rather than its PID, so
+ * there are no races with reuse of PIDs. Nonetheless, the indicative lock
+ * remains authoritative for liveness of readers, since the PID of a reader
+ * from another PID-namespace may refer to an unrelated process or nothing. */
+
+#include <poll.h>
+#include <sys/eventfd.h>
+
+typedef struct rwatch_set {
+  size_t count, limit;
+  uint32_t *pids;     /* sorted, the pids[i] is watched by the fds[i + 1] */
+  struct pollfd *fds; /* the fds[0] is the eventfd to stop the watcher */
+} rwatch_set_t;
+
+static size_t rwatch_search(const rwatch_set_t *set, uint32_t pid) {
+  size_t lo = 0, hi = set->count;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) >> 1;
+    if (set->pids[mid] < pid)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static int rwatch_reserve(rwatch_set_t *set, size_t wanna) {
+  if (likely(wanna <= set->limit && set->fds))
+    return MDBX_SUCCESS;
+  uint32_t *const pids = osal_realloc(set->pids, wanna * sizeof(uint32_t));
+  if (unlikely(!pids))
+    return MDBX_ENOMEM;
+  set->pids = pids;
+  struct pollfd *const fds =
+      osal_realloc(set->fds, (wanna + 1) * sizeof(struct pollfd));
+  if (unlikely(!fds))
+    return MDBX_ENOMEM;
+  set->fds = fds;
+  set->limit = wanna;
+  return MDBX_SUCCESS;
+}
+
+static void rwatch_close(rwatch_set_t *set) {
+  for (size_t i = 1; i <= set->count; ++i)
+    if (set->fds[i].fd >= 0)
+      close(set->fds[i].fd);
+  set->count = 0;
+}
+
+/* Fills the next set by processes from the readers table, while moving
+ * the pidfds from the current set and opening ones for new processes, as well
+ * as for the known ones which are not watched yet. Sets the dead flag if any
+ * new process has already exited. */
+static int rwatch_rescan(MDBX_env *env, rwatch_set_t *now, rwatch_set_t *next,
+                         bool *dead) {
+  MDBX_lockinfo *const lck = env->me_lck_mmap.lck;
+  const size_t snap_nreaders =
+      atomic_load32(&lck->mti_numreaders, mo_AcquireRelease);
+  int err = rwatch_reserve(next, snap_nreaders);
+  if (unlikely(err != MDBX_SUCCESS))
+    return err;
+
+  next->count = 0;
+  for (size_t i = 0; i < snap_nreaders; ++i) {
+    const uint32_t pid =
+        atomic_load32(&lck->mti_readers[i].mr_pid, mo_AcquireRelease);
+    if (pid == 0 || pid == env->me_pid)
+      continue /* skip empty and self */;
+    const size_t n = rwatch_search(next, pid);
+    if (n < next->count && next->pids[n] == pid)
+      continue /* already processed */;
+
+    int fd = -1;
+    const size_t o = rwatch_search(now, pid);
+    const bool seen = o < now->count && now->pids[o] == pid;
+    if (seen) {
+      /* already watched, or an attempt was failed */
+      fd = now->fds[o + 1].fd;
+      now->fds[o + 1].fd = -1;
+    }
+    if (fd < 0) {
+      /* retry for the seen ones, since the failure could be transient
+       * (e.g. EMFILE) or the PID was reused by a new reader, but don't
+       * report these again */
+      fd = (int)syscall(SYS_pidfd_open, (pid_t)pid, 0);
+      if (unlikely(fd < 0) && !seen) {
+        err = errno;
+        if (err == ESRCH)
+          *dead = true;
+        else
+          WARNING("unable to watch reader pid %u, error %d", pid, err);
+      }
+    }
+
+    memmove(next->pids + n + 1, next->pids + n,
+            (next->count - n) * sizeof(uint32_t));
+    memmove(next->fds + n + 2, next->fds + n + 1,
+            (next->count - n) * sizeof(struct pollfd));
+    next->pids[n] = pid;
+    next->fds[n + 1].fd = fd;
+    next->fds[n + 1].events = POLLIN;
+    next->fds[n + 1].revents = 0;
+    next->count += 1;
+  }
+
+  /* forget processes which have left the readers table */
+  rwatch_close(now);
+  return MDBX_SUCCESS;
+}
+
+static THREAD_RESULT THREAD_CALL rwatch_thread(void *arg) {
+  MDBX_env *const env = arg;
+  rwatch_set_t sets[2], *now = &sets[0], *next = &sets[1];
+  memset(sets, 0, sizeof(sets));
+  bool dead = false;
+  for (;;) {
+    int err = rwatch_rescan(env, now, next, &dead);
+    if (unlikely(err != MDBX_SUCCESS)) {
+      ERROR("the watcher of dead readers failed, error %d", err);
+      break;
+    }
+    rwatch_set_t *const swap = now;
+    now = next;
+    next = swap;
+
+    if (dead) {
+      dead = false;
+      int count = 0;
+      err = cleanup_dead_readers(env, false, &count);
+      if (count)
+        NOTICE("the watcher cleared %d slot(s) of dead readers", count);
+      else if (unlikely(MDBX_IS_ERROR(err)))
+        WARNING("the watcher is unable to cleanup dead readers, error %d",
+                err);
+    }
+
+    now->fds[0].fd = env->me_rwatch.stop_fd;
+    now->fds[0].events = POLLIN;
+    now->fds[0].revents = 0;
+    if (unlikely(poll(now->fds, now->count + 1, env->me_rwatch.period_ms) <
+                 0)) {
+      err = errno;
+      if (err == EINTR)
+        continue;
+      ERROR("the watcher of dead readers failed, error %d", err);
+      break;
+    }
+    if (now->fds[0].revents)
+      break /* stop */;
+    for (size_t i = 1; i <= now->count; ++i)
+      if (now->fds[i].revents) {
+        /* the process has exited, don't poll it anymore */
+        close(now->fds[i].fd);
+        now->fds[i].fd = -1;
+        dead = true;
+      }
+  }
+
+  for (size_t i = 0; i < ARRAY_LENGTH(sets); ++i) {
+    rwatch_close(&sets[i]);
+    osal_free(sets[i].pids);
+    osal_free(sets[i].fds);
+  }
+  return (THREAD_RESULT)0;
+}
+#endif /* Linux && SYS_pidfd_open */
+
+MDBX_INTERNAL_FUNC int osal_rpid_watch(MDBX_env *env, unsigned period_16dot16) {
+#if (defined(__linux__) || defined(__gnu_linux__)) && defined(SYS_pidfd_open)
+  int rc = MDBX_SUCCESS;
+  if (env->me_rwatch.active) {
+    env->me_rwatch.active = false;
+    /* the thread isn't inherited by a child process after fork() */
+    if (env->me_pid == osal_getpid()) {
+      const uint64_t one = 1;
+      rc = (write(env->me_rwatch.stop_fd, &one, sizeof(one)) == sizeof(one))
+               ? osal_thread_join(env->me_rwatch.thread)
+               : errno;
+    }
+    close(env->me_rwatch.stop_fd);
+  }
+  if (rc != MDBX_SUCCESS || period_16dot16 == 0 ||
+      !env->me_lck_mmap.lck /* exclusive mode, nothing to watch */)
+    return rc;
+
+  /* pidfd_open() is available since Linux 5.3 */
+  const int probe = (int)syscall(SYS_pidfd_open, osal_getpid(), 0);
+  if (unlikely(probe < 0))
+    return (errno == ENOSYS) ? MDBX_ENOSYS : errno;
+  close(probe);
+
+  const uint64_t period_ms = (period_16dot16 * UINT64_C(1000) + 65535) >> 16;
+  env->me_rwatch.period_ms = (period_ms < INT_MAX) ? (int)period_ms : INT_MAX;
+  env->me_rwatch.stop_fd = eventfd(0, EFD_CLOEXEC);
+  if (unlikely(env->me_rwatch.stop_fd < 0))
+    return errno;
+  rc = osal_thread_create(&env->me_rwatch.thread, rwatch_thread, env);
+  if (likely(rc == MDBX_SUCCESS))
+    env->me_rwatch.active = true;
+  else
+    close(env->me_rwatch.stop_fd);
+  return rc;
+#else
+  (void)env;
+  return period_16dot16 ? MDBX_ENOSYS : MDBX_SUCCESS;
+#endif /* Linux && SYS_pidfd_open */
+}
+
 /*---------------------------------------------------------------------------*/
 
 #if MDBX_LOCKING > MDBX_LOCKING_SYSV
@@ -847,14 +1062,71 @@ MDBX_INTERNAL_FUNC int osal_check_tid4bionic(void) {
 }
 #endif /* __ANDROID_API__ || ANDROID) || BIONIC */
 
+#if MDBX_LOCKING == MDBX_LOCKING_SYSV
+#if (defined(__linux__) || defined(__gnu_linux__)) && defined(_GNU_SOURCE)
+#define MDBX_IPCLOCK_TIMED 1 /* semtimedop() is available */
+#else
+#define MDBX_IPCLOCK_TIMED 0
+#endif
+#elif defined(__APPLE__) && defined(__MACH__)
+/* Darwin provides neither pthread_mutex_timedlock() nor sem_timedwait() */
+#define MDBX_IPCLOCK_TIMED 0
+#else
+#define MDBX_IPCLOCK_TIMED 1
+#endif /* MDBX_IPCLOCK_TIMED */
+
+#if MDBX_IPCLOCK_TIMED
+/* Converts the deadline in the osal_monotime() units to the timeout for the
+ * timed POSIX primitives, either relative or absolute by CLOCK_REALTIME. */
+static struct timespec mdbx_ipclock_timeout(uint64_t deadline, bool absolute) {
+  const uint64_t now = osal_monotime();
+  const uint64_t left_ns =
+      (deadline > now)
+          ? (osal_monotime_to_16dot16(deadline - now) * UINT64_C(1000000000)) >>
+                16
+          : 0;
+  struct timespec ts = {0, 0};
+  if (absolute && unlikely(clock_gettime(CLOCK_REALTIME, &ts)))
+    ts.tv_sec = time(nullptr);
+  ts.tv_sec += (time_t)(left_ns / 1000000000u);
+  ts.tv_nsec += (long)(left_ns % 1000000000u);
+  if (ts.tv_nsec >= 1000000000) {
+    ts.tv_sec += 1;
+    ts.tv_nsec -= 1000000000;
+  }
+  return ts;
+}
+#endif /* MDBX_IPCLOCK_TIMED */
+
 static int mdbx_ipclock_lock(MDBX_env *env, osal_ipclock_t *ipc,
-                             const bool dont_wait) {
+                             const bool dont_wait, const uint64_t deadline) {
+#if !MDBX_IPCLOCK_TIMED
+  if (deadline && !dont_wait) {
+    /* emulate the timed waiting by polling */
+    int rc;
+    while ((rc = mdbx_ipclock_lock(env, ipc, true, 0)) == MDBX_BUSY &&
+           osal_monotime() < deadline)
+      usleep(1000);
+    return rc;
+  }
+#endif /* MDBX_IPCLOCK_TIMED */
+
 #if MDBX_LOCKING == MDBX_LOCKING_POSIX2001 ||                                  \
     MDBX_LOCKING == MDBX_LOCKING_POSIX2008
   int rc = osal_check_tid4bionic();
-  if (likely(rc == 0))
-    rc = dont_wait ? pthread_mutex_trylock(ipc) : pthread_mutex_lock(ipc);
-  rc = (rc == EBUSY && dont_wait) ? MDBX_BUSY : rc;
+  if (likely(rc == 0)) {
+    if (dont_wait)
+      rc = pthread_mutex_trylock(ipc);
+#if MDBX_IPCLOCK_TIMED
+    else if (deadline) {
+      const struct timespec abstime = mdbx_ipclock_timeout(deadline, true);
+      rc = pthread_mutex_timedlock(ipc, &abstime);
+    }
+#endif /* MDBX_IPCLOCK_TIMED */
+    else
+      rc = pthread_mutex_lock(ipc);
+  }
+  rc = ((rc == EBUSY && dont_wait) || rc == ETIMEDOUT) ? MDBX_BUSY : rc;
 #elif MDBX_LOCKING == MDBX_LOCKING_POSIX1988
   int rc = MDBX_SUCCESS;
   if (dont_wait) {
@@ -863,16 +1135,35 @@ static int mdbx_ipclock_lock(MDBX_env *env, osal_ipclock_t *ipc,
       if (rc == EAGAIN)
         rc = MDBX_BUSY;
     }
-  } else if (sem_wait(ipc))
+  }
+#if MDBX_IPCLOCK_TIMED
+  else if (deadline) {
+    const struct timespec abstime = mdbx_ipclock_timeout(deadline, true);
+    if (sem_timedwait(ipc, &abstime)) {
+      rc = errno;
+      if (rc == ETIMEDOUT)
+        rc = MDBX_BUSY;
+    }
+  }
+#endif /* MDBX_IPCLOCK_TIMED */
+  else if (sem_wait(ipc))
     rc = errno;
 #elif MDBX_LOCKING == MDBX_LOCKING_SYSV
   struct sembuf op = {.sem_num = (ipc != &env->me_lck->mti_wlock),
                       .sem_op = -1,
                       .sem_flg = dont_wait ? IPC_NOWAIT | SEM_UNDO : SEM_UNDO};
   int rc;
-  if (semop(env->me_sysv_ipc.semid, &op, 1)) {
+#if MDBX_IPCLOCK_TIMED
+  const struct timespec timeout = mdbx_ipclock_timeout(deadline, false);
+  if ((deadline && !dont_wait)
+          ? semtimedop(env->me_sysv_ipc.semid, &op, 1, &timeout)
+          : semop(env->me_sysv_ipc.semid, &op, 1))
+#else
+  if (semop(env->me_sysv_ipc.semid, &op, 1))
+#endif /* MDBX_IPCLOCK_TIMED */
+  {
     rc = errno;
-    if (dont_wait && rc == EAGAIN)
+    if ((dont_wait || deadline) && rc == EAGAIN)
       rc = MDBX_BUSY;
   } else {
     rc = *ipc ? EOWNERDEAD : MDBX_SUCCESS;
@@ -912,7 +1203,7 @@ static int mdbx_ipclock_unlock(MDBX_env *env, osal_ipclock_t *ipc) {
 MDBX_INTERNAL_FUNC int osal_rdt_lock(MDBX_env *env) {
   TRACE("%s", ">>");
   jitter4testing(true);
-  int rc = mdbx_ipclock_lock(env, &env->me_lck->mti_rlock, false);
+  int rc = mdbx_ipclock_lock(env, &env->me_lck->mti_rlock, false, 0);
   TRACE("<< rc %d", rc);
   return rc;
 }
@@ -926,20 +1217,166 @@ MDBX_INTERNAL_FUNC void osal_rdt_unlock(MDBX_env *env) {
   jitter4testing(true);
 }
 
+/*----------------------------------------------------------------------------*/
+/* Fairness of the write lock.
+ *
+ * Being enabled by MDBX_opt_writer_fairness, a writer takes a ticket, waits
+ * on the futex until the ticket is served, only then acquires the mti_wlock
+ * and passes the turn to the next ticket after unlocking. Thus the mutual
+ * exclusion still relies on the mti_wlock, while tickets only order writers,
+ * i.e. a trouble with tickets could break the order but never the exclusion.
+ * A waiter which gives up by a deadline marks its ticket as abandoned to be
+ * skipped. The turn could be also stalled by a crashed process, therefore a
+ * waiter which sees no progress for a while takes the mti_wlock out of turn
+ * if it is free. */
+
+/* How long to wait for the turn progress before trying out of turn. */
+#define WLOCK_STALL_16DOT16 (65536 / 16)
+
+static __always_inline bool wlock_ticket_before(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b) < 0;
+}
+
+static __always_inline MDBX_atomic_uint32_t *
+wlock_abandoned(MDBX_lockinfo *lck, uint32_t ticket) {
+  return &lck->mti_wlock_abandoned[ticket % MDBX_WLOCK_ABANDONED];
+}
+
+/* Passes the turn to the given ticket unless it has already gone further,
+ * skipping the abandoned tickets. */
+static void wlock_pass(MDBX_lockinfo *lck, uint32_t next) {
+  uint32_t serving = atomic_load32(&lck->mti_wlock_serving, mo_AcquireRelease);
+  bool passed = false;
+  while (wlock_ticket_before(serving, next)) {
+    if (!atomic_cas32(&lck->mti_wlock_serving, serving, next)) {
+      serving = atomic_load32(&lck->mti_wlock_serving, mo_AcquireRelease);
+      continue;
+    }
+    passed = true;
+    /* paired with the barrier in wlock_abandon() */
+    if (!atomic_cas32(wlock_abandoned(lck, next), next,
+                      next - MDBX_WLOCK_ABANDONED))
+      break;
+    serving = next++;
+  }
+  /* wake up only if there are waiters */
+  if (passed &&
+      atomic_load32(&lck->mti_wlock_ticket, mo_AcquireRelease) != next)
+    osal_futex_wake(&lck->mti_wlock_serving.weak);
+}
+
+/* Gives up the ticket and passes the turn if it has come already. */
+static void wlock_abandon(MDBX_lockinfo *lck, uint32_t ticket) {
+  MDBX_atomic_uint32_t *const abandoned = wlock_abandoned(lck, ticket);
+  atomic_store32(abandoned, ticket, mo_AcquireRelease);
+  osal_memory_barrier();
+  if (atomic_load32(&lck->mti_wlock_serving, mo_AcquireRelease) == ticket &&
+      atomic_cas32(abandoned, ticket, ticket - MDBX_WLOCK_ABANDONED))
+    wlock_pass(lck, ticket + 1);
+}
+
+static int wlock_fair(MDBX_env *env, const uint64_t deadline) {
+  MDBX_lockinfo *const lck = env->me_lck_mmap.lck;
+  const uint32_t ticket = atomic_add32(&lck->mti_wlock_ticket, 1);
+  uint32_t serving = atomic_load32(&lck->mti_wlock_serving, mo_AcquireRelease);
+  int rc;
+  if (wlock_ticket_before(serving, ticket)) {
+    const uint64_t patience = osal_16dot16_to_monotime(WLOCK_STALL_16DOT16);
+    uint32_t seen = serving;
+    uint64_t seen_since = osal_monotime();
+    do {
+      const uint64_t stall = seen_since + patience;
+      osal_futex_wait(&lck->mti_wlock_serving.weak, serving,
+                      (deadline && deadline < stall) ? deadline : stall);
+      serving = atomic_load32(&lck->mti_wlock_serving, mo_AcquireRelease);
+      if (!wlock_ticket_before(serving, ticket))
+        break;
+      const uint64_t now = osal_monotime();
+      if (deadline && now >= deadline) {
+        /* the last chance out of turn, rather than a failure while
+         * the lock is free since all waiters ahead have given up too */
+        rc = mdbx_ipclock_lock(env, &lck->mti_wlock, true, 0);
+        wlock_abandon(lck, ticket);
+        if (!MDBX_IS_ERROR(rc))
+          env->me_wlock_ticketed = false;
+        return rc;
+      }
+      if (serving != seen) {
+        seen = serving;
+        seen_since = now;
+        continue;
+      }
+      if (now >= stall) {
+        rc = mdbx_ipclock_lock(env, &lck->mti_wlock, true, 0);
+        if (rc != MDBX_BUSY) {
+          if (MDBX_IS_ERROR(rc)) {
+            wlock_abandon(lck, ticket);
+            return rc;
+          }
+          NOTICE("write-lock turn is stalled at ticket %u, "
+                 "proceed out of turn with %u",
+                 serving, ticket);
+          wlock_pass(lck, ticket);
+          goto acquired;
+        }
+        seen_since = now;
+      }
+    } while (true);
+  }
+
+  rc = mdbx_ipclock_lock(env, &lck->mti_wlock, false, deadline);
+  if (MDBX_IS_ERROR(rc)) {
+    wlock_pass(lck, ticket + 1);
+    return rc;
+  }
+
+acquired:
+  env->me_wlock_ticket = ticket;
+  env->me_wlock_ticketed = true;
+  return rc;
+}
+
+MDBX_INTERNAL_FUNC int osal_txn_lock_until(MDBX_env *env,
+                                           uint64_t deadline_monotime) {
+  TRACE("deadline %" PRIu64 " %s", deadline_monotime, ">>");
+  jitter4testing(true);
+  int rc;
+  if (env->me_options.writer_fairness && env->me_lck_mmap.lck)
+    rc = wlock_fair(env, deadline_monotime);
+  else {
+    rc = mdbx_ipclock_lock(env, &env->me_lck->mti_wlock, false,
+                           deadline_monotime);
+    if (!MDBX_IS_ERROR(rc))
+      env->me_wlock_ticketed = false;
+  }
+  TRACE("<< rc %d", rc);
+  return MDBX_IS_ERROR(rc) ? rc : MDBX_SUCCESS;
+}
+
 int mdbx_txn_lock(MDBX_env *env, bool dont_wait) {
-  TRACE("%swait %s", dont_wait ? "dont-" : "", ">>");
+  if (!dont_wait)
+    return osal_txn_lock_until(env, 0);
+
+  TRACE("%swait %s", "dont-", ">>");
   jitter4testing(true);
-  int rc = mdbx_ipclock_lock(env, &env->me_lck->mti_wlock, dont_wait);
+  int rc = mdbx_ipclock_lock(env, &env->me_lck->mti_wlock, true, 0);
+  if (!MDBX_IS_ERROR(rc))
+    env->me_wlock_ticketed = false;
   TRACE("<< rc %d", rc);
   return MDBX_IS_ERROR(rc) ? rc : MDBX_SUCCESS;
 }
 
 void mdbx_txn_unlock(MDBX_env *env) {
   TRACE("%s", ">>");
+  const bool ticketed = env->me_wlock_ticketed;
+  const uint32_t ticket = env->me_wlock_ticket;
+  env->me_wlock_ticketed = false;
   int rc = mdbx_ipclock_unlock(env, &env->me_lck->mti_wlock);
   TRACE("<< rc %d", rc);
   if (unlikely(rc != MDBX_SUCCESS))
     mdbx_panic("%s() failed: err %d\n", __func__, rc);
+  if (ticketed)
+    wlock_pass(env->me_lck_mmap.lck, ticket + 1);
   jitter4testing(true);
 }
 
@@ -216,6 +216,21 @@ int mdbx_txn_lock(MDBX_env *env, bool dontwait) {
   return (!dontwait || rc != ERROR_LOCK_VIOLATION) ? rc : MDBX_BUSY;
 }
 
+MDBX_INTERNAL_FUNC int osal_txn_lock_until(MDBX_env *env,
+                                           uint64_t deadline_monotime) {
+  if (!deadline_monotime)
+    return mdbx_txn_lock(env, false);
+
+  /* There is no timed waiting for the file locks, so just poll,
+   * and the MDBX_opt_writer_fairness is not supported here. */
+  while (true) {
+    const int rc = mdbx_txn_lock(env, true);
+    if (rc != MDBX_BUSY || osal_monotime() >= deadline_monotime)
+      return rc;
+    SleepEx(1, true);
+  }
+}
+
 void mdbx_txn_unlock(MDBX_env *env) {
   if ((env->me_flags & MDBX_EXCLUSIVE) == 0) {
     int err = funlock(env->me_fd4data, DXB_BODY);
@@ -725,6 +740,11 @@ MDBX_INTERNAL_FUNC int osal_rpid_check(MDBX_env *env, uint32_t pid) {
   }
 }
 
+MDBX_INTERNAL_FUNC int osal_rpid_watch(MDBX_env *env, unsigned period_16dot16) {
+  (void)env;
+  return period_16dot16 ? MDBX_ENOSYS : MDBX_SUCCESS;
+}
+
 //----------------------------------------------------------------------------
 // Stub for slim read-write lock
 // Copyright (C) 1995-2002 Brad Wilson
@@ -520,7 +520,23 @@ static int handle_freedb(const uint64_t record_number, const MDBX_val *key,
         problem_add("entry", txnid, "wrong idl size", "%" PRIuPTR,
                     data->iov_len);
       size_t number = (data->iov_len >= sizeof(pgno_t)) ? *iptr++ : 0;
-      if (number < 1 || number > MDBX_PGL_LIMIT)
+      pgno_t *expanded = nullptr;
+      if (number & MDBX_GC_EXTENT) {
+        const size_t words = number - MDBX_GC_EXTENT;
+        number = ((words + 1) * sizeof(pgno_t) <= data->iov_len)
+                     ? gc_extents_count(iptr, words)
+                     : 0;
+        if (number < 1)
+          problem_add("entry", txnid, "wrong extents", "%" PRIuPTR " words",
+                      words);
+        else {
+          expanded = osal_malloc(number * sizeof(pgno_t));
+          if (unlikely(!expanded))
+            return MDBX_ENOMEM;
+          gc_extents_expand(iptr, words, expanded);
+          iptr = expanded;
+        }
+      } else if (number < 1 || number > MDBX_PGL_LIMIT)
         problem_add("entry", txnid, "wrong idl length", "%" PRIuPTR, number);
       else if ((number + 1) * sizeof(pgno_t) > data->iov_len) {
         problem_add("entry", txnid, "trimmed idl",
@@ -542,8 +558,10 @@ static int handle_freedb(const uint64_t record_number, const MDBX_val *key,
       pgno_t prev = MDBX_PNL_ASCENDING ? NUM_METAS - 1 : txn->mt_next_pgno;
       pgno_t span = 1;
       for (unsigned i = 0; i < number; ++i) {
-        if (check_user_break())
+        if (check_user_break()) {
+          osal_free(expanded);
           return MDBX_EINTR;
+        }
         const pgno_t pgno = iptr[i];
         if (pgno < NUM_METAS)
           problem_add("entry", txnid, "wrong idl entry",
@@ -601,6 +619,7 @@ static int handle_freedb(const uint64_t record_number, const MDBX_val *key,
           }
         }
       }
+      osal_free(expanded);
     }
   }
 
@@ -625,6 +644,15 @@ static int handle_maindb(const uint64_t record_number, const MDBX_val *key,
     if (name[i] < ' ')
       return handle_userdb(record_number, key, data);
   }
+  if (hidden_table(key)) {
+    /* the b-tree is checked by the traversal, but can't be opened */
+    if (verbose > 1) {
+      print("Skip processing hidden '%.*s'...\n", (int)key->iov_len - 1,
+            name + 1);
+      fflush(nullptr);
+    }
+    return handle_userdb(record_number, key, data);
+  }
 
   name = osal_malloc(key->iov_len + 1);
   if (unlikely(!name))
@@ -426,6 +426,8 @@ int main(int argc, char *argv[]) {
 
       if (memchr(key.iov_base, '\0', key.iov_len))
         continue;
+      if (hidden_table(&key))
+        continue;
       subname = osal_realloc(buf4free, key.iov_len + 1);
       if (!subname) {
         rc = MDBX_ENOMEM;
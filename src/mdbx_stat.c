@@ -349,7 +349,24 @@ int main(int argc, char *argv[]) {
         break;
       }
       iptr = data.iov_base;
-      const pgno_t number = *iptr++;
+      pgno_t number = *iptr++, *expanded = nullptr;
+      if (number & MDBX_GC_EXTENT) {
+        const size_t words = number - MDBX_GC_EXTENT;
+        if (unlikely((words + 1) * sizeof(pgno_t) > data.iov_len)) {
+          rc = MDBX_CORRUPTED;
+          break;
+        }
+        number = (pgno_t)gc_extents_count(iptr, words);
+        if (number) {
+          expanded = osal_malloc(number * sizeof(pgno_t));
+          if (unlikely(!expanded)) {
+            rc = MDBX_ENOMEM;
+            break;
+          }
+          gc_extents_expand(iptr, words, expanded);
+        }
+        iptr = expanded;
+      }
 
       pages += number;
       if (envinfo && mei.mi_latter_reader_txnid > *(txnid_t *)key.iov_base)
@@ -389,6 +406,7 @@ int main(int argc, char *argv[]) {
           }
         }
       }
+      osal_free(expanded);
     }
     mdbx_cursor_close(cursor);
     cursor = nullptr;
@@ -469,6 +487,8 @@ int main(int argc, char *argv[]) {
       MDBX_dbi subdbi;
       if (memchr(key.iov_base, '\0', key.iov_len))
         continue;
+      if (hidden_table(&key))
+        continue;
       subname = osal_malloc(key.iov_len + 1);
       memcpy(subname, key.iov_base, key.iov_len);
       subname[key.iov_len] = '\0';
@@ -73,9 +73,12 @@
 #error MDBX_ENABLE_REFUND must be defined as 0 or 1
 #endif /* MDBX_ENABLE_REFUND */
 
-/** Controls profiling of GC search and updates. */
+/** Controls support of profiling of GC search and updates.
+ * The profiling itself is disabled by default and should be enabled
+ * at runtime by the \ref MDBX_opt_gc_profiling option, while the overhead
+ * for the disabled one is just a few well-predicted branches. */
 #ifndef MDBX_ENABLE_PROFGC
-#define MDBX_ENABLE_PROFGC 0
+#define MDBX_ENABLE_PROFGC 1
 #elif !(MDBX_ENABLE_PROFGC == 0 || MDBX_ENABLE_PROFGC == 1)
 #error MDBX_ENABLE_PROFGC must be defined as 0 or 1
 #endif /* MDBX_ENABLE_PROFGC */
@@ -99,6 +102,77 @@
 #error MDBX_ENABLE_BIGFOOT must be defined as 0 or 1
 #endif /* MDBX_ENABLE_BIGFOOT */
 
+/** Enables writing of the spilled pages by an auxiliary thread, so a huge
+ * write transaction continues while the spilled pages are being written.
+ * Not available on Windows and has no effect in the \ref MDBX_WRITEMAP mode.
+ *
+ * The spilled pages are not served from their in-memory copies while being
+ * written, since cursors could keep pointers to ones after the release.
+ * Thus a read or a retirement of any such page waits for the whole batch
+ * to be written, i.e. a workload which reloads the spilled pages soon
+ * gains nothing but the wait. Disabled by default for now. */
+#ifndef MDBX_ENABLE_ASYNC_SPILL
+#define MDBX_ENABLE_ASYNC_SPILL 0
+#elif !(MDBX_ENABLE_ASYNC_SPILL == 0 || MDBX_ENABLE_ASYNC_SPILL == 1)
+#error MDBX_ENABLE_ASYNC_SPILL must be defined as 0 or 1
+#elif MDBX_ENABLE_ASYNC_SPILL && (defined(_WIN32) || defined(_WIN64))
+#error MDBX_ENABLE_ASYNC_SPILL is not supported on Windows
+#endif /* MDBX_ENABLE_ASYNC_SPILL */
+
+/** Pads slots of the readers table to cachelines and makes a reader to prefer
+ * a slot from the group which is local for the current CPU, to avoid false
+ * sharing between readers on different CPUs. This changes the layout of the
+ * lck-file and increases its size twice or more. */
+#ifndef MDBX_ENABLE_READERS_SHARDING
+#define MDBX_ENABLE_READERS_SHARDING 0
+#elif !(MDBX_ENABLE_READERS_SHARDING == 0 || MDBX_ENABLE_READERS_SHARDING == 1)
+#error MDBX_ENABLE_READERS_SHARDING must be defined as 0 or 1
+#endif /* MDBX_ENABLE_READERS_SHARDING */
+
+/** Enables storing the retired pages into GC records in the extent-encoded
+ * form, i.e. runs of pages as pairs of the first page number and the length.
+ * Such records are always readable, but ones are not understood by the
+ * libmdbx versions which were released before this option was introduced,
+ * i.e. the database becomes unreadable by ones, see \ref mdbx_build. */
+#ifndef MDBX_ENABLE_GC_EXTENTS
+#define MDBX_ENABLE_GC_EXTENTS 0
+#elif !(MDBX_ENABLE_GC_EXTENTS == 0 || MDBX_ENABLE_GC_EXTENTS == 1)
+#error MDBX_ENABLE_GC_EXTENTS must be defined as 0 or 1
+#endif /* MDBX_ENABLE_GC_EXTENTS */
+
+/** Enables reclaiming of GC records which are newer than the oldest reader,
+ * but whose pages are not visible by any live MVCC-snapshot, i.e. they were
+ * created and retired entirely between snapshots of the readers. This works
+ * only for records put by write transactions of the same process.
+ * Disabled by default for now, as an experimental feature. */
+#ifndef MDBX_ENABLE_GC_GAPS
+#define MDBX_ENABLE_GC_GAPS 0
+#elif !(MDBX_ENABLE_GC_GAPS == 0 || MDBX_ENABLE_GC_GAPS == 1)
+#error MDBX_ENABLE_GC_GAPS must be defined as 0 or 1
+#endif /* MDBX_ENABLE_GC_GAPS */
+
+/** Enables the locality-aware choice of pages from the list of reclaimed
+ * ones, i.e. a new page is placed near the page which the cursor is working
+ * on, instead of taking the lowest page number. This keeps pages of the same
+ * b-tree closer in the file, so range scans of an aged database are more
+ * sequential and the readahead is more effective. */
+#ifndef MDBX_ENABLE_ALLOC_LOCALITY
+#define MDBX_ENABLE_ALLOC_LOCALITY 1
+#elif !(MDBX_ENABLE_ALLOC_LOCALITY == 0 || MDBX_ENABLE_ALLOC_LOCALITY == 1)
+#error MDBX_ENABLE_ALLOC_LOCALITY must be defined as 0 or 1
+#endif /* MDBX_ENABLE_ALLOC_LOCALITY */
+
+/** Enables the arena allocator for dirty and shadow pages.
+ * Single pages and small multi-page blocks are carved out of the large
+ * anonymous memory mappings (huge pages are used if available), which are
+ * recycled all at once at the end of a write transaction, instead of
+ * allocating and freeing each page through the malloc(). */
+#ifndef MDBX_ENABLE_DPARENA
+#define MDBX_ENABLE_DPARENA 1
+#elif !(MDBX_ENABLE_DPARENA == 0 || MDBX_ENABLE_DPARENA == 1)
+#error MDBX_ENABLE_DPARENA must be defined as 0 or 1
+#endif /* MDBX_ENABLE_DPARENA */
+
 /** Controls using of POSIX' madvise() and/or similar hints. */
 #ifndef MDBX_ENABLE_MADVISE
 #define MDBX_ENABLE_MADVISE 1
@@ -238,7 +312,12 @@
 /** POSIX-2008 Robust Mutexes for \ref MDBX_LOCKING */
 #define MDBX_LOCKING_POSIX2008 2008
 
-/** BeOS Benaphores, aka Futexes for \ref MDBX_LOCKING */
+/** BeOS Benaphores, aka Futexes for \ref MDBX_LOCKING
+ * \note Reserved and not implemented. The lock words in the lck-file can't
+ * be registered in the kernel robust list, which is owned by libc, while
+ * FUTEX_LOCK_PI and any probing of the owner identify it by TID, which is
+ * not comparable across PID namespaces. So the death of an owner can't be
+ * detected as reliably as with \ref MDBX_LOCKING_POSIX2008. */
 #define MDBX_LOCKING_BENAPHORE 1995
 
 /** Advanced: Choices the locking implementation (autodetection by default). */
@@ -2641,6 +2641,62 @@ __cold MDBX_INTERNAL_FUNC void osal_jitter(bool tiny) {
 
 /*----------------------------------------------------------------------------*/
 
+MDBX_INTERNAL_FUNC int osal_futex_wait(volatile uint32_t *ptr,
+                                       uint32_t expected,
+                                       uint64_t deadline_monotime) {
+  if (*ptr != expected)
+    return MDBX_SUCCESS;
+
+  uint64_t timeout = 0;
+  if (deadline_monotime) {
+    const uint64_t now = osal_monotime();
+    if (now >= deadline_monotime)
+      return MDBX_RESULT_TRUE;
+    timeout = deadline_monotime - now;
+  }
+
+#if (defined(__linux__) || defined(__gnu_linux__)) && defined(SYS_futex)
+  /* osal_monotime() counts nanoseconds on Linux */
+  struct timespec ts;
+  ts.tv_sec = (time_t)(timeout / 1000000000u);
+  ts.tv_nsec = (long)(timeout % 1000000000u);
+  /* not a FUTEX_PRIVATE_FLAG, since the word may be shared between processes */
+  if (syscall(SYS_futex, ptr, FUTEX_WAIT, expected, timeout ? &ts : NULL, NULL,
+              0) == 0)
+    return MDBX_SUCCESS;
+  const int err = errno;
+  switch (err) {
+  case EAGAIN /* the value has been changed */:
+  case EINTR:
+    return MDBX_SUCCESS;
+  case ETIMEDOUT:
+    return MDBX_RESULT_TRUE;
+  default:
+    return err;
+  }
+#else
+  /* poll with the granularity about of a millisecond, the deadline will be
+   * checked by the next call */
+  (void)timeout;
+#if defined(_WIN32) || defined(_WIN64)
+  Sleep(1);
+#else
+  usleep(1000);
+#endif
+  return MDBX_SUCCESS;
+#endif /* Linux */
+}
+
+MDBX_INTERNAL_FUNC void osal_futex_wake(volatile uint32_t *ptr) {
+#if (defined(__linux__) || defined(__gnu_linux__)) && defined(SYS_futex)
+  syscall(SYS_futex, ptr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+  (void)ptr;
+#endif /* Linux */
+}
+
+/*----------------------------------------------------------------------------*/
+
 #if defined(_WIN32) || defined(_WIN64)
 static LARGE_INTEGER performance_frequency;
 #elif defined(__APPLE__) || defined(__MACH__)
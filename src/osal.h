@@ -605,6 +605,19 @@ MDBX_MAYBE_UNUSED static __inline uintptr_t osal_thread_self(void) {
   return (uintptr_t)thunk;
 }
 
+/* Returns the number of CPU the current thread is running on, or -1 if this
+ * is unknown. The result is only a hint, since the thread may be migrated. */
+MDBX_MAYBE_UNUSED static __inline int osal_cpu_current(void) {
+#if defined(_WIN32) || defined(_WIN64)
+  return (int)GetCurrentProcessorNumber();
+#elif (defined(__linux__) || defined(__gnu_linux__)) &&                        \
+    defined(_GNU_SOURCE) && (!defined(__GLIBC__) || __GLIBC_PREREQ(2, 6))
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
 #if !defined(_WIN32) && !defined(_WIN64)
 #if defined(__ANDROID_API__) || defined(ANDROID) || defined(BIONIC)
 MDBX_INTERNAL_FUNC int osal_check_tid4bionic(void);
@@ -631,6 +644,18 @@ osal_monotime_to_16dot16_noUnderflow(uint64_t monotime) {
 }
 
 MDBX_INTERNAL_FUNC bin128_t osal_bootid(void);
+
+/* Waits until the 32-bit word at the given address, which may be shared
+ * between processes, becomes different from the expected value, or until the
+ * deadline given in the osal_monotime() units (zero means no deadline).
+ * Returns MDBX_RESULT_TRUE if the deadline is reached, otherwise MDBX_SUCCESS
+ * including the spurious wakeups, so the caller should recheck the condition.
+ * Where futexes are not available the waiting degrades to a short sleep. */
+MDBX_INTERNAL_FUNC int osal_futex_wait(volatile uint32_t *ptr,
+                                       uint32_t expected,
+                                       uint64_t deadline_monotime);
+/* Wakes up all threads waiting in osal_futex_wait() for the given word. */
+MDBX_INTERNAL_FUNC void osal_futex_wake(volatile uint32_t *ptr);
 /*----------------------------------------------------------------------------*/
 /* lck stuff */
 
@@ -710,6 +735,14 @@ MDBX_INTERNAL_FUNC void osal_rdt_unlock(MDBX_env *env);
 /// \return Error code or zero on success
 LIBMDBX_API int mdbx_txn_lock(MDBX_env *env, bool dont_wait);
 
+/// \brief Acquires lock for DB change with the deadline given in the
+///   osal_monotime() units, zero means no deadline. Being enabled by the
+///   MDBX_opt_writer_fairness option, the waiters are served in FIFO order.
+/// \return Error code, MDBX_BUSY if the deadline is reached,
+///   or zero on success
+MDBX_INTERNAL_FUNC int osal_txn_lock_until(MDBX_env *env,
+                                           uint64_t deadline_monotime);
+
 /// \brief Releases lock once DB changes is made (after writing transaction
 ///   has finished).
 ///   Declared as LIBMDBX_API because it is used in mdbx_chk.
@@ -737,6 +770,13 @@ MDBX_INTERNAL_FUNC int osal_rpid_clear(MDBX_env *env);
 ///   Otherwise (not 0 and not -1) - error code.
 MDBX_INTERNAL_FUNC int osal_rpid_check(MDBX_env *env, uint32_t pid);
 
+/// \brief Starts the watcher of dead readers, which rescans the readers table
+///   with the given period, or stops it if the period is zero.
+///   A running watcher is stopped before (re)start.
+/// \return Error code or zero on success,
+///   MDBX_ENOSYS if the watcher isn't supported by the system.
+MDBX_INTERNAL_FUNC int osal_rpid_watch(MDBX_env *env, unsigned period_16dot16);
+
 #if defined(_WIN32) || defined(_WIN64)
 
 MDBX_INTERNAL_FUNC size_t osal_mb2w(wchar_t *dst, size_t dst_n, const char *src,
@@ -14,7 +14,16 @@
 
 #include "test.h++"
 
+#if defined(__linux__) || defined(__gnu_linux__)
+#include <signal.h>
+#include <sys/wait.h>
+#endif /* Linux */
+
 class testcase_deadread : public testcase {
+#if defined(__linux__) || defined(__gnu_linux__)
+  void watch_dead_reader();
+#endif /* Linux */
+
 public:
   testcase_deadread(const actor_config &config, const mdbx_pid_t pid)
       : testcase(config, pid) {}
@@ -22,7 +31,99 @@ public:
 };
 REGISTER_TESTCASE(deadread);
 
+#if defined(__linux__) || defined(__gnu_linux__)
+static int count_slots_of(void *ctx, int num, int slot, mdbx_pid_t pid,
+                          mdbx_tid_t thread, uint64_t txnid, uint64_t lag,
+                          size_t bytes_used,
+                          size_t bytes_retained) MDBX_CXX17_NOEXCEPT {
+  (void)num, (void)slot, (void)thread, (void)txnid, (void)lag;
+  (void)bytes_used, (void)bytes_retained;
+  std::pair<mdbx_pid_t, unsigned> *const arg =
+      static_cast<std::pair<mdbx_pid_t, unsigned> *>(ctx);
+  arg->second += pid == arg->first;
+  return MDBX_SUCCESS;
+}
+
+static unsigned slots_of(MDBX_env *env, mdbx_pid_t pid) {
+  std::pair<mdbx_pid_t, unsigned> arg(pid, 0);
+  int rc = mdbx_reader_list(env, count_slots_of, &arg);
+  if (unlikely(rc != MDBX_SUCCESS && rc != MDBX_RESULT_TRUE))
+    failure_perror("mdbx_reader_list()", rc);
+  return arg.second;
+}
+
+/* Forks a reader which is killed while its read-only transaction is running,
+ * then checks the slot of the dead one is cleared by the watcher of dead
+ * readers, i.e. without the mdbx_reader_check(). The reader is forked before
+ * the environment is opened here, since it shouldn't inherit an opened one. */
+void testcase_deadread::watch_dead_reader() {
+  int pipefd[2];
+  if (pipe(pipefd))
+    failure_perror("pipe()", errno);
+  fflush(nullptr);
+  const pid_t reader = fork();
+  if (reader < 0)
+    failure_perror("fork()", errno);
+  if (reader == 0) {
+    close(pipefd[0]);
+    /* the handle created by the parent is unusable here */
+    db_guard.release();
+    db_open();
+    txn_begin(true);
+    const char ready = '!';
+    if (write(pipefd[1], &ready, 1) != 1)
+      failure_perror("write()", errno);
+    for (;;)
+      pause();
+  }
+  close(pipefd[1]);
+
+  db_open();
+  int rc = mdbx_env_set_option(db_guard.get(), MDBX_opt_dead_readers_watch,
+                               65536 / 10);
+  char ready = 0;
+  ssize_t got;
+  while ((got = read(pipefd[0], &ready, 1)) < 0 && errno == EINTR)
+    ;
+  close(pipefd[0]);
+  if (got != 1)
+    failure("the reader %ld is not ready\n", (long)reader);
+  const unsigned slots = slots_of(db_guard.get(), reader);
+  if (kill(reader, SIGKILL))
+    failure_perror("kill()", errno);
+  int status;
+  while (waitpid(reader, &status, 0) != reader)
+    if (errno != EINTR)
+      failure_perror("waitpid()", errno);
+  if (slots != 1)
+    failure("the reader %ld holds %u slot(s) instead of one\n", (long)reader,
+            slots);
+  if (rc == MDBX_ENOSYS) {
+    log_notice("deadread: the watcher of dead readers is unsupported");
+    db_close();
+    return;
+  }
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_env_set_option(MDBX_opt_dead_readers_watch)", rc);
+
+  chrono::time deadline = chrono::now_monotonic();
+  deadline.fixedpoint += chrono::from_ms(10000).fixedpoint;
+  while (slots_of(db_guard.get(), reader)) {
+    if (chrono::now_monotonic().fixedpoint > deadline.fixedpoint)
+      failure("the slot of the dead reader %ld is not cleared by the watcher\n",
+              (long)reader);
+    usleep(10000);
+  }
+  log_verbose("deadread: the slot of the dead reader %ld is cleared",
+              (long)reader);
+  db_close();
+}
+#endif /* Linux */
+
 bool testcase_deadread::run() {
+#if defined(__linux__) || defined(__gnu_linux__)
+  watch_dead_reader();
+#endif /* Linux */
   db_open();
   txn_begin(true);
   cursor_guard.reset();
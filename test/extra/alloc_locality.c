@@ -0,0 +1,148 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of placing the pages reused from the relist near their siblings, see
+ * the MDBX_ENABLE_ALLOC_LOCALITY build option. A database is aged by rounds
+ * of random puts and deletes, so most of new pages are reused from the GC.
+ * Then the leaf pages are walked in the order of keys, and the consecutive
+ * ones which are placed near each other are counted, since the count should
+ * be much above the one expected for a random placement. Finally, the
+ * database is checked by mdbx_chk.
+ *
+ * Usage: alloc_locality dbpath mdbx_chk-pathname */
+
+#include "common.h"
+
+#define PAGESIZE 4096
+#define NKEYS 100000
+#define NROUNDS 400
+#define PER_ROUND 1000
+#define NEAR 8
+
+static uint64_t prng_state = UINT64_C(0x9E3779B97F4A7C15);
+static uint32_t prng(void) {
+  prng_state = prng_state * UINT64_C(6364136223846793005) +
+               UINT64_C(1442695040888963407);
+  return (uint32_t)(prng_state >> 33);
+}
+
+static void put(MDBX_txn *txn, MDBX_dbi dbi, uint32_t n) {
+  /* the big-endian keys, so the order of leaves is the order of numbers */
+  const uint32_t be = __builtin_bswap32(n), value[24] = {n, prng()};
+  MDBX_val key = {(void *)&be, sizeof(be)},
+           data = {(void *)value, sizeof(value)};
+  const int err = mdbx_put(txn, dbi, &key, &data, MDBX_UPSERT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_put", err);
+}
+
+static void del(MDBX_txn *txn, MDBX_dbi dbi, uint32_t n) {
+  const uint32_t be = __builtin_bswap32(n);
+  MDBX_val key = {(void *)&be, sizeof(be)};
+  const int err = mdbx_del(txn, dbi, &key, NULL);
+  if (err != MDBX_SUCCESS && err != MDBX_NOTFOUND)
+    failure("mdbx_del", err);
+}
+
+struct walk {
+  uint64_t prev, distance;
+  size_t leaves, near;
+};
+
+static int visitor(const uint64_t pgno, const unsigned number, void *const ctx,
+                   const int deep, const char *const dbi,
+                   const size_t page_size, const MDBX_page_type_t type,
+                   const MDBX_error_t err, const size_t nentries,
+                   const size_t payload_bytes, const size_t header_bytes,
+                   const size_t unused_bytes) {
+  (void)number, (void)deep, (void)page_size, (void)nentries;
+  (void)payload_bytes, (void)header_bytes, (void)unused_bytes;
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_pgwalk", err);
+  struct walk *const walk = ctx;
+  if (dbi == MDBX_PGWALK_MAIN && type == MDBX_page_leaf) {
+    if (walk->leaves++) {
+      const uint64_t distance =
+          (pgno > walk->prev) ? pgno - walk->prev : walk->prev - pgno;
+      walk->distance += distance;
+      walk->near += distance <= NEAR;
+    }
+    walk->prev = pgno;
+  }
+  return MDBX_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s dbpath mdbx_chk-pathname\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  const char *const pathname = argv[1];
+  const bool locality =
+      strstr(mdbx_build.options, "MDBX_ENABLE_ALLOC_LOCALITY=1") != NULL;
+
+  db_remove(pathname);
+  MDBX_env *const env = env_create();
+  int err = mdbx_env_set_geometry(env, 0, -1, 1 << 30, 1 << 20, 1 << 20,
+                                  PAGESIZE);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  /* no syncing for speed, since only the placement of pages matters */
+  env_open(env, pathname, MDBX_UTTERLY_NOSYNC);
+
+  MDBX_txn *txn = txn_begin(env, MDBX_TXN_READWRITE);
+  MDBX_dbi dbi;
+  err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  for (uint32_t n = 0; n < NKEYS; ++n)
+    put(txn, dbi, n * 4);
+  txn_commit(txn);
+
+  /* the aging, the keys are spread over the whole space of ones */
+  for (unsigned round = 0; round < NROUNDS; ++round) {
+    txn = txn_begin(env, MDBX_TXN_READWRITE);
+    for (unsigned i = 0; i < PER_ROUND; ++i) {
+      del(txn, dbi, prng() % (NKEYS * 4));
+      put(txn, dbi, prng() % (NKEYS * 4));
+    }
+    txn_commit(txn);
+  }
+
+  txn = txn_begin(env, MDBX_TXN_RDONLY);
+  struct walk walk = {0, 0, 0, 0};
+  err = mdbx_env_pgwalk(txn, visitor, &walk, false);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_pgwalk", err);
+  MDBX_envinfo info;
+  err = mdbx_env_info_ex(env, txn, &info, sizeof(info));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_info_ex", err);
+  mdbx_txn_abort(txn);
+  mdbx_env_close(env);
+
+  const size_t pages = (size_t)info.mi_last_pgno + 1;
+  const double mean = (double)walk.distance / (double)(walk.leaves - 1);
+  printf("the placement near siblings is %s: %zu leaves within %zu pages, "
+         "the mean distance %.1f, %zu near\n",
+         locality ? "enabled" : "disabled", walk.leaves, pages, mean,
+         walk.near);
+  /* a random placement makes a few consecutive leaves to be near, i.e.
+   * about the 2 * NEAR / pages fraction of ones */
+  if (locality)
+    check(walk.near > walk.leaves / 16,
+          "the leaves are placed near their siblings");
+  db_check(argv[2], pathname);
+  return EXIT_SUCCESS;
+}
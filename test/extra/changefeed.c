@@ -0,0 +1,265 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of the change feed, i.e. of the MDBX_opt_changefeed_limit and the
+ * mdbx_changes_enum(). The records of commits are checked to contain the
+ * changed tables only, with the ranges of the modified keys, or as changed
+ * entirely if the tables were created empty, emptied or deleted. The changes of an
+ * aborted transaction must not be reported by the next one, the commit made
+ * by a process without the recording must be reported as a gap, and the
+ * feed must be trimmed to the limit. Finally, the database is checked by
+ * mdbx_chk.
+ *
+ * Usage: changefeed dbpath mdbx_chk-pathname */
+
+#include "common.h"
+
+#include <inttypes.h>
+#include <sys/wait.h>
+
+#define LIMIT 16
+#define WHOLE UINT32_MAX
+
+static const char *pathname;
+static MDBX_env *env;
+
+typedef struct entry {
+  uint64_t txnid;
+  char table[8];
+  uint32_t begin, end /* WHOLE for the whole table */;
+} entry_t;
+
+static entry_t entries[LIMIT * 4];
+static size_t count;
+
+static int collect(void *ctx, uint64_t txnid, const MDBX_val *table,
+                   const MDBX_val *begin, const MDBX_val *end) {
+  (void)ctx;
+  check(count < LIMIT * 4 && table->iov_len < sizeof(entries[0].table),
+        "the count of entries");
+  entry_t *const e = &entries[count++];
+  e->txnid = txnid;
+  memset(e->table, 0, sizeof(e->table));
+  memcpy(e->table, table->iov_base, table->iov_len);
+  e->begin = e->end = WHOLE;
+  if (begin || end) {
+    check(begin && end && begin->iov_len == sizeof(uint32_t) &&
+              end->iov_len == sizeof(uint32_t),
+          "the range of keys");
+    memcpy(&e->begin, begin->iov_base, sizeof(uint32_t));
+    memcpy(&e->end, end->iov_base, sizeof(uint32_t));
+  }
+  return MDBX_SUCCESS;
+}
+
+/* Collects the entries of the feed after the given txnid, and returns the
+ * result of mdbx_changes_enum(). */
+static int changes(uint64_t since) {
+  count = 0;
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_RDONLY);
+  const int rc = mdbx_changes_enum(txn, since, collect, NULL);
+  mdbx_txn_abort(txn);
+  if (rc != MDBX_SUCCESS && rc != MDBX_RESULT_TRUE)
+    failure("mdbx_changes_enum", rc);
+  return rc;
+}
+
+/* Checks the collected entries of the given txnid are exactly the given
+ * ones, i.e. the triplets of the table name and the range. */
+static void expect(uint64_t txnid, size_t n, const entry_t *expected,
+                   const char *what) {
+  size_t found = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (entries[i].txnid != txnid)
+      continue;
+    bool ok = false;
+    for (size_t j = 0; j < n && !ok; ++j)
+      ok = strcmp(entries[i].table, expected[j].table) == 0 &&
+           entries[i].begin == expected[j].begin &&
+           entries[i].end == expected[j].end;
+    if (!ok)
+      printf("unexpected entry of txn %" PRIu64 ": '%s' [%u, %u]\n", txnid,
+             entries[i].table, entries[i].begin, entries[i].end);
+    check(ok, what);
+    found += 1;
+  }
+  check(found == n, what);
+}
+
+static void open_db(bool recording) {
+  env = env_create();
+  int err = mdbx_env_set_maxdbs(env, 8);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_maxdbs", err);
+  env_open(env, pathname, MDBX_ENV_DEFAULTS);
+  if (!recording)
+    return;
+  err = mdbx_env_set_option(env, MDBX_opt_changefeed_limit, LIMIT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_changefeed_limit)", err);
+  err = mdbx_env_set_option(env, MDBX_opt_changefeed_ranges, 1);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_changefeed_ranges)", err);
+}
+
+static MDBX_dbi table(MDBX_txn *txn, const char *name) {
+  MDBX_dbi dbi;
+  const int err =
+      mdbx_dbi_open(txn, name, MDBX_CREATE | MDBX_INTEGERKEY, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  return dbi;
+}
+
+static void put(MDBX_txn *txn, const char *name, uint32_t n) {
+  MDBX_val key = {&n, sizeof(n)};
+  const int err = mdbx_put(txn, table(txn, name), &key, &key, MDBX_UPSERT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_put", err);
+}
+
+static void del(MDBX_txn *txn, const char *name, uint32_t n) {
+  MDBX_val key = {&n, sizeof(n)};
+  const int err = mdbx_del(txn, table(txn, name), &key, NULL);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_del", err);
+}
+
+static uint64_t commit(MDBX_txn *txn) {
+  const uint64_t txnid = mdbx_txn_id(txn);
+  txn_commit(txn);
+  return txnid;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s dbpath mdbx_chk-pathname\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+  db_remove(pathname);
+  open_db(true);
+
+  /* the created tables are changed entirely, unless the keys are tracked */
+  MDBX_txn *txn = txn_begin(env, MDBX_TXN_READWRITE);
+  for (uint32_t n = 10; n < 20; ++n)
+    put(txn, "a", n);
+  table(txn, "b");
+  table(txn, "c");
+  const uint64_t created = commit(txn);
+  check(changes(0) == MDBX_RESULT_TRUE, "the feed is started after 0");
+  expect(created, 3,
+         (const entry_t[]){{0, "a", 10, 19},
+                           {0, "b", WHOLE, WHOLE},
+                           {0, "c", WHOLE, WHOLE}},
+         "the record of the creation");
+
+  /* a record per commit, with the ranges of modified keys */
+  txn = txn_begin(env, MDBX_TXN_READWRITE);
+  put(txn, "a", 50);
+  put(txn, "a", 5);
+  del(txn, "a", 12);
+  put(txn, "b", 7);
+  const uint64_t first = commit(txn);
+  txn = txn_begin(env, MDBX_TXN_READWRITE);
+  put(txn, "c", 3);
+  const uint64_t second = commit(txn);
+  check(changes(created) == MDBX_SUCCESS && count == 3,
+        "the records of two commits");
+  expect(first, 2, (const entry_t[]){{0, "a", 5, 50}, {0, "b", 7, 7}},
+         "the record of the first commit");
+  expect(second, 1, (const entry_t[]){{0, "c", 3, 3}},
+         "the record of the second commit");
+
+  /* the changes of an aborted txn are not reported by the next one, which
+   * has the same txnid */
+  txn = txn_begin(env, MDBX_TXN_READWRITE);
+  put(txn, "a", 1000);
+  put(txn, "b", 0);
+  check(mdbx_txn_id(txn) == second + (second - first), "the next txnid");
+  mdbx_txn_abort(txn);
+  txn = txn_begin(env, MDBX_TXN_READWRITE);
+  put(txn, "c", 4);
+  const uint64_t after_abort = commit(txn);
+  check(changes(second) == MDBX_SUCCESS && count == 1,
+        "the record after the abort");
+  expect(after_abort, 1, (const entry_t[]){{0, "c", 4, 4}},
+         "the record after the abort");
+
+  /* the emptied and deleted tables are changed entirely */
+  txn = txn_begin(env, MDBX_TXN_READWRITE);
+  int err = mdbx_drop(txn, table(txn, "b"), false);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_drop", err);
+  err = mdbx_drop(txn, table(txn, "c"), true);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_drop", err);
+  const uint64_t dropped = commit(txn);
+  check(changes(after_abort) == MDBX_SUCCESS && count == 2,
+        "the record of the dropping");
+  expect(dropped, 2,
+         (const entry_t[]){{0, "b", WHOLE, WHOLE}, {0, "c", WHOLE, WHOLE}},
+         "the record of the dropping");
+
+  /* a commit by a process without the recording is reported as a gap */
+  mdbx_env_close(env);
+  fflush(NULL);
+  const pid_t child = fork();
+  if (child < 0)
+    failure("fork", errno);
+  if (child == 0) {
+    role = "child";
+    open_db(false);
+    txn = txn_begin(env, MDBX_TXN_READWRITE);
+    put(txn, "a", 77);
+    commit(txn);
+    mdbx_env_close(env);
+    _exit(EXIT_SUCCESS);
+  }
+  int status;
+  if (waitpid(child, &status, 0) != child)
+    failure("waitpid", errno);
+  check(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS,
+        "the child writer");
+  open_db(true);
+  check(changes(dropped) == MDBX_RESULT_TRUE && count == 0,
+        "the gap of the child");
+  txn = txn_begin(env, MDBX_TXN_READWRITE);
+  const uint64_t unrecorded = mdbx_txn_id(txn) - (second - first);
+  put(txn, "a", 8);
+  const uint64_t recorded = commit(txn);
+  check(changes(dropped) == MDBX_RESULT_TRUE && count == 1,
+        "the gap before a record");
+  check(changes(unrecorded) == MDBX_SUCCESS && count == 1,
+        "no gap after the unrecorded commit");
+  expect(recorded, 1, (const entry_t[]){{0, "a", 8, 8}},
+         "the record after the gap");
+
+  /* the feed is trimmed to the limit */
+  uint64_t last = 0;
+  for (uint32_t n = 0; n < LIMIT * 3; ++n) {
+    txn = txn_begin(env, MDBX_TXN_READWRITE);
+    put(txn, "a", n);
+    last = commit(txn);
+  }
+  check(changes(0) == MDBX_RESULT_TRUE && count == LIMIT &&
+            entries[LIMIT - 1].txnid == last,
+        "the feed is trimmed to the limit");
+  check(changes(entries[0].txnid) == MDBX_SUCCESS && count == LIMIT - 1,
+        "no gaps within the limit");
+
+  mdbx_env_close(env);
+  db_check(argv[2], pathname);
+  return EXIT_SUCCESS;
+}
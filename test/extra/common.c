@@ -0,0 +1,88 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+#include "common.h"
+
+#include <sys/wait.h>
+
+const char *role;
+
+void failure(const char *what, int err) {
+  fprintf(stderr, "%s%s%s: %s (%d)\n", role ? role : "", role ? ": " : "",
+          what, mdbx_strerror(err), err);
+  exit(EXIT_FAILURE);
+}
+
+void check(bool ok, const char *what) {
+  if (!ok) {
+    fprintf(stderr, "%s%scheck failed: %s\n", role ? role : "",
+            role ? ": " : "", what);
+    exit(EXIT_FAILURE);
+  }
+}
+
+void db_remove(const char *pathname) {
+  char *const lck_pathname = malloc(strlen(pathname) + sizeof("-lck"));
+  if (!lck_pathname)
+    failure("malloc", errno);
+  strcat(strcpy(lck_pathname, pathname), "-lck");
+  unlink(pathname);
+  unlink(lck_pathname);
+  free(lck_pathname);
+}
+
+MDBX_env *env_create(void) {
+  MDBX_env *env;
+  const int err = mdbx_env_create(&env);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_create", err);
+  return env;
+}
+
+void env_open(MDBX_env *env, const char *pathname, MDBX_env_flags_t flags) {
+  const int err = mdbx_env_open(env, pathname, MDBX_NOSUBDIR | flags, 0644);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_open", err);
+}
+
+MDBX_txn *txn_begin(MDBX_env *env, MDBX_txn_flags_t flags) {
+  MDBX_txn *txn;
+  const int err = mdbx_txn_begin(env, NULL, flags, &txn);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_begin", err);
+  return txn;
+}
+
+void txn_commit(MDBX_txn *txn) {
+  const int err = mdbx_txn_commit(txn);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_commit", err);
+}
+
+void db_check(const char *chk_pathname, const char *pathname) {
+  fflush(NULL);
+  const pid_t pid = fork();
+  if (pid < 0)
+    failure("fork", errno);
+  if (pid == 0) {
+    execl(chk_pathname, chk_pathname, "-nq", pathname, (char *)NULL);
+    fprintf(stderr, "execl(%s): %s\n", chk_pathname, strerror(errno));
+    _exit(EXIT_FAILURE);
+  }
+  int status;
+  if (waitpid(pid, &status, 0) != pid)
+    failure("waitpid", errno);
+  check(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS,
+        "the database by mdbx_chk");
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* The scaffolding shared by the standalone tests and benchmarks. */
+
+#pragma once
+
+#include "mdbx.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* The prefix of diagnostic messages, e.g. to tell processes apart. */
+extern const char *role;
+
+/* Reports the failed operation with the given error code and exits. */
+MDBX_NORETURN void failure(const char *what, int err);
+
+/* Exits with the failure if the given condition is false. */
+void check(bool ok, const char *what);
+
+/* Removes the datafile and the lck-file, to start from scratch. */
+void db_remove(const char *pathname);
+
+/* Creates an environment handle, then options could be set before opening. */
+MDBX_env *env_create(void);
+
+/* Opens the database by the handle, without the sub-directory. */
+void env_open(MDBX_env *env, const char *pathname, MDBX_env_flags_t flags);
+
+MDBX_txn *txn_begin(MDBX_env *env, MDBX_txn_flags_t flags);
+void txn_commit(MDBX_txn *txn);
+
+/* Runs the mdbx_chk utility for the database, which should not be opened by
+ * the caller, and exits with the failure if any problem is found. */
+void db_check(const char *chk_pathname, const char *pathname);
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of the online defragmentation by mdbx_env_defrag(). The database is
+ * aged by filling a plain and a dupsort table, then deleting most of records
+ * at random, so the remaining pages are scattered over the datafile. Then
+ * mdbx_env_defrag() is called until it reports that nothing is relocated,
+ * and the datafile is checked to be shrunk while the data is intact.
+ *
+ * Usage: defrag dbpath */
+
+#include "common.h"
+
+#define NKEYS 20000
+#define NDUPS 8
+#define PERCENT_KEPT 10
+#define BUDGET_PAGES 64
+#define MAX_STEPS 100000
+
+static MDBX_env *env;
+static MDBX_dbi plain, dupsort;
+
+static bool is_kept(uint32_t n) {
+  return (n * UINT32_C(2654435761)) % 100 < PERCENT_KEPT;
+}
+
+static size_t value_length(uint32_t n) { return 16 + n % 777; }
+
+static void fill_value(uint32_t n, char *buf) {
+  const size_t len = value_length(n);
+  for (size_t i = 0; i < len; ++i)
+    buf[i] = (char)(n + i * 7);
+}
+
+static intptr_t datafile_size(void) {
+  MDBX_envinfo info;
+  const int err = mdbx_env_info_ex(env, NULL, &info, sizeof(info));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_info_ex", err);
+  return (intptr_t)info.mi_geo.current;
+}
+
+static void age(void) {
+  MDBX_txn *txn = txn_begin(env, MDBX_TXN_READWRITE);
+  int err = mdbx_dbi_open(txn, "plain", MDBX_CREATE | MDBX_INTEGERKEY, &plain);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  err = mdbx_dbi_open(txn, "dupsort",
+                      MDBX_CREATE | MDBX_INTEGERKEY | MDBX_DUPSORT, &dupsort);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+
+  char buf[1024];
+  for (uint32_t n = 0; n < NKEYS; ++n) {
+    fill_value(n, buf);
+    MDBX_val key = {&n, sizeof(n)}, data = {buf, value_length(n)};
+    err = mdbx_put(txn, plain, &key, &data, MDBX_UPSERT);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_put", err);
+    for (uint32_t i = 0; i < NDUPS; ++i) {
+      const uint64_t dup = (uint64_t)n << 32 | i;
+      data.iov_base = (void *)&dup;
+      data.iov_len = sizeof(dup);
+      err = mdbx_put(txn, dupsort, &key, &data, MDBX_UPSERT);
+      if (err != MDBX_SUCCESS)
+        failure("mdbx_put", err);
+    }
+    /* interleave the pages of tables by a few commits */
+    if (n % (NKEYS / 8) == NKEYS / 8 - 1) {
+      txn_commit(txn);
+      txn = txn_begin(env, MDBX_TXN_READWRITE);
+    }
+  }
+
+  for (uint32_t n = 0; n < NKEYS; ++n)
+    if (!is_kept(n)) {
+      MDBX_val key = {&n, sizeof(n)};
+      err = mdbx_del(txn, plain, &key, NULL);
+      if (err != MDBX_SUCCESS)
+        failure("mdbx_del", err);
+      err = mdbx_del(txn, dupsort, &key, NULL);
+      if (err != MDBX_SUCCESS)
+        failure("mdbx_del", err);
+    }
+  txn_commit(txn);
+}
+
+static void verify(void) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_RDONLY);
+
+  size_t kept = 0;
+  char buf[1024];
+  for (uint32_t n = 0; n < NKEYS; ++n) {
+    MDBX_val key = {&n, sizeof(n)}, data;
+    int err = mdbx_get(txn, plain, &key, &data);
+    if (!is_kept(n)) {
+      check(err == MDBX_NOTFOUND, "a deleted record is absent");
+      continue;
+    }
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_get", err);
+    fill_value(n, buf);
+    check(data.iov_len == value_length(n) &&
+              memcmp(data.iov_base, buf, data.iov_len) == 0,
+          "the value of a kept record");
+    size_t count;
+    err = mdbx_get_ex(txn, dupsort, &key, &data, &count);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_get_ex", err);
+    check(count == NDUPS, "the count of duplicates");
+    kept += 1;
+  }
+
+  MDBX_stat stat;
+  int err = mdbx_dbi_stat(txn, plain, &stat, sizeof(stat));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_stat", err);
+  check(stat.ms_entries == kept, "the count of records");
+  err = mdbx_dbi_stat(txn, dupsort, &stat, sizeof(stat));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_stat", err);
+  check(stat.ms_entries == kept * NDUPS, "the count of duplicates");
+  mdbx_txn_abort(txn);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s dbpath\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  const char *const pathname = argv[1];
+
+  db_remove(pathname);
+  env = env_create();
+  int err = mdbx_env_set_maxdbs(env, 2);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_maxdbs", err);
+  err = mdbx_env_set_geometry(env, 0, -1, 1 << 30, 1 << 16, 1 << 16, 4096);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  env_open(env, pathname, MDBX_ENV_DEFAULTS);
+
+  age();
+  verify();
+  const intptr_t aged = datafile_size();
+
+  size_t steps = 0;
+  do {
+    check(++steps < MAX_STEPS, "the defragmentation is finite");
+    err = mdbx_env_defrag(env, BUDGET_PAGES, 0);
+  } while (err == MDBX_SUCCESS);
+  if (err != MDBX_RESULT_TRUE)
+    failure("mdbx_env_defrag", err);
+
+  verify();
+  const intptr_t defragmented = datafile_size();
+  printf("the datafile is shrunk from %zi to %zi bytes by %zu step(s)\n",
+         aged, defragmented, steps);
+  check(defragmented < aged / 2, "the datafile is shrunk");
+  mdbx_env_close(env);
+  return EXIT_SUCCESS;
+}
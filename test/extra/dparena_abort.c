@@ -0,0 +1,161 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of the dirty pages allocation, i.e. the arena of MDBX_ENABLE_DPARENA,
+ * by abort-heavy nested transactions. Each write transaction runs a stack of
+ * nested ones, which update random records including large values (which are
+ * allocated by malloc() rather than from the arena), while most of nested
+ * transactions and a half of top-level ones are aborted. The data is checked
+ * against the model after each transaction. The run is repeated with the
+ * MDBX_PAGEPERTURB, so any use of a released page is noticeable, and with a
+ * small MDBX_opt_dp_reserve_limit. Then the database is checked by mdbx_chk.
+ *
+ * Usage: dparena_abort dbpath mdbx_chk-pathname */
+
+#include "common.h"
+
+#define NKEYS 2000
+#define NTXNS 200
+#define DEPTH 4
+#define LARGE_WORDS (600 * 1024 / 4) /* above a quarter of the 2 MiB chunk */
+
+static const char *pathname;
+static MDBX_env *env;
+static MDBX_dbi dbi;
+static uint32_t model[DEPTH + 2][NKEYS] /* a generation per record */;
+static uint32_t value[LARGE_WORDS];
+static uint64_t prng_state = UINT64_C(0x9E3779B97F4A7C15);
+
+static uint32_t prng(void) {
+  prng_state = prng_state * UINT64_C(6364136223846793005) +
+               UINT64_C(1442695040888963407);
+  return (uint32_t)(prng_state >> 33);
+}
+
+static size_t value_words(uint32_t n) { return (n % 500) ? 25 : LARGE_WORDS; }
+
+static void fill_value(uint32_t n, uint32_t gen, size_t words) {
+  for (size_t i = 0; i < words; ++i)
+    value[i] = n * 31 + gen * 7 + (uint32_t)i;
+}
+
+static void update(MDBX_txn *txn, uint32_t *gens) {
+  for (unsigned i = prng() % 64 + 1; i > 0; --i) {
+    const uint32_t n = prng() % NKEYS;
+    const size_t words = value_words(n);
+    fill_value(n, ++gens[n], words);
+    MDBX_val key = {(void *)&n, sizeof(n)},
+             data = {value, words * sizeof(uint32_t)};
+    const int err = mdbx_put(txn, dbi, &key, &data, MDBX_UPSERT);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_put", err);
+  }
+}
+
+static void verify(MDBX_txn *txn, const uint32_t *gens) {
+  for (uint32_t n = 0; n < NKEYS; ++n) {
+    MDBX_val key = {&n, sizeof(n)}, data;
+    const int err = mdbx_get(txn, dbi, &key, &data);
+    if (!gens[n]) {
+      check(err == MDBX_NOTFOUND, "an absent record");
+      continue;
+    }
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_get", err);
+    const size_t words = value_words(n);
+    fill_value(n, gens[n], words);
+    check(data.iov_len == words * sizeof(uint32_t) &&
+              memcmp(data.iov_base, value, data.iov_len) == 0,
+          "the value of a record");
+  }
+}
+
+/* Runs a nested transaction on the given level, which is aborted mostly,
+ * so the model of the level is either merged into the parent or dropped. */
+static void nested(MDBX_txn *parent, unsigned level) {
+  MDBX_txn *txn;
+  int err = mdbx_txn_begin(env, parent, MDBX_TXN_READWRITE, &txn);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_begin(nested)", err);
+  memcpy(model[level], model[level - 1], sizeof(model[level]));
+  update(txn, model[level]);
+  if (level <= DEPTH && prng() % 2)
+    nested(txn, level + 1);
+  update(txn, model[level]);
+  verify(txn, model[level]);
+
+  if (prng() % 4) {
+    err = mdbx_txn_abort(txn);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_txn_abort", err);
+  } else {
+    txn_commit(txn);
+    memcpy(model[level - 1], model[level], sizeof(model[level - 1]));
+  }
+  verify(parent, model[level - 1]);
+}
+
+static void run(MDBX_env_flags_t flags, size_t reserve_limit) {
+  env = env_create();
+  int err = mdbx_env_set_geometry(env, 0, -1, 1 << 30, 1 << 20, 1 << 20, 4096);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  env_open(env, pathname, flags);
+  err = mdbx_env_set_option(env, MDBX_opt_dp_reserve_limit, reserve_limit);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_dp_reserve_limit)", err);
+
+  /* the model of the committed data is on the level 0 */
+  uint32_t *const committed = model[0];
+  for (unsigned i = 0; i < NTXNS; ++i) {
+    MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+    err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_dbi_open", err);
+    memcpy(model[1], committed, sizeof(model[1]));
+    update(txn, model[1]);
+    for (unsigned j = prng() % 4; j > 0; --j)
+      nested(txn, 2);
+    update(txn, model[1]);
+    verify(txn, model[1]);
+    if (prng() % 2) {
+      err = mdbx_txn_abort(txn);
+      if (err != MDBX_SUCCESS)
+        failure("mdbx_txn_abort", err);
+    } else {
+      txn_commit(txn);
+      memcpy(committed, model[1], sizeof(model[0]));
+    }
+
+    MDBX_txn *const reader = txn_begin(env, MDBX_TXN_RDONLY);
+    verify(reader, committed);
+    mdbx_txn_abort(reader);
+  }
+  mdbx_env_close(env);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s dbpath mdbx_chk-pathname\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+
+  db_remove(pathname);
+  run(MDBX_PAGEPERTURB, 1024);
+  run(MDBX_PAGEPERTURB, 1);
+  run(MDBX_ENV_DEFAULTS, 1);
+  db_check(argv[2], pathname);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Benchmark of a huge write transaction, i.e. of lookups within a dirty-page
+ * list of million(s) of items. A single transaction inserts random 8-byte
+ * keys and optionally deletes the given percent of them, while the smallest
+ * database page size makes the count of dirty pages as large as possible.
+ * The spilling is disabled, so all touched pages remain in the dirty list.
+ *
+ * Usage: dpl_bench [-c] [-n puts] [-d percent-of-deletes] [-p pagesize]
+ *                  dbpath
+ *   -c  also verify the committed data. */
+
+#include "common.h"
+
+#include <time.h>
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* xorshift64*, so the sequence of keys is reproducible for deletes */
+static uint64_t next_key(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+  return x * UINT64_C(2685821657736338717);
+}
+
+static bool is_deleted(size_t i, size_t deletes) {
+  return i * deletes / 100 != (i + 1) * deletes / 100;
+}
+
+static void verify(MDBX_env *env, MDBX_dbi dbi, size_t puts, size_t deletes) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_RDONLY);
+  uint64_t state = UINT64_C(0x9E3779B97F4A7C15);
+  size_t kept = 0;
+  for (size_t i = 0; i < puts; ++i) {
+    uint64_t key = next_key(&state);
+    MDBX_val k = {&key, sizeof(key)}, v;
+    const int err = mdbx_get(txn, dbi, &k, &v);
+    if (is_deleted(i, deletes)) {
+      check(err == MDBX_NOTFOUND, "a deleted key is absent");
+      continue;
+    }
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_get", err);
+    check(v.iov_len == sizeof(uint64_t), "the value of a key");
+    kept += 1;
+  }
+  MDBX_stat stat;
+  const int err = mdbx_dbi_stat(txn, dbi, &stat, sizeof(stat));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_stat", err);
+  check(stat.ms_entries == kept, "the count of keys");
+  mdbx_txn_abort(txn);
+}
+
+int main(int argc, char *argv[]) {
+  size_t puts = 2000000, deletes = 0, pagesize = 256;
+  bool verify_data = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "cn:d:p:")) != -1) {
+    switch (opt) {
+    case 'c':
+      verify_data = true;
+      break;
+    case 'n':
+      puts = (size_t)strtoull(optarg, NULL, 0);
+      break;
+    case 'd':
+      deletes = (size_t)strtoull(optarg, NULL, 0);
+      break;
+    case 'p':
+      pagesize = (size_t)strtoull(optarg, NULL, 0);
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [-c] [-n puts] [-d percent-of-deletes] "
+              "[-p pagesize] dbpath\n",
+              argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (optind != argc - 1 || !puts || deletes > 100) {
+    fprintf(stderr, "invalid arguments, see the usage\n");
+    return EXIT_FAILURE;
+  }
+  const char *const pathname = argv[optind];
+
+  db_remove(pathname);
+  MDBX_env *const env = env_create();
+  int err = mdbx_env_set_geometry(env, -1, -1, (intptr_t)1 << 35, -1, -1,
+                                  (intptr_t)pagesize);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  env_open(env, pathname, MDBX_SAFE_NOSYNC | MDBX_NOMETASYNC);
+  err = mdbx_env_set_option(env, MDBX_opt_txn_dp_limit, UINT64_MAX);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_txn_dp_limit)", err);
+
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+  MDBX_dbi dbi;
+  err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+
+  const double start = now();
+  uint64_t state = UINT64_C(0x9E3779B97F4A7C15), value = 0;
+  for (size_t i = 0; i < puts; ++i) {
+    uint64_t key = next_key(&state);
+    MDBX_val k = {&key, sizeof(key)}, v = {&value, sizeof(value)};
+    err = mdbx_put(txn, dbi, &k, &v, MDBX_UPSERT);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_put", err);
+  }
+
+  /* delete the given percent of the inserted keys */
+  state = UINT64_C(0x9E3779B97F4A7C15);
+  for (size_t i = 0; deletes && i < puts; ++i) {
+    uint64_t key = next_key(&state);
+    if (!is_deleted(i, deletes))
+      continue;
+    MDBX_val k = {&key, sizeof(key)};
+    err = mdbx_del(txn, dbi, &k, NULL);
+    if (err != MDBX_SUCCESS && err != MDBX_NOTFOUND)
+      failure("mdbx_del", err);
+  }
+
+  MDBX_txn_info info;
+  err = mdbx_txn_info(txn, &info, false);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_info", err);
+  const double updated = now();
+  txn_commit(txn);
+  const double committed = now();
+
+  printf("%zu puts, %zu%% deletes, %zu-byte pages, %.0fK dirty pages: "
+         "updates %.2fs, commit %.2fs\n",
+         puts, deletes, pagesize,
+         info.txn_space_dirty / (double)pagesize / 1024, updated - start,
+         committed - updated);
+  if (verify_data)
+    verify(env, dbi, puts, deletes);
+  mdbx_env_close(env);
+  return EXIT_SUCCESS;
+}
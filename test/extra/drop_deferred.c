@@ -0,0 +1,244 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of the deferred drop by mdbx_drop_deferred(). A multi-level dupsort
+ * table with nested trees and a table with large values are dropped, then
+ * their pages are reclaimed by a small budget across several commits, both
+ * explicitly by mdbx_drop_reclaim() and automatically during commits. The
+ * database is checked by mdbx_chk after every commit, while the queued
+ * tables are checked to be not accessible by mdbx_dbi_open().
+ *
+ * Usage: drop_deferred dbpath mdbx_chk-pathname */
+
+#include "common.h"
+
+#define PAGESIZE 1024
+#define NKEYS 4000
+#define NDUPS 300
+#define BUDGET 64
+
+static const char *pathname, *chk_pathname;
+static MDBX_env *env;
+
+static void open_db(void) {
+  env = env_create();
+  int err = mdbx_env_set_maxdbs(env, 8);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_maxdbs", err);
+  err = mdbx_env_set_geometry(env, 0, -1, 1 << 30, 1 << 20, 1 << 20,
+                              PAGESIZE);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  env_open(env, pathname, MDBX_ENV_DEFAULTS);
+  /* the pages are reclaimed explicitly unless enabled */
+  err = mdbx_env_set_option(env, MDBX_opt_drop_reclaim_budget, 0);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_drop_reclaim_budget)", err);
+}
+
+/* Closes the database to be checked by mdbx_chk in the exclusive mode. */
+static void check_db(void) {
+  mdbx_env_close(env);
+  db_check(chk_pathname, pathname);
+  open_db();
+}
+
+static MDBX_dbi dbi_open(MDBX_txn *txn, const char *name,
+                         MDBX_db_flags_t flags) {
+  MDBX_dbi dbi;
+  const int err = mdbx_dbi_open(txn, name, flags, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  return dbi;
+}
+
+static void put(MDBX_txn *txn, MDBX_dbi dbi, uint32_t n, const void *data,
+                size_t bytes) {
+  MDBX_val key = {&n, sizeof(n)}, val = {(void *)data, bytes};
+  const int err = mdbx_put(txn, dbi, &key, &val, MDBX_UPSERT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_put", err);
+}
+
+static void fill(void) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+  const MDBX_dbi dups = dbi_open(txn, "dups", MDBX_CREATE | MDBX_DUPSORT);
+  const MDBX_dbi large = dbi_open(txn, "large", MDBX_CREATE);
+  const MDBX_dbi keep = dbi_open(txn, "keep", MDBX_CREATE);
+  static uint32_t buf[3 * PAGESIZE / sizeof(uint32_t)];
+  for (uint32_t n = 0; n < NKEYS; ++n) {
+    /* every 10th key has enough duplicates for a multi-level nested tree,
+     * and a large value */
+    const uint32_t ndups = (n % 10) ? 3 : NDUPS;
+    for (uint32_t i = 0; i < ndups; ++i) {
+      const uint32_t dup[4] = {i, n, ~i, ~n};
+      put(txn, dups, n, dup, sizeof(dup));
+    }
+    buf[0] = n;
+    put(txn, large, n, buf, (n % 10) ? 64 : sizeof(buf));
+    put(txn, keep, n, buf, 64);
+  }
+
+  MDBX_stat stat;
+  const int err = mdbx_dbi_stat(txn, dups, &stat, sizeof(stat));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_stat", err);
+  check(stat.ms_depth > 2, "the depth of the dupsort table");
+  txn_commit(txn);
+}
+
+static void verify_keep(void) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_RDONLY);
+  const MDBX_dbi keep = dbi_open(txn, "keep", MDBX_DB_ACCEDE);
+  MDBX_stat stat;
+  int err = mdbx_dbi_stat(txn, keep, &stat, sizeof(stat));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_stat", err);
+  check(stat.ms_entries == NKEYS, "the count of the kept records");
+  for (uint32_t n = 0; n < NKEYS; ++n) {
+    MDBX_val key = {&n, sizeof(n)}, data;
+    err = mdbx_get(txn, keep, &key, &data);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_get", err);
+    check(data.iov_len == 64 && *(const uint32_t *)data.iov_base == n,
+          "the value of a kept record");
+  }
+
+  MDBX_dbi dbi;
+  err = mdbx_dbi_open(txn, "dups", MDBX_DB_ACCEDE, &dbi);
+  check(err == MDBX_NOTFOUND, "the dropped table is deleted");
+  mdbx_txn_abort(txn);
+}
+
+/* Checks the queued tables are not accessible, returns the count of ones. */
+static unsigned check_hidden(MDBX_txn *txn) {
+  MDBX_dbi dbi;
+  int err = mdbx_dbi_open(txn, NULL, MDBX_DB_ACCEDE, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  MDBX_cursor *cursor;
+  err = mdbx_cursor_open(txn, dbi, &cursor);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_cursor_open", err);
+  unsigned count = 0;
+  MDBX_val key;
+  while ((err = mdbx_cursor_get(cursor, &key, NULL, MDBX_NEXT)) ==
+         MDBX_SUCCESS) {
+    if (key.iov_len < sizeof(MDBX_HIDDEN_TABLE_PREFIX) - 1 ||
+        memcmp(key.iov_base, MDBX_HIDDEN_TABLE_PREFIX,
+               sizeof(MDBX_HIDDEN_TABLE_PREFIX) - 1) != 0)
+      continue;
+    char name[64];
+    check(key.iov_len < sizeof(name), "the length of a hidden name");
+    memcpy(name, key.iov_base, key.iov_len);
+    name[key.iov_len] = '\0';
+    err = mdbx_dbi_open(txn, name, MDBX_DB_ACCEDE, &dbi);
+    check(err == MDBX_EINVAL, "the hidden table can't be opened");
+    count += 1;
+  }
+  if (err != MDBX_NOTFOUND)
+    failure("mdbx_cursor_get", err);
+  mdbx_cursor_close(cursor);
+
+  err = mdbx_dbi_open(txn, MDBX_HIDDEN_TABLE_PREFIX "dropped:0", MDBX_CREATE,
+                      &dbi);
+  check(err == MDBX_EINVAL, "the hidden table can't be created");
+  return count;
+}
+
+/* Reclaims the queued tables by a small budget per commit, either explicitly
+ * or automatically, returns the count of commits. */
+static unsigned reclaim(bool automatic) {
+  int err = mdbx_env_set_option(env, MDBX_opt_drop_reclaim_budget,
+                                automatic ? BUDGET : 0);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_drop_reclaim_budget)", err);
+
+  unsigned commits = 0;
+  size_t left = SIZE_MAX;
+  while (true) {
+    MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+    size_t now;
+    err = mdbx_drop_reclaim(txn, automatic ? 0 : BUDGET, &now);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_drop_reclaim", err);
+    check(now < left, "the progress of reclaiming");
+    left = now;
+    const unsigned hidden = check_hidden(txn);
+    check(left ? hidden > 0 : hidden == 0, "the queued tables are hidden");
+    if (!left) {
+      txn_commit(txn);
+      check_db();
+      break;
+    }
+    if (automatic) {
+      /* change a kept record, since the reclaiming is done by a commit of
+       * a dirty txn only, while putting the same value is a no-op */
+      const MDBX_dbi keep = dbi_open(txn, "keep", MDBX_DB_ACCEDE);
+      const uint32_t buf[16] = {0, commits + 1};
+      put(txn, keep, 0, buf, sizeof(buf));
+    }
+    txn_commit(txn);
+    commits += 1;
+    check_db();
+    err = mdbx_env_set_option(env, MDBX_opt_drop_reclaim_budget,
+                              automatic ? BUDGET : 0);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_env_set_option(MDBX_opt_drop_reclaim_budget)", err);
+  }
+  return commits;
+}
+
+static void drop(const char *name) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+  const MDBX_dbi dbi = dbi_open(txn, name, MDBX_DB_ACCEDE);
+  const int err = mdbx_drop_deferred(txn, dbi, true);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_drop_deferred", err);
+  txn_commit(txn);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s dbpath mdbx_chk-pathname\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+  chk_pathname = argv[2];
+
+  db_remove(pathname);
+  open_db();
+  fill();
+  check_db();
+
+  drop("dups");
+  drop("large");
+  check_db();
+  unsigned commits = reclaim(false);
+  printf("reclaimed explicitly by %u commit(s)\n", commits);
+  check(commits > 2, "the reclaiming by several commits");
+  verify_keep();
+  check_db();
+
+  fill();
+  drop("large");
+  drop("dups");
+  commits = reclaim(true);
+  printf("reclaimed automatically by %u commit(s)\n", commits);
+  check(commits > 2, "the reclaiming by several commits");
+  verify_keep();
+  mdbx_env_close(env);
+  db_check(chk_pathname, pathname);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of reclaiming GC records between snapshots of live readers, see the
+ * MDBX_ENABLE_GC_GAPS build option. A reader A is started, then large values
+ * are inserted and deleted, i.e. their pages are created and retired after
+ * the snapshot of A, while a reader B is started either after the deletion
+ * or before it. Then the same amount of large values is inserted, and the
+ * growth of the database is checked: the pages retired between A and B must
+ * be reused if the option is enabled, while the pages still visible by B
+ * must be not, as well as any pages if the option is disabled. Both readers
+ * check their snapshots are intact at the end. The pages are created and
+ * retired within nested transactions and by a small limit of dirty pages, so
+ * ones are spilled and merged, while the births of retired pages are taken
+ * from their mp_txnid. The readers are run either by the same process or by a child
+ * one, and the database is checked by mdbx_chk after each run.
+ *
+ * Usage: gc_gaps dbpath mdbx_chk-pathname */
+
+#include "common.h"
+
+#include <sys/wait.h>
+
+#define NKEYS 500
+#define NLARGE 64
+#define LARGE_BYTES 60000
+#define PER_TXN 16
+
+static const char *pathname;
+static MDBX_env *env;
+static bool gaps_enabled, pgop_stat;
+static int cmd_pipe[2], ack_pipe[2];
+static pid_t child;
+
+static void open_db(void) {
+  env = env_create();
+  int err = mdbx_env_set_maxdbs(env, 4);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_maxdbs", err);
+  err = mdbx_env_set_geometry(env, 0, -1, 1 << 30, 1 << 20, 1 << 20, 4096);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  env_open(env, pathname, MDBX_NOTLS);
+  err = mdbx_env_set_option(env, MDBX_opt_txn_dp_limit, 128);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_txn_dp_limit)", err);
+}
+
+static MDBX_dbi dbi_open(MDBX_txn *txn, const char *name,
+                         MDBX_db_flags_t flags) {
+  MDBX_dbi dbi;
+  const int err = mdbx_dbi_open(txn, name, flags, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  return dbi;
+}
+
+/*----------------------------------------------------------------------------*/
+/* The readers */
+
+static MDBX_txn *readers[2];
+static uint64_t digests[2];
+
+/* FNV-1a of all keys and values of both tables. */
+static uint64_t digest(MDBX_txn *txn) {
+  uint64_t hash = UINT64_C(14695981039346656037);
+  static const char *const names[] = {"data", "large"};
+  for (size_t i = 0; i < 2; ++i) {
+    MDBX_cursor *cursor;
+    int err = mdbx_cursor_open(txn, dbi_open(txn, names[i], MDBX_DB_ACCEDE),
+                               &cursor);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_cursor_open", err);
+    MDBX_val key, data;
+    while ((err = mdbx_cursor_get(cursor, &key, &data, MDBX_NEXT)) ==
+           MDBX_SUCCESS) {
+      const MDBX_val *const vals[2] = {&key, &data};
+      for (size_t v = 0; v < 2; ++v)
+        for (size_t j = 0; j < vals[v]->iov_len; ++j)
+          hash = (hash ^ ((const uint8_t *)vals[v]->iov_base)[j]) *
+                 UINT64_C(1099511628211);
+    }
+    if (err != MDBX_NOTFOUND)
+      failure("mdbx_cursor_get", err);
+    mdbx_cursor_close(cursor);
+  }
+  return hash;
+}
+
+static void reader_start(size_t n) {
+  readers[n] = txn_begin(env, MDBX_TXN_RDONLY);
+  digests[n] = digest(readers[n]);
+}
+
+/* Checks the snapshots of both readers are intact, then finishes ones. */
+static bool readers_verify(void) {
+  bool ok = true;
+  for (size_t n = 0; n < 2; ++n) {
+    ok &= digest(readers[n]) == digests[n];
+    mdbx_txn_abort(readers[n]);
+  }
+  return ok;
+}
+
+/* Runs the readers by the child process, by the commands from the parent
+ * until the pipe is closed. */
+static void reader_loop(void) {
+  role = "reader";
+  open_db();
+  char cmd;
+  while (read(cmd_pipe[0], &cmd, 1) == 1) {
+    char ack = '+';
+    if (cmd == 'A' || cmd == 'B')
+      reader_start(cmd - 'A');
+    else if (cmd == 'V')
+      ack = readers_verify() ? '+' : '-';
+    else
+      failure("unknown command", MDBX_EINVAL);
+    if (write(ack_pipe[1], &ack, 1) != 1)
+      failure("write", errno);
+  }
+  mdbx_env_close(env);
+  _exit(EXIT_SUCCESS);
+}
+
+static bool reader_cmd(char cmd) {
+  if (!child) {
+    if (cmd == 'V')
+      return readers_verify();
+    reader_start(cmd - 'A');
+    return true;
+  }
+  char ack;
+  if (write(cmd_pipe[1], &cmd, 1) != 1)
+    failure("write", errno);
+  if (read(ack_pipe[0], &ack, 1) != 1)
+    failure("read", errno);
+  return ack == '+';
+}
+
+/*----------------------------------------------------------------------------*/
+/* The writer */
+
+static void fill_large(uint32_t n, uint32_t *buf) {
+  for (size_t i = 0; i < LARGE_BYTES / sizeof(uint32_t); ++i)
+    buf[i] = n * 7 + (uint32_t)i;
+}
+
+/* Puts or deletes the large values, each bunch within a nested txn unless
+ * the pages should be reclaimed between snapshots, which is done by the
+ * top-level txns only. */
+static void update_large(uint32_t first, bool del, bool nested) {
+  static uint32_t buf[LARGE_BYTES / sizeof(uint32_t)];
+  for (uint32_t n = first; n < first + NLARGE; n += PER_TXN) {
+    MDBX_txn *const parent = txn_begin(env, MDBX_TXN_READWRITE), *txn = parent;
+    if (nested) {
+      const int err = mdbx_txn_begin(env, parent, MDBX_TXN_READWRITE, &txn);
+      if (err != MDBX_SUCCESS)
+        failure("mdbx_txn_begin(nested)", err);
+    }
+    const MDBX_dbi dbi = dbi_open(txn, "large", MDBX_DB_ACCEDE);
+    for (uint32_t i = n; i < n + PER_TXN; ++i) {
+      MDBX_val key = {&i, sizeof(i)}, data = {buf, LARGE_BYTES};
+      fill_large(i, buf);
+      const int err = del ? mdbx_del(txn, dbi, &key, NULL)
+                          : mdbx_put(txn, dbi, &key, &data, MDBX_UPSERT);
+      if (err != MDBX_SUCCESS)
+        failure(del ? "mdbx_del" : "mdbx_put", err);
+    }
+    if (nested)
+      txn_commit(txn);
+    txn_commit(parent);
+  }
+}
+
+static MDBX_envinfo env_info(void) {
+  MDBX_envinfo info;
+  const int err = mdbx_env_info_ex(env, NULL, &info, sizeof(info));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_info_ex", err);
+  return info;
+}
+
+static size_t large_pages(void) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_RDONLY);
+  MDBX_stat stat;
+  const int err = mdbx_dbi_stat(
+      txn, dbi_open(txn, "large", MDBX_DB_ACCEDE), &stat, sizeof(stat));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_stat", err);
+  mdbx_txn_abort(txn);
+  return (size_t)stat.ms_overflow_pages;
+}
+
+/* The reader B is started either after the deletion of large values, so
+ * their pages are not visible by any snapshot, or before, i.e. covers ones. */
+static void run(bool by_child, bool covered) {
+  db_remove(pathname);
+  if (by_child) {
+    if (pipe(cmd_pipe) || pipe(ack_pipe))
+      failure("pipe", errno);
+    fflush(NULL);
+    child = fork();
+    if (child < 0)
+      failure("fork", errno);
+    if (child == 0) {
+      close(cmd_pipe[1]), close(ack_pipe[0]);
+      reader_loop();
+    }
+    close(cmd_pipe[0]), close(ack_pipe[1]);
+  }
+
+  open_db();
+  MDBX_txn *txn = txn_begin(env, MDBX_TXN_READWRITE);
+  const MDBX_dbi data = dbi_open(txn, "data", MDBX_CREATE);
+  dbi_open(txn, "large", MDBX_CREATE);
+  for (uint32_t n = 0; n < NKEYS; ++n) {
+    const uint64_t value[8] = {n, ~n};
+    MDBX_val key = {&n, sizeof(n)}, val = {(void *)value, sizeof(value)};
+    const int err = mdbx_put(txn, data, &key, &val, MDBX_UPSERT);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_put", err);
+  }
+  txn_commit(txn);
+
+  check(reader_cmd('A'), "the start of reader A");
+  update_large(0, false, true);
+  if (covered)
+    check(reader_cmd('B'), "the start of reader B");
+  update_large(0, true, true);
+  if (!covered)
+    check(reader_cmd('B'), "the start of reader B");
+  const MDBX_envinfo info = env_info();
+  check(info.mi_pgop_stat.spill > 0 || !pgop_stat, "the pages are spilled");
+
+  update_large(NLARGE, false, false);
+  const size_t growth = (size_t)(env_info().mi_last_pgno - info.mi_last_pgno),
+               demand = large_pages();
+  const bool reused = gaps_enabled && !covered;
+  printf("%s, B %s the deletion: %zu page(s) demanded, the DB grown by %zu\n",
+         by_child ? "by child" : "in-process", covered ? "before" : "after",
+         demand, growth);
+  check(reused ? growth < demand / 4 : growth > demand * 3 / 4,
+        reused ? "the pages between readers are reused"
+               : "the pages visible by a reader are not reused");
+  check(reader_cmd('V'), "the snapshots of readers are intact");
+
+  if (by_child) {
+    close(cmd_pipe[1]), close(ack_pipe[0]);
+    int status;
+    if (waitpid(child, &status, 0) != child)
+      failure("waitpid", errno);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS,
+          "the child reader");
+    child = 0;
+  }
+  mdbx_env_close(env);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s dbpath mdbx_chk-pathname\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+  gaps_enabled = strstr(mdbx_build.options, "MDBX_ENABLE_GC_GAPS=1") != NULL;
+  pgop_stat = strstr(mdbx_build.options, "MDBX_ENABLE_PGOP_STAT=1") != NULL;
+  printf("the reclaiming between snapshots is %s\n",
+         gaps_enabled ? "enabled" : "disabled");
+
+  for (int by_child = 0; by_child < 2; ++by_child)
+    for (int covered = 0; covered < 2; ++covered) {
+      run(by_child, covered);
+      db_check(argv[2], pathname);
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of the GC prefetching by mdbx_env_gc_prefetch(). A few GC records
+ * are made reclaimable, then prefetched and the next write transaction is
+ * checked to adopt the prepared list, i.e. to allocate pages without reading
+ * the GC, as reported by the GC profiling. Then the prepared list is checked
+ * to be dropped after a write transaction committed by another process in
+ * between, and after a reopening of the environment with MDBX_LIFORECLAIM,
+ * while the data stays intact in all cases.
+ *
+ * Usage: gc_prefetch dbpath */
+
+#include "common.h"
+
+#include <sys/wait.h>
+
+#define NKEYS 4000
+#define NCHURNS 8
+
+static const char *pathname;
+static MDBX_env *env;
+static MDBX_dbi dbi;
+static bool profiling;
+static uint32_t generation[NKEYS];
+
+static void open_db(MDBX_env_flags_t flags) {
+  env = env_create();
+  int err = mdbx_env_set_geometry(env, 0, -1, 1 << 30, 1 << 20, 1 << 20, 4096);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  env_open(env, pathname, MDBX_NOTLS | flags);
+  err = mdbx_env_set_option(env, MDBX_opt_gc_profiling, 1);
+  if (err != MDBX_SUCCESS && err != MDBX_ENOSYS)
+    failure("mdbx_env_set_option(MDBX_opt_gc_profiling)", err);
+  profiling = err == MDBX_SUCCESS;
+
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_RDONLY);
+  err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  mdbx_txn_abort(txn);
+}
+
+static void fill_value(uint32_t n, uint32_t gen, uint32_t *buf) {
+  for (size_t i = 0; i < 50; ++i)
+    buf[i] = n * 31 + gen * 7 + (uint32_t)i;
+}
+
+/* Rewrites every step-th of records, so the pages are retired into GC. */
+static void update(MDBX_txn *txn, uint32_t first, uint32_t step) {
+  uint32_t buf[50];
+  for (uint32_t n = first; n < NKEYS; n += step) {
+    fill_value(n, ++generation[n], buf);
+    MDBX_val key = {&n, sizeof(n)}, data = {buf, sizeof(buf)};
+    const int err = mdbx_put(txn, dbi, &key, &data, MDBX_UPSERT);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_put", err);
+  }
+}
+
+/* Commits a write transaction and returns the count of GC reads made for the
+ * user data, or UINT32_MAX if the GC profiling is not available. The GC
+ * profiling counters are accumulated until a commit with the latency, so
+ * each write transaction is committed such way. */
+static uint32_t commit(MDBX_txn *txn) {
+  MDBX_commit_latency latency;
+  const int err = mdbx_txn_commit_ex(txn, &latency);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_commit_ex", err);
+  return profiling ? latency.gc_prof.work_rsteps : UINT32_MAX;
+}
+
+/* Runs a write transaction which rewrites every step-th of records, see
+ * commit() for the result. */
+static uint32_t write_txn(uint32_t first, uint32_t step) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+  update(txn, first, step);
+  return commit(txn);
+}
+
+/* Makes a few GC records, which become reclaimable all at once since the
+ * reader holding the snapshot before them is finished. */
+static void churn(void) {
+  MDBX_txn *const reader = txn_begin(env, MDBX_TXN_RDONLY);
+  for (uint32_t i = 0; i < NCHURNS; ++i)
+    write_txn(i, NCHURNS);
+  const int err = mdbx_txn_abort(reader);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_abort", err);
+
+  /* the finished reader is noticed only by a writer, so a tiny write txn is
+   * needed for mdbx_env_gc_prefetch() to see the records reclaimable */
+  write_txn(0, NKEYS);
+}
+
+static void verify(void) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_RDONLY);
+  uint32_t buf[50];
+  for (uint32_t n = 0; n < NKEYS; ++n) {
+    MDBX_val key = {&n, sizeof(n)}, data;
+    const int err = mdbx_get(txn, dbi, &key, &data);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_get", err);
+    fill_value(n, generation[n], buf);
+    check(data.iov_len == sizeof(buf) &&
+              memcmp(data.iov_base, buf, sizeof(buf)) == 0,
+          "the value of a record");
+  }
+  MDBX_stat stat;
+  const int err = mdbx_dbi_stat(txn, dbi, &stat, sizeof(stat));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_stat", err);
+  check(stat.ms_entries == NKEYS, "the count of records");
+  mdbx_txn_abort(txn);
+}
+
+static void prefetch(void) {
+  const int err = mdbx_env_gc_prefetch(env);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_gc_prefetch", err);
+}
+
+/* Checks the prefetched list is adopted by the next write transaction. */
+static void check_adoption(const char *what) {
+  churn();
+  prefetch();
+  const uint32_t rsteps = write_txn(0, NCHURNS);
+  printf("%s: %u GC read(s) after the adoption\n", what, rsteps);
+  check(rsteps == 0 || !profiling, "the adoption of the prefetched list");
+  verify();
+}
+
+/* Commits a write transaction by another process. */
+static void commit_by_other(void) {
+  const pid_t pid = fork();
+  if (pid < 0)
+    failure("fork", errno);
+  if (pid == 0) {
+    /* the env of the parent must not be used nor closed after fork() */
+    role = "child";
+    open_db(MDBX_ENV_DEFAULTS);
+    write_txn(1, NCHURNS);
+    mdbx_env_close(env);
+    _exit(EXIT_SUCCESS);
+  }
+  int status;
+  if (waitpid(pid, &status, 0) != pid)
+    failure("waitpid", errno);
+  check(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS,
+        "the commit by another process");
+  for (uint32_t n = 1; n < NKEYS; n += NCHURNS)
+    generation[n] += 1;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s dbpath\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+
+  db_remove(pathname);
+  open_db(MDBX_ENV_DEFAULTS);
+  write_txn(0, 1);
+  if (!profiling)
+    printf("the GC profiling is not available, the adoption is not checked\n");
+
+  check_adoption("FIFO");
+
+  /* the prefetched list is dropped after a commit in between */
+  churn();
+  prefetch();
+  commit_by_other();
+  uint32_t rsteps = write_txn(2, NCHURNS);
+  printf("%u GC read(s) after a commit in between\n", rsteps);
+  check(rsteps > 0, "the drop of the prefetched list after a commit");
+  verify();
+
+  /* the prefetched list is dropped on closing, so the reopened environment
+   * with the other reclaiming order does not use it */
+  churn();
+  prefetch();
+  mdbx_env_close(env);
+  open_db(MDBX_LIFORECLAIM);
+  rsteps = write_txn(3, NCHURNS);
+  printf("%u GC read(s) after the reopening with MDBX_LIFORECLAIM\n", rsteps);
+  check(rsteps > 0, "the drop of the prefetched list after a reopening");
+  verify();
+
+  check_adoption("LIFO");
+  mdbx_env_close(env);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of nested transactions under a parent with a huge dirty list, i.e.
+ * above the MDBX_DPL_HASH_THRESHOLD of 8192 pages, where the incremental
+ * merge is used on commit of a small nested transaction. The nested ones
+ * (and a few of their own nested ones) delete ranges of records, so pages
+ * become loose, insert records, so pages are reclaimed from the GC and from
+ * the parent's lists, and rewrite records untouched by the parent, so pages
+ * are retired. About a half of them is aborted. The data is checked against
+ * the model after each transaction, and the database by mdbx_chk after each
+ * top-level commit.
+ *
+ * Usage: nested_huge dbpath mdbx_chk-pathname */
+
+#include "common.h"
+
+#define PAGESIZE 256
+#define NKEYS 250000
+#define NROUNDS 2
+#define NCHILDREN 16
+#define DPL_HASH_THRESHOLD 8192
+
+static const char *pathname, *chk_pathname;
+static MDBX_env *env;
+static MDBX_dbi dbi;
+/* the generation of each record per level, zero if the record is absent */
+static uint32_t model[4][NKEYS];
+static uint64_t prng_state = UINT64_C(0x9E3779B97F4A7C15);
+
+static uint32_t prng(void) {
+  prng_state = prng_state * UINT64_C(6364136223846793005) +
+               UINT64_C(1442695040888963407);
+  return (uint32_t)(prng_state >> 33);
+}
+
+static void open_db(void) {
+  env = env_create();
+  int err = mdbx_env_set_geometry(env, 0, -1, 1 << 30, 1 << 20, 1 << 20,
+                                  PAGESIZE);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  env_open(env, pathname, MDBX_ENV_DEFAULTS);
+  /* no spilling, otherwise the incremental merge is not applicable */
+  err = mdbx_env_set_option(env, MDBX_opt_txn_dp_limit, UINT64_MAX);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_txn_dp_limit)", err);
+}
+
+static void put(MDBX_txn *txn, uint32_t *gens, uint32_t n) {
+  /* the big-endian keys, so the ranges of ones are adjacent in the b-tree */
+  const uint32_t be = __builtin_bswap32(n), value[2] = {n, ++gens[n]};
+  MDBX_val key = {(void *)&be, sizeof(be)},
+           data = {(void *)value, sizeof(value)};
+  const int err = mdbx_put(txn, dbi, &key, &data, MDBX_UPSERT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_put", err);
+}
+
+static void del(MDBX_txn *txn, uint32_t *gens, uint32_t n) {
+  const uint32_t be = __builtin_bswap32(n);
+  MDBX_val key = {(void *)&be, sizeof(be)};
+  const int err = mdbx_del(txn, dbi, &key, NULL);
+  if (err != (gens[n] ? MDBX_SUCCESS : MDBX_NOTFOUND))
+    failure("mdbx_del", err);
+  gens[n] = 0;
+}
+
+static void verify(MDBX_txn *txn, const uint32_t *gens) {
+  size_t count = 0;
+  for (uint32_t n = 0; n < NKEYS; ++n) {
+    const uint32_t be = __builtin_bswap32(n);
+    MDBX_val key = {(void *)&be, sizeof(be)}, data;
+    const int err = mdbx_get(txn, dbi, &key, &data);
+    if (!gens[n]) {
+      check(err == MDBX_NOTFOUND, "an absent record");
+      continue;
+    }
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_get", err);
+    const uint32_t *const value = data.iov_base;
+    check(data.iov_len == 2 * sizeof(uint32_t) && value[0] == n &&
+              value[1] == gens[n],
+          "the value of a record");
+    count += 1;
+  }
+  MDBX_stat stat;
+  const int err = mdbx_dbi_stat(txn, dbi, &stat, sizeof(stat));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_stat", err);
+  check(stat.ms_entries == count, "the count of records");
+}
+
+static size_t dirty_pages(MDBX_txn *txn) {
+  MDBX_txn_info info;
+  const int err = mdbx_txn_info(txn, &info, false);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_info", err);
+  return info.txn_space_dirty / PAGESIZE;
+}
+
+/* Makes a set of changes within a nested transaction on the given level,
+ * the parent's half of records is left untouched to be retired here. */
+static void nested(MDBX_txn *parent, unsigned level) {
+  MDBX_txn *txn;
+  int err = mdbx_txn_begin(env, parent, MDBX_TXN_READWRITE, &txn);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_begin(nested)", err);
+  uint32_t *const gens = model[level];
+  memcpy(gens, model[level - 1], sizeof(model[level]));
+
+  /* delete a range, so the emptied pages become loose or retired */
+  const uint32_t first = prng() % NKEYS, last = first + prng() % 2000;
+  for (uint32_t n = first; n < last && n < NKEYS; ++n)
+    if (gens[n])
+      del(txn, gens, n);
+  /* rewrite records of the clean half, so pages are retired */
+  for (unsigned i = prng() % 500; i > 0; --i)
+    put(txn, gens, NKEYS / 2 + prng() % (NKEYS / 2));
+  if (level < 3 && prng() % 3 == 0)
+    nested(txn, level + 1);
+  /* insert the deleted records back partially, so pages are reclaimed */
+  for (uint32_t n = first; n < last && n < NKEYS; n += 1 + prng() % 3)
+    put(txn, gens, n);
+  verify(txn, gens);
+
+  if (prng() % 2) {
+    err = mdbx_txn_abort(txn);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_txn_abort", err);
+  } else {
+    txn_commit(txn);
+    memcpy(model[level - 1], gens, sizeof(model[level - 1]));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s dbpath mdbx_chk-pathname\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+  chk_pathname = argv[2];
+
+  db_remove(pathname);
+  open_db();
+  MDBX_txn *txn = txn_begin(env, MDBX_TXN_READWRITE);
+  int err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  for (uint32_t n = 0; n < NKEYS; ++n)
+    put(txn, model[0], n);
+  txn_commit(txn);
+
+  for (unsigned round = 0; round < NROUNDS; ++round) {
+    /* make a few GC records to be reclaimed by the nested transactions */
+    for (unsigned i = 0; i < 4; ++i) {
+      txn = txn_begin(env, MDBX_TXN_READWRITE);
+      for (uint32_t n = i; n < NKEYS; n += 64)
+        put(txn, model[0], n);
+      txn_commit(txn);
+    }
+
+    /* the parent with the huge dirty list, which is the first half */
+    txn = txn_begin(env, MDBX_TXN_READWRITE);
+    memcpy(model[1], model[0], sizeof(model[1]));
+    for (uint32_t n = 0; n < NKEYS / 2; ++n)
+      put(txn, model[1], n);
+    check(dirty_pages(txn) > DPL_HASH_THRESHOLD, "the huge dirty list");
+
+    for (unsigned i = 0; i < NCHILDREN; ++i) {
+      nested(txn, 2);
+      verify(txn, model[1]);
+    }
+    txn_commit(txn);
+    memcpy(model[0], model[1], sizeof(model[0]));
+
+    mdbx_env_close(env);
+    db_check(chk_pathname, pathname);
+    open_db();
+    txn = txn_begin(env, MDBX_TXN_RDONLY);
+    verify(txn, model[0]);
+    mdbx_txn_abort(txn);
+  }
+  mdbx_env_close(env);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Self-check of the lower bounds of reader groups, i.e. of searching for the
+ * oldest reader by find_oldest_reader(). A few threads churn read-only
+ * transactions with random delays, while publishing the txnid of each one
+ * for its whole lifetime. The readers table is grown to a few groups before,
+ * so the slots are taken from all of ones and the groups become empty and
+ * populated back from time to time. Meanwhile, a writer commits and checks
+ * that the oldest reader it finds never exceeds the txnid of any live reader.
+ * Since the search is internal, the library sources are included here
+ * directly.
+ *
+ * Usage: oldest_check dbpath [commits] */
+
+#include "alloy.c"
+
+#include <pthread.h>
+
+#define NTHREADS 4
+#define NHELD 4
+#define NRGROUPS 4
+
+static MDBX_env *env;
+static MDBX_atomic_uint64_t held[NTHREADS][NHELD];
+static MDBX_atomic_uint32_t stop;
+
+static void failure(const char *what, int err) {
+  printf("%s failed: %s\n", what, mdbx_strerror(err));
+  exit(EXIT_FAILURE);
+}
+
+static uint32_t prng(uint64_t *state) {
+  *state = *state * UINT64_C(6364136223846793005) +
+           UINT64_C(1442695040888963407);
+  return (uint32_t)(*state >> 33);
+}
+
+/* Starts, renews and finishes the read-only transactions at random, while
+ * the txnid of each one is published after the start and before the end. */
+static void *reader(void *arg) {
+  MDBX_atomic_uint64_t *const slots = held[(intptr_t)arg];
+  MDBX_txn *txns[NHELD] = {nullptr};
+  uint64_t state = (uintptr_t)arg * UINT64_C(0x9E3779B97F4A7C15) + 1;
+  while (!atomic_load32(&stop, mo_AcquireRelease)) {
+    const size_t i = prng(&state) % NHELD;
+    int err = MDBX_SUCCESS;
+    if (!txns[i])
+      err = mdbx_txn_begin(env, nullptr, MDBX_TXN_RDONLY, &txns[i]);
+    else {
+      atomic_store64(&slots[i], 0, mo_AcquireRelease);
+      if (prng(&state) % 4)
+        err = mdbx_txn_abort(txns[i]), txns[i] = nullptr;
+      else if ((err = mdbx_txn_reset(txns[i])) == MDBX_SUCCESS) {
+        osal_jitter(true);
+        err = mdbx_txn_renew(txns[i]);
+      }
+    }
+    if (err != MDBX_SUCCESS)
+      failure("the reader", err);
+    if (txns[i])
+      atomic_store64(&slots[i], mdbx_txn_id(txns[i]), mo_AcquireRelease);
+    osal_jitter(prng(&state) % 8 != 0);
+  }
+  for (size_t i = 0; i < NHELD; ++i)
+    if (txns[i]) {
+      atomic_store64(&slots[i], 0, mo_AcquireRelease);
+      mdbx_txn_abort(txns[i]);
+    }
+  return nullptr;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s dbpath [commits]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  const char *const pathname = argv[1];
+  const size_t commits = (argc > 2) ? strtoul(argv[2], nullptr, 0) : 2000;
+  mdbx_env_delete(pathname, MDBX_ENV_JUST_DELETE);
+  mdbx_setup_debug(MDBX_LOG_DONTCHANGE, MDBX_DBG_JITTER | MDBX_DBG_ASSERT,
+                   MDBX_LOGGER_DONTCHANGE);
+
+  int err = mdbx_env_create(&env);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_create", err);
+  /* the fixed size, since the resizing of the mapping by the writer while
+   * the threads of readers are running is out of the scope here */
+  err = mdbx_env_set_geometry(env, 1 << 22, 1 << 22, 1 << 22, -1, -1, -1);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  err = mdbx_env_set_maxreaders(env, NRGROUPS * MDBX_RGROUP_SIZE);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_maxreaders", err);
+  /* the durable commits, so the steady meta is the recent one and the oldest
+   * reader is not limited by it */
+  err = mdbx_env_open(env, pathname, MDBX_NOSUBDIR | MDBX_NOTLS, 0644);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_open", err);
+
+  static MDBX_txn *grow[NRGROUPS * MDBX_RGROUP_SIZE];
+  for (size_t i = 0; i < NRGROUPS * MDBX_RGROUP_SIZE; ++i)
+    if ((err = mdbx_txn_begin(env, nullptr, MDBX_TXN_RDONLY, &grow[i])) !=
+        MDBX_SUCCESS)
+      failure("mdbx_txn_begin", err);
+  for (size_t i = 0; i < NRGROUPS * MDBX_RGROUP_SIZE; ++i)
+    mdbx_txn_abort(grow[i]);
+
+  pthread_t threads[NTHREADS];
+  for (intptr_t n = 0; n < NTHREADS; ++n)
+    if ((err = pthread_create(&threads[n], nullptr, reader, (void *)n)) != 0)
+      failure("pthread_create", err);
+
+  size_t lagging = 0;
+  for (size_t i = 0; i < commits; ++i) {
+    MDBX_txn *txn;
+    err = mdbx_txn_begin(env, nullptr, MDBX_TXN_READWRITE, &txn);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_txn_begin", err);
+    MDBX_dbi dbi;
+    err = mdbx_dbi_open(txn, nullptr, 0, &dbi);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_dbi_open", err);
+    const uint64_t key = i % 256, value[16] = {i};
+    MDBX_val k = {(void *)&key, sizeof(key)},
+             v = {(void *)value, sizeof(value)};
+    err = mdbx_put(txn, dbi, &k, &v, MDBX_UPSERT);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_put", err);
+
+    /* any reader which is live now was either started before the search,
+     * so it must be seen, or started after with the recent txnid */
+    const txnid_t oldest = txn_oldest_reader(txn);
+    for (size_t n = 0; n < NTHREADS; ++n)
+      for (size_t j = 0; j < NHELD; ++j) {
+        const txnid_t txnid = atomic_load64(&held[n][j], mo_AcquireRelease);
+        if (txnid && txnid < oldest) {
+          printf("the oldest %" PRIaTXN " exceeds the reader %" PRIaTXN
+                 " at the commit %zu\n",
+                 oldest, txnid, i);
+          return EXIT_FAILURE;
+        }
+      }
+    lagging += oldest + 1 < txn->mt_txnid;
+
+    err = mdbx_txn_commit(txn);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_txn_commit", err);
+    osal_jitter(true);
+  }
+
+  atomic_store32(&stop, true, mo_AcquireRelease);
+  for (size_t n = 0; n < NTHREADS; ++n)
+    pthread_join(threads[n], nullptr);
+  mdbx_env_close(env);
+
+  printf("%zu commit(s), %zu with lagging readers\n", commits, lagging);
+  if (!lagging) {
+    printf("no lagging readers\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
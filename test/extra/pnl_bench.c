@@ -0,0 +1,328 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Microbenchmark and self-check of the vectorized kernels for merging and
+ * searching of the sorted lists of page numbers, i.e. PNL and DPL, against
+ * the scalar ones, also a self-check of merging a dense PNL by runs. Since
+ * the kernels are internal, the library sources are included here directly.
+ *
+ * Usage: pnl_bench [--check] [length]
+ *   --check  only verify the results of all available kernels and merging. */
+
+#include "alloy.c"
+
+typedef struct variant {
+  const char *name;
+  const char *feature;
+  kspan_t (*ksearch)(const pgno_t *const ptr, const size_t stride,
+                     const size_t length, const pgno_t key,
+                     const uint32_t xmask);
+  void (*vmerge)(pgno_t *__restrict dst, size_t a,
+                 const pgno_t *__restrict src, size_t b);
+} variant_t;
+
+static const variant_t variants[] = {
+    {"fallback", nullptr, ksearch_fallback, vmerge_fallback},
+#ifdef MDBX_ATTRIBUTE_TARGET_SSE2
+    {"sse2", "sse2", ksearch_sse2, vmerge_sse2},
+#endif /* MDBX_ATTRIBUTE_TARGET_SSE2 */
+#ifdef MDBX_ATTRIBUTE_TARGET_AVX2
+    {"avx2", "avx2", ksearch_avx2, vmerge_avx2},
+#endif /* MDBX_ATTRIBUTE_TARGET_AVX2 */
+#ifdef MDBX_ATTRIBUTE_TARGET_AVX512BW
+    {"avx512bw", "avx512bw", ksearch_avx512bw, vmerge_avx2},
+#endif /* MDBX_ATTRIBUTE_TARGET_AVX512BW */
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) &&                          \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    {"neon", nullptr, ksearch_neon, vmerge_neon},
+#endif /* __ARM_NEON || __ARM_NEON__ */
+};
+
+static bool supported(const variant_t *v) {
+  if (!v->feature)
+    return true;
+#if MDBX_HAVE_BUILTIN_CPU_SUPPORTS
+  __builtin_cpu_init();
+  if (strcmp(v->feature, "sse2") == 0)
+    return __builtin_cpu_supports("sse2");
+  if (strcmp(v->feature, "avx2") == 0)
+    return __builtin_cpu_supports("avx2");
+  if (strcmp(v->feature, "avx512bw") == 0)
+    return __builtin_cpu_supports("avx512bw");
+  return false;
+#else
+  return true /* assume the build flags match to the CPU */;
+#endif /* MDBX_HAVE_BUILTIN_CPU_SUPPORTS */
+}
+
+static uint64_t prng_state = UINT64_C(0x9E3779B97F4A7C15);
+static uint32_t prng(void) {
+  prng_state = prng_state * UINT64_C(6364136223846793005) +
+               UINT64_C(1442695040888963407);
+  return (uint32_t)(prng_state >> 32);
+}
+
+static double ns_per_op(uint64_t monotime, size_t ops) {
+  return osal_monotime_to_16dot16(monotime) * 1e9 / 65536.0 / (double)ops;
+}
+
+/* Fills the two disjoint sorted PNLs, also the merged one for reference */
+static void fill_pair(MDBX_PNL a, size_t a_len, MDBX_PNL b, size_t b_len,
+                      MDBX_PNL merged) {
+  const size_t total = a_len + b_len;
+  pgno_t pgno = NUM_METAS;
+  for (size_t i = 1; i <= total; ++i) {
+    pgno += 1 + prng() % 3;
+    merged[i] = pgno;
+  }
+  MDBX_PNL_SETSIZE(merged, total);
+  pnl_sort(merged, MAX_PAGENO + 1);
+  size_t na = 0, nb = 0;
+  for (size_t i = 1; i <= total; ++i) {
+    const bool to_a = (nb == b_len) || (na < a_len && prng() % total < a_len);
+    if (to_a)
+      a[++na] = merged[i];
+    else
+      b[++nb] = merged[i];
+  }
+  MDBX_PNL_SETSIZE(a, na);
+  MDBX_PNL_SETSIZE(b, nb);
+}
+
+static int check_merge(const variant_t *v, size_t length) {
+  MDBX_PNL a = pnl_alloc(length * 2 + 64), b = pnl_alloc(length + 64),
+           merged = pnl_alloc(length * 2 + 64);
+  int rc = EXIT_SUCCESS;
+  for (size_t a_len = MDBX_VMERGE_THRESHOLD; a_len <= length && !rc;
+       a_len = a_len * 2 + prng() % 16) {
+    for (size_t b_len = MDBX_VMERGE_THRESHOLD; b_len <= length;
+         b_len = b_len * 3 + prng() % 16) {
+      fill_pair(a, a_len, b, b_len, merged);
+      v->vmerge(a, a_len, b, b_len);
+      MDBX_PNL_SETSIZE(a, a_len + b_len);
+      if (memcmp(a, merged, (a_len + b_len + 1) * sizeof(pgno_t))) {
+        printf("%s: merge mismatch for %zu + %zu items\n", v->name, a_len,
+               b_len);
+        rc = EXIT_FAILURE;
+        break;
+      }
+    }
+  }
+  pnl_free(a);
+  pnl_free(b);
+  pnl_free(merged);
+  return rc;
+}
+
+/* Checks the merging by runs within pnl_merge(), which is used for a dense
+ * source, i.e. consisting of a few long runs of the adjacent page numbers,
+ * while the destination items are spread before, between and after ones. */
+static int check_merge_runs(size_t length) {
+  MDBX_PNL dst = pnl_alloc(length * 2 + 64), src = pnl_alloc(length + 64),
+           merged = pnl_alloc(length * 2 + 64);
+  int rc = EXIT_SUCCESS;
+  size_t dense = 0, cases = 0;
+  for (size_t src_len = 33; src_len <= length && !rc;
+       src_len = src_len * 2 + prng() % 16) {
+    for (size_t dst_len = 0; dst_len <= length;
+         dst_len = dst_len * 3 + 1 + prng() % 16) {
+      /* the destination items within the span of the source are limited,
+       * so the source remains dense */
+      const size_t inner = (dst_len < src_len / 8) ? dst_len : src_len / 8;
+      size_t ns = 0, nd = 0, n = 0;
+      pgno_t pgno = NUM_METAS;
+      for (size_t i = 0; i < (dst_len - inner) / 2; ++i)
+        merged[++n] = dst[++nd] = pgno += 1 + prng() % 3;
+      pgno += 1 + prng() % 3;
+      while (ns < src_len) {
+        for (size_t run = 1 + prng() % 64; run && ns < src_len; --run)
+          merged[++n] = src[++ns] = pgno++;
+        if (nd < (dst_len - inner) / 2 + inner && prng() % 2)
+          merged[++n] = dst[++nd] = pgno++;
+      }
+      while (nd < dst_len)
+        merged[++n] = dst[++nd] = pgno += 1 + prng() % 3;
+      MDBX_PNL_SETSIZE(dst, nd);
+      MDBX_PNL_SETSIZE(src, ns);
+      MDBX_PNL_SETSIZE(merged, n);
+      pnl_sort(dst, MAX_PAGENO + 1);
+      pnl_sort(src, MAX_PAGENO + 1);
+      pnl_sort(merged, MAX_PAGENO + 1);
+
+      cases += 1;
+      dense += MDBX_PNL_MOST(src) - MDBX_PNL_LEAST(src) < ns + ns / 4;
+      pnl_merge(dst, src);
+      if (memcmp(dst, merged, (n + 1) * sizeof(pgno_t))) {
+        printf("runs: merge mismatch for %zu + %zu items\n", nd, ns);
+        rc = EXIT_FAILURE;
+        break;
+      }
+    }
+  }
+  if (!rc && dense != cases) {
+    printf("runs: only %zu of %zu sources are dense\n", dense, cases);
+    rc = EXIT_FAILURE;
+  }
+  pnl_free(dst);
+  pnl_free(src);
+  pnl_free(merged);
+  return rc;
+}
+
+static int check_search(const variant_t *v, size_t length) {
+  MDBX_PNL pnl = pnl_alloc(length);
+  MDBX_dp *const dp = osal_malloc(sizeof(MDBX_dp) * (length + 1));
+  int rc = EXIT_SUCCESS;
+  for (size_t n = MDBX_KSEARCH_TAIL + 1; n <= length && !rc;
+       n = n * 2 + prng() % 64) {
+    pgno_t pgno = NUM_METAS;
+    for (size_t i = 0; i < n; ++i) {
+      pgno += 1 + prng() % 4;
+      dp[i].pgno = pgno;
+      MDBX_PNL_ASCENDING ? (pnl[i + 1] = pgno) : (pnl[n - i] = pgno);
+    }
+    MDBX_PNL_SETSIZE(pnl, n);
+    for (size_t i = 0; i < 1000; ++i) {
+      const pgno_t key = prng() % (pgno + 2);
+      const kspan_t ps = v->ksearch(pnl + 1, 1, n, key, KSEARCH_PNL);
+      const kspan_t ds =
+          v->ksearch(&dp[0].pgno, sizeof(MDBX_dp) / sizeof(pgno_t), n, key,
+                     KSEARCH_ASCENDING);
+      if (pgno_bsearch(pnl + 1 + ps.begin, ps.length, key) !=
+              pgno_bsearch(pnl + 1, n, key) ||
+          dp_bsearch(dp + ds.begin, ds.length, key) != dp_bsearch(dp, n, key)) {
+        printf("%s: search mismatch for %u in %zu items\n", v->name, key, n);
+        rc = EXIT_FAILURE;
+        break;
+      }
+    }
+  }
+  pnl_free(pnl);
+  osal_free(dp);
+  return rc;
+}
+
+static void bench_merge(const variant_t *v, size_t length) {
+  MDBX_PNL a = pnl_alloc(length * 2), b = pnl_alloc(length),
+           merged = pnl_alloc(length * 2), copy = pnl_alloc(length * 2);
+  fill_pair(a, length, b, length, merged);
+  memcpy(copy, a, (length + 1) * sizeof(pgno_t));
+  const size_t rounds = 64 * 1024 * 1024 / length + 1;
+  uint64_t scalar = 0, vector = 0;
+  for (size_t i = 0; i < rounds; ++i) {
+    memcpy(a, copy, (length + 1) * sizeof(pgno_t));
+    uint64_t start = osal_monotime();
+    vmerge_fallback(a, length, b, length);
+    scalar += osal_monotime() - start;
+    memcpy(a, copy, (length + 1) * sizeof(pgno_t));
+    start = osal_monotime();
+    v->vmerge(a, length, b, length);
+    vector += osal_monotime() - start;
+  }
+  printf("  merge %zu + %zu: scalar %.2f, %s %.2f ns/item\n", length, length,
+         ns_per_op(scalar, rounds * length * 2), v->name,
+         ns_per_op(vector, rounds * length * 2));
+  pnl_free(a);
+  pnl_free(b);
+  pnl_free(merged);
+  pnl_free(copy);
+}
+
+static void bench_search(const variant_t *v, size_t length) {
+  MDBX_PNL pnl = pnl_alloc(length);
+  MDBX_dp *const dp = osal_malloc(sizeof(MDBX_dp) * length);
+  pgno_t pgno = NUM_METAS;
+  for (size_t i = 0; i < length; ++i) {
+    pgno += 1 + prng() % 4;
+    dp[i].pgno = pgno;
+    MDBX_PNL_ASCENDING ? (pnl[i + 1] = pgno) : (pnl[length - i] = pgno);
+  }
+  MDBX_PNL_SETSIZE(pnl, length);
+
+  const size_t ops = 4 * 1024 * 1024;
+  pgno_t *const keys = osal_malloc(sizeof(pgno_t) * ops);
+  for (size_t i = 0; i < ops; ++i)
+    keys[i] = prng() % pgno;
+
+  size_t sum = 0;
+  uint64_t start = osal_monotime();
+  for (size_t i = 0; i < ops; ++i)
+    sum += pgno_bsearch(pnl + 1, length, keys[i]) - pnl;
+  const uint64_t pnl_scalar = osal_monotime() - start;
+  start = osal_monotime();
+  for (size_t i = 0; i < ops; ++i) {
+    const kspan_t s = v->ksearch(pnl + 1, 1, length, keys[i], KSEARCH_PNL);
+    sum -= pgno_bsearch(pnl + 1 + s.begin, s.length, keys[i]) - pnl;
+  }
+  const uint64_t pnl_vector = osal_monotime() - start;
+
+  start = osal_monotime();
+  for (size_t i = 0; i < ops; ++i)
+    sum += dp_bsearch(dp, length, keys[i]) - dp;
+  const uint64_t dpl_scalar = osal_monotime() - start;
+  start = osal_monotime();
+  for (size_t i = 0; i < ops; ++i) {
+    const kspan_t s =
+        v->ksearch(&dp[0].pgno, sizeof(MDBX_dp) / sizeof(pgno_t), length,
+                   keys[i], KSEARCH_ASCENDING);
+    sum -= dp_bsearch(dp + s.begin, s.length, keys[i]) - dp;
+  }
+  const uint64_t dpl_vector = osal_monotime() - start;
+
+  printf("  search in %zu: PNL scalar %.1f, %s %.1f; DPL scalar %.1f, %s %.1f "
+         "ns/op%s\n",
+         length, ns_per_op(pnl_scalar, ops), v->name,
+         ns_per_op(pnl_vector, ops), ns_per_op(dpl_scalar, ops), v->name,
+         ns_per_op(dpl_vector, ops), sum ? " (MISMATCH)" : "");
+  pnl_free(pnl);
+  osal_free(dp);
+  osal_free(keys);
+}
+
+int main(int argc, char *argv[]) {
+  bool check_only = false;
+  size_t length = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--check") == 0)
+      check_only = true;
+    else
+      length = strtoul(argv[i], nullptr, 0);
+  }
+  if (!length)
+    length = check_only ? 4096 : 1024 * 1024;
+
+  int rc = check_merge_runs(check_only ? length : 4096);
+  if (rc == EXIT_SUCCESS)
+    printf("runs: ok\n");
+  for (size_t i = 0; i < ARRAY_LENGTH(variants); ++i) {
+    const variant_t *const v = variants + i;
+    if (!supported(v)) {
+      printf("%s: not supported by CPU, skipped\n", v->name);
+      continue;
+    }
+    if (check_merge(v, check_only ? length : 4096) ||
+        check_search(v, check_only ? length : 4096)) {
+      rc = EXIT_FAILURE;
+      continue;
+    }
+    printf("%s: ok\n", v->name);
+    if (!check_only) {
+      for (size_t n = 1024; n <= length; n <<= 4) {
+        bench_merge(v, n);
+        bench_search(v, n);
+      }
+    }
+  }
+  return rc;
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Multi-process benchmark of starting read transactions, i.e. of binding
+ * reader slots. By default the MDBX_NOTLS mode is used, where a slot is
+ * bound for every transaction. Otherwise each thread unregisters after
+ * every transaction, which is equivalent to short-lived threads.
+ * With the -S option the transactions are started from a snapshot shared
+ * by all threads of a process, i.e. without binding reader slots at all.
+ *
+ * Usage: rslot_bench [-c] [-p processes] [-t threads] [-s seconds] [-T] [-S]
+ *                    dbpath
+ *   -c  also check every thread made progress and no reader slot is left
+ *       in use after all processes are finished. */
+
+#include "common.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+
+static const char *pathname;
+static unsigned processes = 1, threads = 1, seconds = 3;
+static bool check_mode, tls_mode, snapshot_mode;
+static MDBX_env *env;
+static MDBX_snapshot *snapshot;
+static volatile uint64_t *counters /* shared between processes */;
+static volatile int stop;
+
+static void *worker(void *arg) {
+  volatile uint64_t *const counter = arg;
+  uint64_t n = 0;
+  while (!stop) {
+    MDBX_txn *txn;
+    int err = snapshot_mode
+                  ? mdbx_txn_begin_snapshot(snapshot, &txn, NULL)
+                  : mdbx_txn_begin(env, NULL, MDBX_TXN_RDONLY, &txn);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_txn_begin", err);
+    err = mdbx_txn_abort(txn);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_txn_abort", err);
+    if (tls_mode && !snapshot_mode) {
+      err = mdbx_thread_unregister(env);
+      if (err != MDBX_SUCCESS)
+        failure("mdbx_thread_unregister", err);
+    }
+    if ((++n & 1023) == 0)
+      *counter = n;
+  }
+  *counter = n;
+  return NULL;
+}
+
+static void on_alarm(int sig) {
+  (void)sig;
+  stop = 1;
+}
+
+static int count_reader(void *ctx, int num, int slot, mdbx_pid_t pid,
+                        mdbx_tid_t thread, uint64_t txnid, uint64_t lag,
+                        size_t bytes_used, size_t bytes_retained) {
+  (void)num;
+  (void)thread;
+  (void)txnid;
+  (void)lag;
+  (void)bytes_used;
+  (void)bytes_retained;
+  fprintf(stderr, "the reader slot %d is left in use by pid %u\n", slot,
+          (unsigned)pid);
+  *(unsigned *)ctx += 1;
+  return MDBX_SUCCESS;
+}
+
+static void child(unsigned process) {
+  role = "child";
+  env = env_create();
+  int err = mdbx_env_set_maxreaders(env, processes * threads + 16);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_maxreaders", err);
+  env_open(env, pathname,
+           MDBX_RDONLY | MDBX_ACCEDE | (tls_mode ? 0 : MDBX_NOTLS));
+  if (snapshot_mode) {
+    err = mdbx_snapshot_acquire(env, &snapshot);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_snapshot_acquire", err);
+  }
+
+  signal(SIGALRM, on_alarm);
+  alarm(seconds);
+  pthread_t *const tids = calloc(threads, sizeof(pthread_t));
+  for (unsigned i = 0; i < threads; ++i)
+    if (pthread_create(&tids[i], NULL, worker,
+                       (void *)&counters[process * threads + i]))
+      failure("pthread_create", errno);
+  for (unsigned i = 0; i < threads; ++i)
+    pthread_join(tids[i], NULL);
+  free(tids);
+  if (snapshot_mode)
+    mdbx_snapshot_release(snapshot);
+  mdbx_env_close(env);
+  exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[]) {
+  int opt;
+  while ((opt = getopt(argc, argv, "cp:t:s:TS")) != -1) {
+    switch (opt) {
+    case 'c':
+      check_mode = true;
+      break;
+    case 'p':
+      processes = (unsigned)atoi(optarg);
+      break;
+    case 't':
+      threads = (unsigned)atoi(optarg);
+      break;
+    case 's':
+      seconds = (unsigned)atoi(optarg);
+      break;
+    case 'T':
+      tls_mode = true;
+      break;
+    case 'S':
+      snapshot_mode = true;
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [-c] [-p processes] [-t threads] [-s seconds] [-T] "
+              "[-S] dbpath\n",
+              argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (optind != argc - 1 || !processes || !threads || !seconds) {
+    fprintf(stderr, "invalid arguments, see the usage\n");
+    return EXIT_FAILURE;
+  }
+  pathname = argv[optind];
+
+  /* create the database if it does not exist */
+  env = env_create();
+  env_open(env, pathname, MDBX_LIFORECLAIM);
+  mdbx_env_close(env);
+  env = NULL;
+
+  const size_t bytes = sizeof(uint64_t) * processes * threads;
+  counters = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (counters == MAP_FAILED)
+    failure("mmap", errno);
+
+  struct timespec start, finish;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (unsigned i = 0; i < processes; ++i) {
+    const pid_t pid = fork();
+    if (pid < 0)
+      failure("fork", errno);
+    if (pid == 0)
+      child(i);
+  }
+  int status, rc = EXIT_SUCCESS;
+  while (wait(&status) > 0)
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+      rc = EXIT_FAILURE;
+  clock_gettime(CLOCK_MONOTONIC, &finish);
+
+  uint64_t total = 0;
+  for (unsigned i = 0; i < processes * threads; ++i) {
+    if (check_mode && counters[i] == 0) {
+      fprintf(stderr, "the thread %u of the process %u made no progress\n",
+              i % threads, i / threads);
+      rc = EXIT_FAILURE;
+    }
+    total += counters[i];
+  }
+  if (check_mode) {
+    env = env_create();
+    env_open(env, pathname, MDBX_RDONLY | MDBX_ACCEDE);
+    unsigned left = 0;
+    const int err = mdbx_reader_list(env, count_reader, &left);
+    if (err != MDBX_SUCCESS && err != MDBX_RESULT_TRUE)
+      failure("mdbx_reader_list", err);
+    if (left)
+      rc = EXIT_FAILURE;
+    mdbx_env_close(env);
+  }
+  const double elapsed = (double)(finish.tv_sec - start.tv_sec) +
+                         (finish.tv_nsec - start.tv_nsec) * 1e-9;
+  printf("%u process(es) x %u thread(s), %s: %.0f txn/s, %.1f ns/txn\n",
+         processes, threads,
+         snapshot_mode ? "snapshot"
+                       : (tls_mode ? "unregister" : "MDBX_NOTLS"),
+         total / elapsed, elapsed * 1e9 * processes * threads / total);
+  munmap((void *)counters, bytes);
+  return rc;
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Two-process check of the online growth of the readers table, see the
+ * MDBX_opt_readers_growth_limit. Both processes open the environment with
+ * the smallest MDBX_opt_max_readers, then by turns hold more read
+ * transactions than the current capacity, so each of them grows the table
+ * after adopting the growth made by the other. The capacity reported by
+ * mdbx_env_get_maxreaders() and the data read by each transaction are
+ * checked on the way.
+ *
+ * Usage: rslot_grow dbpath */
+
+#include "common.h"
+
+#include <sys/wait.h>
+
+#define GROWTH_LIMIT 4096
+#define MAX_TXNS GROWTH_LIMIT
+
+static const char *pathname;
+static MDBX_env *env;
+static MDBX_dbi dbi;
+static MDBX_txn *txns[MAX_TXNS];
+static unsigned ntxns;
+
+static void open_env(void) {
+  env = env_create();
+  int err = mdbx_env_set_maxreaders(env, 1);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_maxreaders", err);
+  env_open(env, pathname, MDBX_NOTLS);
+  err = mdbx_env_set_option(env, MDBX_opt_readers_growth_limit, GROWTH_LIMIT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_readers_growth_limit)", err);
+}
+
+static unsigned capacity(void) {
+  unsigned readers;
+  const int err = mdbx_env_get_maxreaders(env, &readers);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_get_maxreaders", err);
+  return readers;
+}
+
+/* Begins read transactions until the given number of ones is held by this
+ * process, each with the MDBX_NOTLS binds its own reader slot. */
+static void hold_readers(unsigned wanna) {
+  check(wanna <= MAX_TXNS, "too many readers");
+  for (; ntxns < wanna; ++ntxns) {
+    int err = mdbx_txn_begin(env, NULL, MDBX_TXN_RDONLY, &txns[ntxns]);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_txn_begin", err);
+    if (!dbi) {
+      err = mdbx_dbi_open(txns[ntxns], NULL, 0, &dbi);
+      if (err != MDBX_SUCCESS)
+        failure("mdbx_dbi_open", err);
+    }
+    MDBX_val key = {"key", 3}, data;
+    err = mdbx_get(txns[ntxns], dbi, &key, &data);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_get", err);
+    check(data.iov_len == 5 && memcmp(data.iov_base, "value", 5) == 0,
+          "the data read by a reader");
+  }
+}
+
+static void release_readers(void) {
+  while (ntxns > 0) {
+    const int err = mdbx_txn_abort(txns[--ntxns]);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_txn_abort", err);
+  }
+}
+
+static void send(int fd, unsigned value) {
+  if (write(fd, &value, sizeof(value)) != sizeof(value))
+    failure("write", errno);
+}
+
+static unsigned receive(int fd) {
+  unsigned value;
+  if (read(fd, &value, sizeof(value)) != sizeof(value))
+    failure("read", errno);
+  return value;
+}
+
+static void child(int rx, int tx) {
+  role = "child";
+  open_env();
+  const unsigned initial = capacity();
+  send(tx, initial);
+
+  /* the table was grown by the parent while we hold no readers */
+  const unsigned grown = receive(rx);
+  check(grown > initial, "the growth by the parent");
+  check(capacity() == grown, "the capacity reported after the growth");
+
+  /* adopt the growth by the parent and grow the table further */
+  hold_readers(grown - receive(rx) + 1);
+  const unsigned regrown = capacity();
+  check(regrown > grown, "the growth by the child");
+  send(tx, regrown);
+
+  /* wait until the parent adopts the growth */
+  check(receive(rx) == regrown, "the adoption by the parent");
+  release_readers();
+  mdbx_env_close(env);
+  exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s dbpath\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+  role = "parent";
+
+  db_remove(pathname);
+  open_env();
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+  int err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  MDBX_val key = {"key", 3}, data = {"value", 5};
+  err = mdbx_put(txn, dbi, &key, &data, MDBX_UPSERT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_put", err);
+  txn_commit(txn);
+  mdbx_env_close(env);
+  env = NULL;
+  dbi = 0;
+
+  int p2c[2], c2p[2];
+  if (pipe(p2c) || pipe(c2p))
+    failure("pipe", errno);
+  const pid_t pid = fork();
+  if (pid < 0)
+    failure("fork", errno);
+  if (pid == 0) {
+    close(p2c[1]);
+    close(c2p[0]);
+    child(p2c[0], c2p[1]);
+  }
+  /* so a failure of the peer is seen by read() as the end of file */
+  close(p2c[0]);
+  close(c2p[1]);
+
+  open_env();
+  const unsigned initial = capacity();
+  check(receive(c2p[0]) == initial, "the same initial capacity");
+
+  /* grow the table over the initial capacity */
+  hold_readers(initial + 1);
+  const unsigned grown = capacity();
+  check(grown > initial, "the growth by the parent");
+  send(p2c[1], grown);
+  send(p2c[1], ntxns);
+
+  /* adopt the growth by the child and use the slots beyond our one */
+  const unsigned regrown = receive(c2p[0]);
+  check(capacity() == regrown, "the capacity reported after the growth");
+  hold_readers(ntxns + regrown - grown - 1);
+  check(capacity() == regrown, "the adoption without excessive growth");
+  send(p2c[1], regrown);
+
+  int status;
+  if (waitpid(pid, &status, 0) != pid)
+    failure("waitpid", errno);
+  release_readers();
+  mdbx_env_close(env);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  printf("the readers table is grown from %u to %u slots\n", initial,
+         regrown);
+  return EXIT_SUCCESS;
+}
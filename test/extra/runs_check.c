@@ -0,0 +1,196 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Self-check of the index of runs of pages within the reclaimed list, i.e.
+ * of the MDBX_runs, against the scanning for a sequence of pages. The pages
+ * are cut off from the list both by multi-page allocations (found through
+ * the index) and one by one, so the index entries become stale and must be
+ * re-scanned by runs_find(), while GC records are merged back into the list
+ * and the index. Since the index is internal, the library sources are
+ * included here directly.
+ *
+ * Usage: runs_check [iterations] */
+
+#include "alloy.c"
+
+#define NPAGES 40000
+
+static uint64_t prng_state = UINT64_C(0x9E3779B97F4A7C15);
+static uint32_t prng(void) {
+  prng_state = prng_state * UINT64_C(6364136223846793005) +
+               UINT64_C(1442695040888963407);
+  return (uint32_t)(prng_state >> 32);
+}
+
+static pgno_t taken[NPAGES];
+static size_t taken_count, stale_rescans;
+
+static void failed(const char *what, size_t iteration) {
+  printf("check failed at the iteration %zu: %s\n", iteration, what);
+  exit(EXIT_FAILURE);
+}
+
+/* Checks the entries are ordered by the length within each bucket, and the
+ * length of each entry matches the bucket. */
+static bool index_ok(const MDBX_runs *runs) {
+  size_t count = 0;
+  for (size_t n = 0; n < MDBX_RUNS_BUCKETS; ++n) {
+    for (size_t i = 0; i < runs->buckets[n].length; ++i) {
+      const size_t npages = runs->buckets[n].items[i].npages;
+      if (runs_bucket(npages) != n ||
+          (i && runs->buckets[n].items[i - 1].npages > npages))
+        return false;
+    }
+    count += runs->buckets[n].length;
+  }
+  return count == runs->count;
+}
+
+/* Checks whether the entry which runs_find() tries first is stale. */
+static bool candidate_stale(const MDBX_runs *runs, const MDBX_PNL pnl,
+                            size_t num) {
+  size_t n = runs_bucket(num), i = runs_lower_bound(runs, n, num);
+  if (i == runs->buckets[n].length) {
+    do {
+      if (++n == MDBX_RUNS_BUCKETS)
+        return false;
+    } while (!runs->buckets[n].length);
+    i = 0;
+  }
+  return !runs_check(pnl, runs->buckets[n].items[i].pgno, num);
+}
+
+/* Cuts the found pages off from the relist like page_alloc_slowpath(). */
+static void cutoff(MDBX_txn *txn, const pgno_t *range, size_t num) {
+  const MDBX_PNL pnl = txn->tw.relist;
+  const size_t len = MDBX_PNL_GETSIZE(pnl);
+  const size_t first = MDBX_PNL_ASCENDING ? (size_t)(range - pnl)
+                                           : (size_t)(range - pnl) + 1 - num;
+  for (size_t i = 0; i < num; ++i)
+    taken[taken_count++] = pnl[first + i];
+  memmove(pnl + first, pnl + first + num,
+          (len + 1 - first - num) * sizeof(pgno_t));
+  runs_cutoff(txn, len, len - num);
+  MDBX_PNL_SETSIZE(pnl, len - num);
+}
+
+/* Takes a single page like page_alloc_finalize() does for the relist, so a
+ * run could be split and the index entry for it becomes stale. */
+static void take_single(MDBX_txn *txn) {
+  const MDBX_PNL pnl = txn->tw.relist;
+  const size_t len = MDBX_PNL_GETSIZE(pnl);
+  if (len) {
+    const size_t i = 1 + prng() % len;
+    taken[taken_count++] = pnl[i];
+    memmove(pnl + i, pnl + i + 1, (len - i) * sizeof(pgno_t));
+    MDBX_PNL_SETSIZE(pnl, len - 1);
+    runs_cutoff(txn, len, len - 1);
+  }
+}
+
+/* Returns a part of taken pages back like a GC record being reclaimed. */
+static void merge_gc(MDBX_txn *txn) {
+  const size_t n = taken_count < 512 ? taken_count : 512;
+  if (!n)
+    return;
+  MDBX_PNL gc = pnl_alloc(n);
+  /* the tail of taken pages is the latest allocated, i.e. dense enough for
+   * the merging by runs sometimes */
+  for (size_t i = 1; i <= n; ++i)
+    gc[i] = taken[--taken_count];
+  MDBX_PNL_SETSIZE(gc, n);
+  pnl_sort(gc, MAX_PAGENO + 1);
+  if (pnl_need(&txn->tw.relist, n) != MDBX_SUCCESS)
+    failed("pnl_need", 0);
+  const bool coherent =
+      txn->tw.relist_runs->coherent == MDBX_PNL_GETSIZE(txn->tw.relist);
+  pnl_merge(txn->tw.relist, gc);
+  if (coherent)
+    runs_merged(txn, gc);
+  else
+    runs_build(txn);
+  pnl_free(gc);
+}
+
+int main(int argc, char *argv[]) {
+  const size_t iterations =
+      (argc > 1) ? strtoul(argv[1], nullptr, 0) : 200000;
+
+  MDBX_txn txn;
+  memset(&txn, 0, sizeof(txn));
+  txn.tw.relist = pnl_alloc(NPAGES);
+  pgno_t pgno = NUM_METAS;
+  size_t len = 0;
+  while (len < NPAGES / 2) {
+    /* mostly short runs with a few long ones (up to 256 pages), separated by
+     * gaps which are never free */
+    const size_t run = (prng() % 8) ? 1 + prng() % 8 : 1 + prng() % 256;
+    for (size_t i = 0; i < run && len < NPAGES / 2; ++i)
+      txn.tw.relist[++len] = pgno++;
+    pgno += 1 + prng() % 3;
+  }
+  MDBX_PNL_SETSIZE(txn.tw.relist, len);
+  pnl_sort(txn.tw.relist, MAX_PAGENO + 1);
+  runs_build(&txn);
+  if (!txn.tw.relist_runs || !index_ok(txn.tw.relist_runs))
+    failed("the index is built", 0);
+
+  size_t found = 0, missed = 0;
+  for (size_t i = 0; i < iterations; ++i) {
+    MDBX_runs *const runs = txn.tw.relist_runs;
+    const uint32_t op = prng() % 16;
+    if (op < 6) {
+      take_single(&txn);
+      continue;
+    }
+    if (op == 6 || taken_count + 256 > NPAGES) {
+      merge_gc(&txn);
+      if (runs->coherent != MDBX_PNL_GETSIZE(txn.tw.relist) ||
+          !index_ok(runs))
+        failed("the index after the merge", i);
+      continue;
+    }
+
+    if (runs->coherent != MDBX_PNL_GETSIZE(txn.tw.relist))
+      failed("the index is coherent", i);
+    /* the runs are not longer than 256 pages, so some lookups must fail */
+    const size_t num = (op == 7) ? 200 + prng() % 100
+                                 : 2 + prng() % ((prng() % 4) ? 8 : 128);
+    const pgno_t *const expected = scan4range_checker(txn.tw.relist, num - 1);
+    stale_rescans += candidate_stale(runs, txn.tw.relist, num);
+    pgno_t *const range = runs_find(runs, txn.tw.relist, num);
+    if (i % 64 == 0 && !index_ok(runs))
+      failed("the index after the lookup", i);
+    if (!expected != !range)
+      failed(range ? "a missing sequence is found"
+                   : "an existing sequence is not found",
+             i);
+    if (!range) {
+      missed += 1;
+      continue;
+    }
+    if (range != runs_check(txn.tw.relist, *range, num))
+      failed("the found sequence is free", i);
+    found += 1;
+    cutoff(&txn, range, num);
+  }
+
+  printf("%zu sequence(s) found, %zu missed, %zu stale rescan(s)\n", found,
+         missed, stale_rescans);
+  if (!found || !missed || !stale_rescans)
+    failed("all the cases are covered", iterations);
+  runs_free(txn.tw.relist_runs);
+  pnl_free(txn.tw.relist);
+  return EXIT_SUCCESS;
+}
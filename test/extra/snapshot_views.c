@@ -0,0 +1,201 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of the lifetime of shared snapshots, i.e. of the transactions started
+ * by mdbx_txn_begin_snapshot(), called the views here. A snapshot is released
+ * while its views are still in use, then all records are updated many times
+ * by a writer, so the pages would be reused if the snapshot was not retained.
+ * The views must still see the initial records, and the reader slot of the
+ * snapshot must be held until the last view is finished. A view which is
+ * reset and renewed must become a regular read-only transaction, without
+ * holding the snapshot. Finally, the database is checked by mdbx_chk.
+ *
+ * Usage: snapshot_views dbpath mdbx_chk-pathname */
+
+#include "common.h"
+
+#include <pthread.h>
+
+#define NKEYS 2000
+#define NCOMMITS 16
+
+static MDBX_env *env;
+static MDBX_dbi dbi;
+static uint32_t generation;
+
+static void verify(MDBX_txn *txn, uint32_t gen) {
+  for (uint32_t n = 0; n < NKEYS; ++n) {
+    MDBX_val key = {&n, sizeof(n)}, data;
+    const int err = mdbx_get(txn, dbi, &key, &data);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_get", err);
+    const uint32_t *const value = data.iov_base;
+    check(data.iov_len == 16 * sizeof(uint32_t) && value[0] == n &&
+              value[1] == gen,
+          "the value of a record");
+  }
+}
+
+/* Updates all records by a few commits, i.e. all pages of the previous
+ * versions are retired and then could be reused. Since the views could not
+ * be used by a thread which runs a write transaction, the writing is done
+ * by a separate thread. */
+static void *writer(void *arg) {
+  (void)arg;
+  for (size_t i = 0; i < NCOMMITS; ++i) {
+    MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+    generation += 1;
+    for (uint32_t n = 0; n < NKEYS; ++n) {
+      const uint32_t value[16] = {n, generation};
+      MDBX_val key = {&n, sizeof(n)},
+               data = {(void *)value, sizeof(value)};
+      const int err = mdbx_put(txn, dbi, &key, &data, MDBX_UPSERT);
+      if (err != MDBX_SUCCESS)
+        failure("mdbx_put", err);
+    }
+    txn_commit(txn);
+  }
+  return NULL;
+}
+
+static void write_by_thread(void) {
+  pthread_t thread;
+  const int err = pthread_create(&thread, NULL, writer, NULL);
+  if (err)
+    failure("pthread_create", err);
+  pthread_join(thread, NULL);
+}
+
+static int count_slot(void *ctx, int num, int slot, mdbx_pid_t pid,
+                      mdbx_tid_t thread, uint64_t txnid, uint64_t lag,
+                      size_t bytes_used, size_t bytes_retained) {
+  (void)num, (void)slot, (void)pid, (void)thread, (void)lag;
+  (void)bytes_used, (void)bytes_retained;
+  uint64_t *const arg = ctx;
+  arg[1] += txnid == arg[0];
+  return MDBX_SUCCESS;
+}
+
+/* Returns the count of reader slots which hold the given txnid. */
+static size_t slots_of(uint64_t txnid) {
+  uint64_t arg[2] = {txnid, 0};
+  const int err = mdbx_reader_list(env, count_slot, arg);
+  if (err != MDBX_SUCCESS && err != MDBX_RESULT_TRUE)
+    failure("mdbx_reader_list", err);
+  return (size_t)arg[1];
+}
+
+static MDBX_txn *view_begin(MDBX_snapshot *snapshot) {
+  MDBX_txn *txn;
+  const int err = mdbx_txn_begin_snapshot(snapshot, &txn, NULL);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_begin_snapshot", err);
+  return txn;
+}
+
+static void view_renew(MDBX_txn *txn) {
+  int err = mdbx_txn_reset(txn);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_reset", err);
+  err = mdbx_txn_renew(txn);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_renew", err);
+}
+
+static void snapshot_release(MDBX_snapshot *snapshot) {
+  const int err = mdbx_snapshot_release(snapshot);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_snapshot_release", err);
+}
+
+static void abort_txn(MDBX_txn *txn) {
+  const int err = mdbx_txn_abort(txn);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_abort", err);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s dbpath mdbx_chk-pathname\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  const char *const pathname = argv[1];
+
+  db_remove(pathname);
+  env = env_create();
+  int err = mdbx_env_set_geometry(env, 0, -1, 1 << 30, 1 << 20, 1 << 20, 4096);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  env_open(env, pathname, MDBX_ENV_DEFAULTS);
+  MDBX_txn *txn = txn_begin(env, MDBX_TXN_READWRITE);
+  err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  mdbx_txn_abort(txn);
+  write_by_thread();
+
+  /* the snapshot is released while its views are in use */
+  MDBX_snapshot *snapshot;
+  err = mdbx_snapshot_acquire(env, &snapshot);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_snapshot_acquire", err);
+  const uint32_t initial = generation;
+  MDBX_txn *const first = view_begin(snapshot), *second = view_begin(snapshot);
+  const uint64_t txnid = mdbx_txn_id(first);
+  check(txnid == mdbx_txn_id(second) && slots_of(txnid) == 1,
+        "the views share the slot of the snapshot");
+  write_by_thread();
+  snapshot_release(snapshot);
+  write_by_thread();
+
+  MDBX_txn_info info;
+  err = mdbx_txn_info(second, &info, false);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_info", err);
+  check(info.txn_reader_lag == 2 * NCOMMITS, "the lag of a view");
+  verify(first, initial);
+  verify(second, initial);
+  check(slots_of(txnid) == 1, "the released snapshot is retained by views");
+
+  /* the renewed view is detached from the snapshot */
+  view_renew(first);
+  check(mdbx_txn_id(first) > txnid, "the renewed view is not the snapshot");
+  verify(first, generation);
+  verify(second, initial);
+  check(slots_of(txnid) == 1, "the snapshot is retained by the last view");
+  abort_txn(second);
+  check(slots_of(txnid) == 0, "the snapshot is finished with the last view");
+  const uint32_t renewed = generation;
+  write_by_thread();
+  verify(first, renewed);
+  abort_txn(first);
+
+  /* the snapshot is still usable after one of its views is renewed */
+  err = mdbx_snapshot_acquire(env, &snapshot);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_snapshot_acquire", err);
+  txn = view_begin(snapshot);
+  view_renew(txn);
+  second = view_begin(snapshot);
+  snapshot_release(snapshot);
+  write_by_thread();
+  verify(second, renewed + NCOMMITS);
+  verify(txn, renewed + NCOMMITS);
+  abort_txn(second);
+  abort_txn(txn);
+
+  mdbx_env_close(env);
+  db_check(argv[2], pathname);
+  return EXIT_SUCCESS;
+}
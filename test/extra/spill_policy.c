@@ -0,0 +1,189 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of the policies of spilling, i.e. of the MDBX_opt_spill_policy, and
+ * of the per-txn counters of spilled and reloaded pages provided by
+ * mdbx_txn_commit_info(). A huge transaction appends records into a table,
+ * while updating random records of a working set in another table, and
+ * partially within nested transactions. Under the MDBX_SPILL_ADAPTIVE policy
+ * the working set must be reloaded less than under the MDBX_SPILL_LRU, while
+ * the counters of committed nested transactions must be accounted by the
+ * parent. The data is checked against the model after each transaction, and
+ * the database by mdbx_chk at the end.
+ *
+ * Usage: spill_policy dbpath mdbx_chk-pathname */
+
+#include "common.h"
+
+/* the working set is about 150 pages, i.e. well below a half of the dirty
+ * pages limit, so it could be kept by the adaptive policy */
+#define NHOT 4000
+#define NAPPENDS 100000
+#define DP_LIMIT 1024
+
+static const char *pathname;
+static MDBX_env *env;
+static MDBX_dbi hot, journal;
+static uint32_t model[NHOT], nested_model[NHOT];
+static uint32_t appended;
+static uint64_t prng_state = UINT64_C(0x9E3779B97F4A7C15);
+
+static uint32_t prng(void) {
+  prng_state = prng_state * UINT64_C(6364136223846793005) +
+               UINT64_C(1442695040888963407);
+  return (uint32_t)(prng_state >> 33);
+}
+
+static void put(MDBX_txn *txn, MDBX_dbi dbi, uint32_t n, uint32_t gen) {
+  /* the big-endian keys, so the appends go to the last page */
+  const uint32_t be = __builtin_bswap32(n), value[24] = {n, gen};
+  MDBX_val key = {(void *)&be, sizeof(be)},
+           data = {(void *)value, sizeof(value)};
+  const int err = mdbx_put(txn, dbi, &key, &data, MDBX_UPSERT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_put", err);
+}
+
+static void verify(MDBX_txn *txn, const uint32_t *gens) {
+  for (uint32_t n = 0; n < NHOT; ++n) {
+    const uint32_t be = __builtin_bswap32(n);
+    MDBX_val key = {(void *)&be, sizeof(be)}, data;
+    const int err = mdbx_get(txn, hot, &key, &data);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_get", err);
+    const uint32_t *const value = data.iov_base;
+    check(value[0] == n && value[1] == gens[n], "the value of a record");
+  }
+  MDBX_stat stat;
+  const int err = mdbx_dbi_stat(txn, journal, &stat, sizeof(stat));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_stat", err);
+  check(stat.ms_entries == appended, "the count of appended records");
+}
+
+/* Appends records, while updating the working set once per a few ones. */
+static void work(MDBX_txn *txn, uint32_t *gens, size_t appends) {
+  for (size_t i = 0; i < appends; ++i) {
+    put(txn, journal, appended, 0);
+    appended += 1;
+    if (i % 4 == 0) {
+      const uint32_t n = prng() % NHOT;
+      put(txn, hot, n, ++gens[n]);
+    }
+  }
+}
+
+static MDBX_commit_info commit(MDBX_txn *txn) {
+  MDBX_commit_info info;
+  const int err = mdbx_txn_commit_info(txn, NULL, &info, sizeof(info));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_commit_info", err);
+  return info;
+}
+
+static MDBX_commit_info run(MDBX_spill_policy_t policy) {
+  int err = mdbx_env_set_option(env, MDBX_opt_spill_policy, policy);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_spill_policy)", err);
+
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+  work(txn, model, NAPPENDS);
+
+  /* the nested transactions, which spill and reload pages by themselves */
+  uint32_t nested_spill = 0;
+  for (unsigned i = 0; i < 4; ++i) {
+    MDBX_txn *nested;
+    err = mdbx_txn_begin(env, txn, MDBX_TXN_READWRITE, &nested);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_txn_begin(nested)", err);
+    memcpy(nested_model, model, sizeof(model));
+    const uint32_t before = appended;
+    work(nested, nested_model, NAPPENDS / 16);
+    verify(nested, nested_model);
+    if (i % 2) {
+      err = mdbx_txn_abort(nested);
+      if (err != MDBX_SUCCESS)
+        failure("mdbx_txn_abort", err);
+      appended = before;
+    } else {
+      nested_spill += commit(nested).spill_pages;
+      memcpy(model, nested_model, sizeof(model));
+    }
+    verify(txn, model);
+  }
+
+  /* a wrong size is rejected, while the transaction remains untouched */
+  MDBX_commit_info info;
+  err = mdbx_txn_commit_info(txn, NULL, &info, sizeof(info) + 1);
+  check(err == MDBX_EINVAL, "a wrong size of MDBX_commit_info");
+  verify(txn, model);
+
+  info = commit(txn);
+  printf("%s: %u page(s) spilled, %u reloaded, %u spilled by nested\n",
+         (policy == MDBX_SPILL_LRU) ? "lru" : "adaptive", info.spill_pages,
+         info.unspill_pages, nested_spill);
+  check(info.spill_pages > 0 && info.unspill_pages > 0,
+        "the pages are spilled and reloaded");
+  check(nested_spill > 0 && info.spill_pages >= nested_spill,
+        "the nested spilling is accounted by the parent");
+
+  MDBX_txn *const reader = txn_begin(env, MDBX_TXN_RDONLY);
+  verify(reader, model);
+  mdbx_txn_abort(reader);
+  return info;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s dbpath mdbx_chk-pathname\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+
+  db_remove(pathname);
+  env = env_create();
+  int err = mdbx_env_set_maxdbs(env, 4);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_maxdbs", err);
+  err = mdbx_env_set_geometry(env, 0, -1, 1 << 30, 1 << 20, 1 << 20, 4096);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  env_open(env, pathname, MDBX_ENV_DEFAULTS);
+  err = mdbx_env_set_option(env, MDBX_opt_txn_dp_limit, DP_LIMIT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_txn_dp_limit)", err);
+  err = mdbx_env_set_option(env, MDBX_opt_spill_policy,
+                            MDBX_SPILL_ADAPTIVE + 1);
+  check(err == MDBX_EINVAL, "an unknown spill policy");
+
+  MDBX_txn *txn = txn_begin(env, MDBX_TXN_READWRITE);
+  err = mdbx_dbi_open(txn, "hot", MDBX_CREATE, &hot);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  err = mdbx_dbi_open(txn, "log", MDBX_CREATE, &journal);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  for (uint32_t n = 0; n < NHOT; ++n)
+    put(txn, hot, n, ++model[n]);
+  txn_commit(txn);
+
+  const MDBX_commit_info lru = run(MDBX_SPILL_LRU);
+  const MDBX_commit_info adaptive = run(MDBX_SPILL_ADAPTIVE);
+  check(adaptive.unspill_pages < lru.unspill_pages,
+        "the working set is reloaded less by the adaptive policy");
+
+  mdbx_env_close(env);
+  db_check(argv[2], pathname);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of the spilling by a small MDBX_opt_txn_dp_limit, including the
+ * writing of spilled pages by an auxiliary thread if MDBX_ENABLE_ASYNC_SPILL
+ * is enabled. Each write transaction updates random records (some of which
+ * have large values) so pages are spilled, then reads the updated records
+ * back, i.e. the spilled pages are read from the map, and updates ones again,
+ * i.e. the spilled pages are reloaded, partially within nested transactions.
+ * A half of transactions is aborted. The data is checked against the model
+ * after each step, and the database by mdbx_chk at the end.
+ *
+ * Usage: spill_retouch dbpath mdbx_chk-pathname */
+
+#include "common.h"
+
+#define NKEYS 20000
+#define NTXNS 40
+#define NUPDATES 3000
+#define DP_LIMIT 512
+#define LARGE_WORDS 3000
+
+static const char *pathname;
+static MDBX_env *env;
+static MDBX_dbi dbi;
+static uint32_t model[3][NKEYS] /* a generation per record and per level */;
+static uint32_t touched[NUPDATES];
+static uint32_t value[LARGE_WORDS];
+static size_t spilled, reloaded;
+static uint64_t prng_state = UINT64_C(0x9E3779B97F4A7C15);
+
+static uint32_t prng(void) {
+  prng_state = prng_state * UINT64_C(6364136223846793005) +
+               UINT64_C(1442695040888963407);
+  return (uint32_t)(prng_state >> 33);
+}
+
+static size_t value_words(uint32_t n) { return (n % 100) ? 8 : LARGE_WORDS; }
+
+static void fill_value(uint32_t n, uint32_t gen, size_t words) {
+  for (size_t i = 0; i < words; ++i)
+    value[i] = n * 31 + gen * 7 + (uint32_t)i;
+}
+
+static void put(MDBX_txn *txn, uint32_t *gens, uint32_t n) {
+  const size_t words = value_words(n);
+  fill_value(n, ++gens[n], words);
+  MDBX_val key = {&n, sizeof(n)}, data = {value, words * sizeof(uint32_t)};
+  const int err = mdbx_put(txn, dbi, &key, &data, MDBX_UPSERT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_put", err);
+}
+
+static void get(MDBX_txn *txn, const uint32_t *gens, uint32_t n) {
+  MDBX_val key = {&n, sizeof(n)}, data;
+  const int err = mdbx_get(txn, dbi, &key, &data);
+  if (!gens[n]) {
+    check(err == MDBX_NOTFOUND, "an absent record");
+    return;
+  }
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_get", err);
+  const size_t words = value_words(n);
+  fill_value(n, gens[n], words);
+  check(data.iov_len == words * sizeof(uint32_t) &&
+            memcmp(data.iov_base, value, data.iov_len) == 0,
+        "the value of a record");
+}
+
+static void verify(MDBX_txn *txn, const uint32_t *gens) {
+  for (uint32_t n = 0; n < NKEYS; ++n)
+    get(txn, gens, n);
+}
+
+/* Updates random records, reads ones back and updates again. */
+static void update(MDBX_txn *txn, uint32_t *gens) {
+  for (size_t i = 0; i < NUPDATES; ++i)
+    put(txn, gens, touched[i] = prng() % NKEYS);
+  for (size_t i = 0; i < NUPDATES; ++i)
+    get(txn, gens, touched[i]);
+  for (size_t i = 0; i < NUPDATES; i += 1 + prng() % 4)
+    put(txn, gens, touched[i]);
+}
+
+static void commit(MDBX_txn *txn) {
+  MDBX_commit_info info;
+  const int err = mdbx_txn_commit_info(txn, NULL, &info, sizeof(info));
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_commit_info", err);
+  spilled += info.spill_pages;
+  reloaded += info.unspill_pages;
+}
+
+static void abort_txn(MDBX_txn *txn) {
+  const int err = mdbx_txn_abort(txn);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_txn_abort", err);
+}
+
+static void run(void) {
+  env = env_create();
+  int err = mdbx_env_set_geometry(env, 0, -1, 1 << 30, 1 << 20, 1 << 20, 4096);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_geometry", err);
+  env_open(env, pathname, MDBX_ENV_DEFAULTS);
+  err = mdbx_env_set_option(env, MDBX_opt_txn_dp_limit, DP_LIMIT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_txn_dp_limit)", err);
+  /* spill a half of the parent's dirty pages to make room for the nested */
+  err = mdbx_env_set_option(env, MDBX_opt_spill_parent4child_denominator, 2);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_spill_parent4child_denominator)",
+            err);
+
+  spilled = reloaded = 0;
+  for (unsigned i = 0; i < NTXNS; ++i) {
+    MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+    err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+    if (err != MDBX_SUCCESS)
+      failure("mdbx_dbi_open", err);
+    memcpy(model[1], model[0], sizeof(model[1]));
+    update(txn, model[1]);
+
+    if (i % 3 == 0) {
+      MDBX_txn *nested;
+      err = mdbx_txn_begin(env, txn, MDBX_TXN_READWRITE, &nested);
+      if (err != MDBX_SUCCESS)
+        failure("mdbx_txn_begin(nested)", err);
+      memcpy(model[2], model[1], sizeof(model[2]));
+      update(nested, model[2]);
+      verify(nested, model[2]);
+      if (prng() % 2)
+        abort_txn(nested);
+      else {
+        commit(nested);
+        memcpy(model[1], model[2], sizeof(model[1]));
+      }
+    }
+    verify(txn, model[1]);
+
+    if (i % 2)
+      abort_txn(txn);
+    else {
+      commit(txn);
+      memcpy(model[0], model[1], sizeof(model[0]));
+    }
+    MDBX_txn *const reader = txn_begin(env, MDBX_TXN_RDONLY);
+    verify(reader, model[0]);
+    mdbx_txn_abort(reader);
+  }
+  mdbx_env_close(env);
+
+  printf("%zu page(s) spilled, %zu reloaded by committed txns\n", spilled,
+         reloaded);
+  check(spilled > 0 && reloaded > 0, "the pages are spilled and reloaded");
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s dbpath mdbx_chk-pathname\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+  printf("the writing of spilled pages is %s\n",
+         strstr(mdbx_build.options, "MDBX_ENABLE_ASYNC_SPILL=1")
+             ? "asynchronous"
+             : "synchronous");
+
+  db_remove(pathname);
+  run();
+  db_check(argv[2], pathname);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of waiting for commits by mdbx_env_wait_txnid(), while the commits
+ * are made by a child process. The waiting must return at once if the txnid
+ * is already reached, must be expired by the timeout if there are no
+ * commits, must be woken up by a commit of the child well before the
+ * timeout, and must not be woken up by the closing of the environment by
+ * the child, but by a commit after the child reopens it. Each command is
+ * performed by the child after a delay, i.e. while the parent is waiting.
+ *
+ * Usage: wait_txnid dbpath */
+
+#include "common.h"
+
+#include <inttypes.h>
+#include <sys/wait.h>
+#include <time.h>
+
+#define DELAY_MS 200
+
+static const char *pathname;
+static MDBX_env *env;
+static int cmd_pipe[2], ack_pipe[2];
+
+static void open_db(void) {
+  env = env_create();
+  env_open(env, pathname, MDBX_ENV_DEFAULTS);
+}
+
+static uint64_t recent_txnid(void) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_RDONLY);
+  const uint64_t txnid = mdbx_txn_id(txn);
+  mdbx_txn_abort(txn);
+  return txnid;
+}
+
+static void commit_once(void) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+  MDBX_dbi dbi;
+  int err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  uint64_t txnid = mdbx_txn_id(txn);
+  MDBX_val key = {&txnid, sizeof(txnid)};
+  err = mdbx_put(txn, dbi, &key, &key, MDBX_UPSERT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_put", err);
+  txn_commit(txn);
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Performs the commands of the parent until the pipe is closed:
+ *  'C' commit, 'D' close the environment, 'O' reopen ones. */
+static void writer_loop(void) {
+  role = "writer";
+  open_db();
+  char cmd;
+  while (read(cmd_pipe[0], &cmd, 1) == 1) {
+    usleep(DELAY_MS * 1000);
+    if (cmd == 'C')
+      commit_once();
+    else if (cmd == 'D')
+      mdbx_env_close(env), env = NULL;
+    else if (cmd == 'O')
+      open_db();
+    else
+      failure("unknown command", MDBX_EINVAL);
+    if (write(ack_pipe[1], &cmd, 1) != 1)
+      failure("write", errno);
+  }
+  if (env)
+    mdbx_env_close(env);
+  _exit(EXIT_SUCCESS);
+}
+
+static void writer_cmd(char cmd) {
+  if (write(cmd_pipe[1], &cmd, 1) != 1)
+    failure("write", errno);
+}
+
+static void writer_ack(void) {
+  char ack;
+  if (read(ack_pipe[0], &ack, 1) != 1)
+    failure("read", errno);
+}
+
+/* Waits for the txnid with the timeout in milliseconds, returns the result
+ * and the elapsed time in milliseconds. */
+static int wait_txnid(uint64_t txnid, unsigned timeout_ms, double *elapsed) {
+  const double start = now();
+  const int rc = mdbx_env_wait_txnid(env, txnid, timeout_ms * 65536u / 1000);
+  *elapsed = (now() - start) * 1e3;
+  printf("wait for %" PRIu64 " by %u ms: %s in %.1f ms\n", txnid, timeout_ms,
+         (rc == MDBX_SUCCESS)       ? "reached"
+         : (rc == MDBX_RESULT_TRUE) ? "expired"
+                                    : mdbx_strerror(rc),
+         *elapsed);
+  return rc;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s dbpath\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+  db_remove(pathname);
+
+  if (pipe(cmd_pipe) || pipe(ack_pipe))
+    failure("pipe", errno);
+  fflush(NULL);
+  const pid_t child = fork();
+  if (child < 0)
+    failure("fork", errno);
+  if (child == 0) {
+    close(cmd_pipe[1]), close(ack_pipe[0]);
+    writer_loop();
+  }
+  close(cmd_pipe[0]), close(ack_pipe[1]);
+  open_db();
+  commit_once();
+
+  /* the already reached txnid, as well as an older one */
+  double elapsed;
+  const uint64_t txnid = recent_txnid();
+  check(wait_txnid(txnid, 0, &elapsed) == MDBX_SUCCESS &&
+            wait_txnid(txnid - 1, 0, &elapsed) == MDBX_SUCCESS,
+        "the waiting for a reached txnid");
+  check(mdbx_env_wait_txnid(env, UINT64_MAX, 0) == MDBX_EINVAL,
+        "the waiting for an invalid txnid");
+  MDBX_txn *txn = txn_begin(env, MDBX_TXN_READWRITE);
+  check(mdbx_env_wait_txnid(env, txnid + 1, 0) == MDBX_BUSY,
+        "the waiting within a write transaction");
+  mdbx_txn_abort(txn);
+
+  /* no commits */
+  check(wait_txnid(txnid + 1, DELAY_MS, &elapsed) == MDBX_RESULT_TRUE &&
+            elapsed >= DELAY_MS * 0.9,
+        "the waiting is expired by the timeout");
+
+  /* woken up by the commit of the child */
+  writer_cmd('C');
+  check(wait_txnid(txnid + 1, 50 * DELAY_MS, &elapsed) == MDBX_SUCCESS &&
+            elapsed < 25 * DELAY_MS,
+        "the waiting is woken up by a commit");
+  writer_ack();
+  check(recent_txnid() == txnid + 1, "the awaited txnid is committed");
+
+  /* not woken up by the closing of the environment by the child */
+  writer_cmd('D');
+  check(wait_txnid(txnid + 2, 3 * DELAY_MS, &elapsed) == MDBX_RESULT_TRUE,
+        "the waiting is not woken up by the closing");
+  writer_ack();
+
+  /* but by a commit after the child reopens the environment */
+  writer_cmd('O');
+  writer_cmd('C');
+  check(wait_txnid(txnid + 2, 50 * DELAY_MS, &elapsed) == MDBX_SUCCESS &&
+            elapsed < 25 * DELAY_MS,
+        "the waiting is woken up by a commit after the reopening");
+  writer_ack();
+  writer_ack();
+
+  close(cmd_pipe[1]), close(ack_pipe[0]);
+  int status;
+  if (waitpid(child, &status, 0) != child)
+    failure("waitpid", errno);
+  check(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS,
+        "the child writer");
+  mdbx_env_close(env);
+  return EXIT_SUCCESS;
+}
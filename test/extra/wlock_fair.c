@@ -0,0 +1,276 @@
+/*
+ * Copyright 2022 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Check of the timed and fair acquiring of the write lock by a few processes,
+ * i.e. of the mdbx_txn_begin_timed() and the MDBX_opt_writer_fairness. While
+ * the parent holds a write transaction, the child writers are queued one by
+ * one and append their numbers to a record, so the order of acquiring the
+ * lock is seen by the parent after it commits. The waiting must be expired
+ * by the deadline, the queued writers must be served in the FIFO order even
+ * if each one immediately requests the lock again, the ticket given up by an
+ * expired writer must be skipped, and the ticket of a writer killed while
+ * waiting must not stall the ones queued after it. Finally, the database is
+ * checked by mdbx_chk.
+ *
+ * Usage: wlock_fair dbpath mdbx_chk-pathname */
+
+#include "common.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <time.h>
+
+#define NCHILDREN 4
+#define DELAY_MS 100
+#define TIMEOUT_MS 300
+#define ROUNDS 4
+/* the patience of waiters before taking a stalled turn out of order */
+#define STALL_MS (1000 / 16)
+
+static const char *pathname;
+static MDBX_env *env;
+static MDBX_dbi dbi;
+static pid_t pids[NCHILDREN];
+static int cmd_pipes[NCHILDREN][2], ack_pipes[NCHILDREN][2];
+
+static void open_db(void) {
+  env = env_create();
+  /* the commits without fsync, so the latency of a turn is a few
+   * microseconds rather than of the disk */
+  env_open(env, pathname, MDBX_SAFE_NOSYNC);
+  const int err = mdbx_env_set_option(env, MDBX_opt_writer_fairness, 1);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_env_set_option(MDBX_opt_writer_fairness)", err);
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static MDBX_txn *write_begin(void) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_READWRITE);
+  const int err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  return txn;
+}
+
+/* Puts the order of acquiring the lock, i.e. the numbers of writers. */
+static void put_order(MDBX_txn *txn, const char *order, size_t length) {
+  MDBX_val key = {"order", 5}, data = {(void *)order, length};
+  const int err = mdbx_put(txn, dbi, &key, &data, MDBX_UPSERT);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_put", err);
+}
+
+static size_t get_order(MDBX_txn *txn, char *order, size_t limit) {
+  MDBX_val key = {"order", 5}, data;
+  const int err = mdbx_get(txn, dbi, &key, &data);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_get", err);
+  check(data.iov_len < limit, "the length of the order");
+  memcpy(order, data.iov_base, data.iov_len);
+  order[data.iov_len] = '\0';
+  return data.iov_len;
+}
+
+static void append(char number) {
+  MDBX_txn *const txn = write_begin();
+  char order[64];
+  const size_t length = get_order(txn, order, sizeof(order) - 1);
+  order[length] = number;
+  put_order(txn, order, length + 1);
+  txn_commit(txn);
+}
+
+/* Performs the commands of the parent until the pipe is closed:
+ *  'T' expect the expiry of the timed waiting for the write lock,
+ *  'A' append the own number to the order,
+ *  'R' append the own number ROUNDS times, by successive transactions. */
+static void writer_loop(int n) {
+  role = "writer";
+  open_db();
+  char cmd;
+  while (read(cmd_pipes[n][0], &cmd, 1) == 1) {
+    char ack = cmd;
+    if (cmd == 'T') {
+      MDBX_txn *txn = NULL;
+      const double start = now();
+      const int err =
+          mdbx_txn_begin_timed(env, NULL, MDBX_TXN_READWRITE, &txn,
+                               TIMEOUT_MS * 65536u / 1000, NULL);
+      const double elapsed = (now() - start) * 1e3;
+      printf("writer %d: the timed waiting is %s in %.1f ms\n", n,
+             (err == MDBX_BUSY) ? "expired" : mdbx_strerror(err), elapsed);
+      if (err != MDBX_BUSY || elapsed < TIMEOUT_MS * 0.9)
+        ack = 'F';
+      if (txn)
+        mdbx_txn_abort(txn);
+    } else if (cmd == 'A')
+      append('0' + (char)n);
+    else if (cmd == 'R') {
+      for (int i = 0; i < ROUNDS; ++i)
+        append('0' + (char)n);
+    } else
+      failure("unknown command", MDBX_EINVAL);
+    fflush(NULL);
+    if (write(ack_pipes[n][1], &ack, 1) != 1)
+      failure("write", errno);
+  }
+  mdbx_env_close(env);
+  _exit(EXIT_SUCCESS);
+}
+
+/* Sends the command to the child and pauses, so the child is queued for the
+ * write lock in turn, i.e. before the next one. */
+static void writer_cmd(int n, char cmd) {
+  if (write(cmd_pipes[n][1], &cmd, 1) != 1)
+    failure("write", errno);
+  usleep(DELAY_MS * 1000);
+}
+
+static void writer_ack(int n, char expected) {
+  char ack;
+  if (read(ack_pipes[n][0], &ack, 1) != 1)
+    failure("read", errno);
+  check(ack == expected, "the acknowledgement of a writer");
+}
+
+static MDBX_txn *hold(void) {
+  MDBX_txn *const txn = write_begin();
+  put_order(txn, "", 0);
+  return txn;
+}
+
+/* Checks the order of writers is the expected one, or the alternative one
+ * if given, i.e. when the order is not defined. */
+static void expect_order(const char *expected, const char *alternative,
+                         const char *what) {
+  MDBX_txn *const txn = txn_begin(env, MDBX_TXN_RDONLY);
+  int err = mdbx_dbi_open(txn, NULL, 0, &dbi);
+  if (err != MDBX_SUCCESS)
+    failure("mdbx_dbi_open", err);
+  char order[64];
+  get_order(txn, order, sizeof(order));
+  mdbx_txn_abort(txn);
+  printf("the order of writers is '%s', expected '%s'\n", order, expected);
+  check(strcmp(order, expected) == 0 ||
+            (alternative && strcmp(order, alternative) == 0),
+        what);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s dbpath mdbx_chk-pathname\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pathname = argv[1];
+  db_remove(pathname);
+
+  for (int n = 0; n < NCHILDREN; ++n) {
+    if (pipe(cmd_pipes[n]) || pipe(ack_pipes[n]))
+      failure("pipe", errno);
+    fflush(NULL);
+    pids[n] = fork();
+    if (pids[n] < 0)
+      failure("fork", errno);
+    if (pids[n] == 0) {
+      for (int i = 0; i < n; ++i)
+        close(cmd_pipes[i][1]), close(ack_pipes[i][0]);
+      close(cmd_pipes[n][1]), close(ack_pipes[n][0]);
+      writer_loop(n);
+    }
+    close(cmd_pipes[n][0]), close(ack_pipes[n][1]);
+  }
+  open_db();
+  MDBX_txn *txn = hold();
+  txn_commit(txn);
+
+  /* the waiting is expired by the deadline while the lock is held */
+  txn = hold();
+  writer_cmd(0, 'T');
+  writer_ack(0, 'T');
+  txn_commit(txn);
+
+  /* the queued writers are served in turn, even if each one requests the
+   * lock again right after the commit */
+  txn = hold();
+  for (int n = 0; n < 3; ++n)
+    writer_cmd(n, 'R');
+  txn_commit(txn);
+  for (int n = 0; n < 3; ++n)
+    writer_ack(n, 'R');
+  expect_order("012012012012", NULL, "the FIFO order of writers");
+
+  /* the ticket of an expired writer is skipped */
+  txn = hold();
+  writer_cmd(0, 'T');
+  writer_cmd(1, 'A');
+  writer_cmd(2, 'A');
+  writer_ack(0, 'T');
+  double start = now();
+  txn_commit(txn);
+  writer_ack(1, 'A');
+  double elapsed = (now() - start) * 1e3;
+  writer_ack(2, 'A');
+  printf("the writer after the expired one is served in %.1f ms\n", elapsed);
+  expect_order("12", NULL, "the order after an expired writer");
+  check(elapsed < STALL_MS, "the turn is passed over an expired writer");
+
+  /* the ticket of a writer killed while waiting doesn't stall the others */
+  txn = hold();
+  writer_cmd(3, 'A');
+  writer_cmd(1, 'A');
+  writer_cmd(2, 'A');
+  if (kill(pids[3], SIGKILL))
+    failure("kill", errno);
+  int status;
+  if (waitpid(pids[3], &status, 0) != pids[3])
+    failure("waitpid", errno);
+  check(WIFSIGNALED(status), "the killed writer");
+  close(cmd_pipes[3][1]), close(ack_pipes[3][0]);
+  start = now();
+  txn_commit(txn);
+  writer_ack(1, 'A');
+  writer_ack(2, 'A');
+  elapsed = (now() - start) * 1e3;
+  printf("the writers after the killed one are served in %.1f ms\n", elapsed);
+  /* both could take the stalled turn, but each one exactly once */
+  expect_order("12", "21", "the order after a killed writer");
+  check(elapsed < 20 * STALL_MS, "the turn after a killed writer");
+
+  /* and the turn goes on as usual */
+  txn = hold();
+  writer_cmd(2, 'A');
+  writer_cmd(0, 'A');
+  writer_cmd(1, 'A');
+  txn_commit(txn);
+  writer_ack(2, 'A');
+  writer_ack(0, 'A');
+  writer_ack(1, 'A');
+  expect_order("201", NULL, "the order after the recovery of the turn");
+
+  for (int n = 0; n < NCHILDREN - 1; ++n) {
+    close(cmd_pipes[n][1]), close(ack_pipes[n][0]);
+    if (waitpid(pids[n], &status, 0) != pids[n])
+      failure("waitpid", errno);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS,
+          "the child writer");
+  }
+  mdbx_env_close(env);
+  db_check(argv[2], pathname);
+  return EXIT_SUCCESS;
+}